@@ -12,10 +12,53 @@
 #include "ai.h"
 #include "debug.h"
 #include "field.h"
+#include "mask.h"
+#include "stats.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AI_AVX2
+#include <immintrin.h>
+#endif
+
+/**************************************************************/
+/// The implementation of the scoring in use.
+static KERNEL Kernel = KERNEL_SCALAR;
 
 /**********************************************************//**
- * @brief Get the length of the longest ship remaining.
- * @param field: The field to check.
+ * @brief Pick the implementation of the heuristic's scoring.
+ * This must be done before any games start.
+ * @param kernel: The implementation; KERNEL_AUTO picks AVX2 if
+ * the processor has it.
+ * @return False if AVX2 was asked for but isn't available.
+ **************************************************************/
+bool ai_Configure(KERNEL kernel) {
+    bool avx2 = false;
+#ifdef AI_AVX2
+    __builtin_cpu_init();
+    avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (kernel == KERNEL_AUTO) {
+        kernel = avx2? KERNEL_AVX2: KERNEL_SCALAR;
+    } else if (kernel == KERNEL_AVX2 && !avx2) {
+        eprintf("This processor doesn't have AVX2.\n");
+        return false;
+    }
+    Kernel = kernel;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Get the implementation of the scoring in use.
+ * @return KERNEL_SCALAR or KERNEL_AVX2.
+ **************************************************************/
+KERNEL ai_GetKernel(void) {
+    return Kernel;
+}
+
+/**********************************************************//**
+ * @brief Get the length of the longest ship remaining, from
+ * the health of each ship.
+ * @param health: The health of each ship.
  * @param full: Output parameter for the minimum length
  * that is not next to any hits.
  * @param partial: Output parameter for the minimum length
@@ -23,19 +66,18 @@
  * @return The length of the longest ship that could be left
  * on the field.
  **************************************************************/
-static inline void ai_GetMinimumLength(const FIELD *field, int *full, int *partial) {
+void ai_GetMinimumLengths(const int health[N_SHIPS_MAX], int *full, int *partial) {
     // Get the minimum length remaining
     int lengthMin = INT_MAX;
     int partialMin = INT_MAX;
-    for (SHIP ship=0; ship<N_SHIPS; ship++) {
+    for (SHIP ship=0; ship<field_GetShipCount(); ship++) {
         // Check if the ship is actually afloat.
-        int health = field_GetShipHealth(field, ship);
-        if (health > 0) {
+        if (health[ship] > 0) {
             // Get the minimum fragment size if the ship is hit.
             // A "fragment" is the continuous piece of a ship that
             // we HAVE NOT found out information for yet.
             int length = field_GetShipLength(ship);
-            if (health < length) {
+            if (health[ship] < length) {
                 // Longest fragment is when everything is in
                 // the middle of the ship.
                 // I.E. if we have a ship of length 5, that was hit
@@ -51,7 +93,7 @@ static inline void ai_GetMinimumLength(const FIELD *field, int *full, int *parti
                 // OOXOO (fragment length 2)
                 // Minimum fragment length is 2 == (int)log2(5-1). It is
                 // NOT 1 because that also exists alongside a fragment of 3.
-                int fragmentMin = (int)log2(length-health);
+                int fragmentMin = (int)log2(length-health[ship]);
                 if (fragmentMin == 0) {
                     fragmentMin = 1;
                 }
@@ -81,11 +123,28 @@ static inline void ai_GetMinimumLength(const FIELD *field, int *full, int *parti
 }
 
 /**********************************************************//**
- * @brief Play one turn of a game.
+ * @brief Get the length of the longest ship remaining on a
+ * field; see ai_GetMinimumLengths.
+ * @param field: The field to check.
+ * @param full: Output parameter for the minimum length
+ * that is not next to any hits.
+ * @param partial: Output parameter for the minimum length
+ * that is next to some hits.
+ **************************************************************/
+static inline void ai_GetMinimumLength(const FIELD *field, int *full, int *partial) {
+    ai_GetMinimumLengths(field->health, full, partial);
+}
+
+/**********************************************************//**
+ * @brief Choose the tile to attack next.
  * @param field: The field to take a turn on.
- * @return Whether the gameplay succeeded.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @param size: The size of the field.
+ * @return Whether there was any tile left to attack.
  **************************************************************/
-bool ai_PlayTurn(FIELD *field) {
+static inline __attribute__((always_inline))
+bool ai_ChooseTileSized(const FIELD *field, int *x, int *y, int size) {
     int fullMin;
     int partialMin;
     ai_GetMinimumLength(field, &fullMin, &partialMin);
@@ -95,114 +154,258 @@ bool ai_PlayTurn(FIELD *field) {
     int probabilityMax = -1;
     int tileX = -1;
     int tileY = -1;
-    for (int x=0; x<FIELD_SIZE; x++) {
-        for (int y=0; y<FIELD_SIZE; y++) {
-            // Skip tiles we already tried (essentially assigns probability
-            // of -1 to that tile, which skips it).
-            if (field_GetStatus(field, x, y) != UNTRIED) {
-                continue;
-            }
+    // Skip tiles we already tried (essentially assigns probability
+    // of -1 to that tile, which skips it) by only visiting the bits
+    // of the UNTRIED mask. They come in the same x-major order.
+    MASK untried = field_GetMask(field, UNTRIED);
+    for (int index = mask_Pop(&untried); index >= 0; index = mask_Pop(&untried)) {
+        int x = index / size;
+        int y = index % size;
 
-            // Calculate view extents from the current tile
-            // These are all guaranteed >= 1 if the tile is UNTRIED.
-            // We are looking for the number of untried tiles that grow
-            // left, right, up, and down from our current tile.
-            int viewLeft  = field_GetExtent(field, LEFT,  x, y, UNTRIED);
-            int viewRight = field_GetExtent(field, RIGHT, x, y, UNTRIED);
-            int viewUp    = field_GetExtent(field, UP,    x, y, UNTRIED);
-            int viewDown  = field_GetExtent(field, DOWN,  x, y, UNTRIED);
-            assert(viewLeft >= 1);
-            assert(viewRight >= 1);
-            assert(viewUp >= 1);
-            assert(viewDown >= 1);
-
-            // Find any nearby hits, beginning at our neighbors
-            // and extending outwards.
-            int nearLeft  = field_GetExtent(field, LEFT,  x-1, y,   HIT);
-            int nearRight = field_GetExtent(field, RIGHT, x+1, y,   HIT);
-            int nearUp    = field_GetExtent(field, UP,    x,   y-1, HIT);
-            int nearDown  = field_GetExtent(field, DOWN,  x,   y+1, HIT);
-            assert(nearLeft >= 0);
-            assert(nearRight >= 0);
-            assert(nearUp >= 0);
-            assert(nearDown >= 0);
-
-            // If we are actually next to a hit, we need to use the partialMin, which
-            // is always less than or equal to the fullMin. partialMin means "the minimum
-            // number of continuous unhit tiles on a ship we have already hit". fullMin
-            // means "the the minimum size of an unhit ship".
-            //
-            // Example: if we have sunk 4 ships and all that's left is the submarine (of
-            // length 3, partialMin==fullMin==3). That means in the situation below:
-            // XXXX
-            // X??X
-            // XXXX
-            // It's meaningless to pick the ? tiles because the submarine couldn't
-            // possibly fit.
-            //
-            // However, if it's the same situation but we hit some of the submarine...
-            // XXXX
-            // X??O
-            // XXXX
-            // We could find the submarine at ?. This is because partialMin is now 1.
-            int nearHorizontal = nearLeft + nearRight;
-            int nearVertical = nearUp + nearDown;
-            bool blockedHorizontal;
-            if (nearLeft > 0 || nearRight > 0) {
-                blockedHorizontal = (viewRight+viewLeft) <= (partialMin-nearHorizontal);
-            } else {
-                blockedHorizontal = (viewRight+viewLeft) <= (fullMin-nearHorizontal);
-            }
-            bool blockedVertical;
-            if (nearUp > 0 || nearDown > 0) {
-                blockedVertical = (viewUp+viewDown) <= (partialMin-nearVertical);
-            } else {
-                blockedVertical = (viewUp+viewDown) <= (fullMin-nearVertical);
-            }
+        // Calculate view extents from the current tile
+        // These are all guaranteed >= 1 if the tile is UNTRIED.
+        // We are looking for the number of untried tiles that grow
+        // left, right, up, and down from our current tile.
+        int viewLeft  = field_GetExtentSized(field, LEFT,  x, y, UNTRIED, size);
+        int viewRight = field_GetExtentSized(field, RIGHT, x, y, UNTRIED, size);
+        int viewUp    = field_GetExtentSized(field, UP,    x, y, UNTRIED, size);
+        int viewDown  = field_GetExtentSized(field, DOWN,  x, y, UNTRIED, size);
+        assert(viewLeft >= 1);
+        assert(viewRight >= 1);
+        assert(viewUp >= 1);
+        assert(viewDown >= 1);
 
-            // Determine the probability at the tile. If the ship couldn't possibly fit
-            // at the tile, probability is zero.
-            int probability = 0;
-            if (!blockedHorizontal || !blockedVertical) {
-                // Weight probability towards the center. I.e. in the following situation:
-                // X???X
-                // We want to pick the middle ? above the left or right ? because picking
-                // the middle completely rules out if a ship of length 2 exists there.
-                // Ex: it could be XO[O]XX or XX[O]OX. Picking the middle would always be
-                // [O] but picking the left or right could be X.
-                probability = viewLeft*viewRight + viewUp*viewDown;
-                // Weight a lot if near to other hits. FIELD_SIZE*FIELD_SIZE is the max
-                // probability, which weights tiles next to hits significantly higher.
-                // This means if we get a hit, we pursue that ship until it sinks.
-                probability += (nearHorizontal+nearVertical)*(FIELD_SIZE*FIELD_SIZE);
-            }
-            assert(probability >= 0);
+        // Find any nearby hits, beginning at our neighbors
+        // and extending outwards.
+        int nearLeft  = field_GetExtentSized(field, LEFT,  x-1, y,   HIT, size);
+        int nearRight = field_GetExtentSized(field, RIGHT, x+1, y,   HIT, size);
+        int nearUp    = field_GetExtentSized(field, UP,    x,   y-1, HIT, size);
+        int nearDown  = field_GetExtentSized(field, DOWN,  x,   y+1, HIT, size);
+        assert(nearLeft >= 0);
+        assert(nearRight >= 0);
+        assert(nearUp >= 0);
+        assert(nearDown >= 0);
 
-            // Check probability maximum, and pick the best one.
-            if (probability > probabilityMax) {
-                probabilityMax = probability;
-                tileX = x;
-                tileY = y;
-            }
+        // If we are actually next to a hit, we need to use the partialMin, which
+        // is always less than or equal to the fullMin. partialMin means "the minimum
+        // number of continuous unhit tiles on a ship we have already hit". fullMin
+        // means "the the minimum size of an unhit ship".
+        //
+        // Example: if we have sunk 4 ships and all that's left is the submarine (of
+        // length 3, partialMin==fullMin==3). That means in the situation below:
+        // XXXX
+        // X??X
+        // XXXX
+        // It's meaningless to pick the ? tiles because the submarine couldn't
+        // possibly fit.
+        //
+        // However, if it's the same situation but we hit some of the submarine...
+        // XXXX
+        // X??O
+        // XXXX
+        // We could find the submarine at ?. This is because partialMin is now 1.
+        int nearHorizontal = nearLeft + nearRight;
+        int nearVertical = nearUp + nearDown;
+        bool blockedHorizontal;
+        if (nearLeft > 0 || nearRight > 0) {
+            blockedHorizontal = (viewRight+viewLeft) <= (partialMin-nearHorizontal);
+        } else {
+            blockedHorizontal = (viewRight+viewLeft) <= (fullMin-nearHorizontal);
+        }
+        bool blockedVertical;
+        if (nearUp > 0 || nearDown > 0) {
+            blockedVertical = (viewUp+viewDown) <= (partialMin-nearVertical);
+        } else {
+            blockedVertical = (viewUp+viewDown) <= (fullMin-nearVertical);
+        }
+
+        // Determine the probability at the tile. If the ship couldn't possibly fit
+        // at the tile, probability is zero.
+        int probability = 0;
+        if (!blockedHorizontal || !blockedVertical) {
+            // Weight probability towards the center. I.e. in the following situation:
+            // X???X
+            // We want to pick the middle ? above the left or right ? because picking
+            // the middle completely rules out if a ship of length 2 exists there.
+            // Ex: it could be XO[O]XX or XX[O]OX. Picking the middle would always be
+            // [O] but picking the left or right could be X.
+            probability = viewLeft*viewRight + viewUp*viewDown;
+            // Weight a lot if near to other hits. size*size is the max
+            // probability, which weights tiles next to hits significantly higher.
+            // This means if we get a hit, we pursue that ship until it sinks.
+            probability += (nearHorizontal+nearVertical)*(size*size);
+        }
+        assert(probability >= 0);
+
+        // Check probability maximum, and pick the best one.
+        if (probability > probabilityMax) {
+            probabilityMax = probability;
+            tileX = x;
+            tileY = y;
         }
     }
 
-    // Sanity check before making the attack
-    assert(tileX != -1);
-    assert(tileY != -1);
+    // Sanity check before choosing the tile
+    if (tileX == -1 || tileY == -1) {
+        eprintf("No tile left to attack.\n");
+        return false;
+    }
     assert(field_GetStatus(field, tileX, tileY) == UNTRIED);
+    *x = tileX;
+    *y = tileY;
+    return true;
+}
 
-    // Make attack
-    STATUS result = field_Attack(field, tileX, tileY);
-    if (result == ERROR) {
-        eprintf("Attack at (%d, %d) failed.\n", tileX, tileY);
-        return false;
+#ifdef AI_AVX2
+/**********************************************************//**
+ * @brief Choose the tile to attack next, scoring a whole
+ * column of the field at once: each of the 16 lanes is the
+ * tile at one y. The run tables already hold the view and hit
+ * extents of every tile, so a column's extents are single
+ * loads, and the neighbours' hit runs above and below are the
+ * same loads shifted by one lane. The scores are the same as
+ * ai_ChooseTileSized's, and so is the tile chosen: each lane
+ * keeps the first column it saw its best score in, and of the
+ * lanes with the best score, the one first in x-major order
+ * wins.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+__attribute__((target("avx2")))
+static bool ai_ChooseTileAvx2(const FIELD *field, int *x, int *y) {
+#if FIELD_SIZE_MAX != 16
+#error "The AVX2 kernel needs a column to be 16 tiles."
+#endif
+    int size = field_GetSize();
+    int fullMin;
+    int partialMin;
+    ai_GetMinimumLength(field, &fullMin, &partialMin);
+
+    // No run is longer than the field, so the minimums only
+    // matter up to twice its size; keep them in 16 bits.
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i full = _mm256_set1_epi16((short)((fullMin < 2*size)? fullMin: 2*size));
+    const __m256i partial = _mm256_set1_epi16((short)((partialMin < 2*size)? partialMin: 2*size));
+    const __m256i weight = _mm256_set1_epi16((short)(size*size));
+    const __m256i bit = _mm256_setr_epi16(1<<0, 1<<1, 1<<2, 1<<3, 1<<4, 1<<5, 1<<6, 1<<7,
+        1<<8, 1<<9, 1<<10, 1<<11, 1<<12, 1<<13, 1<<14, (short)(1<<15));
+    __m256i best = _mm256_set1_epi16(-1);
+    __m256i bestX = zero;
+
+    MASK untried = field_GetMask(field, UNTRIED);
+    for (int column = 0; column < size; column++) {
+        uint32_t line = mask_GetBits(&untried, column*size, size);
+        if (!line) {
+            continue;
+        }
+        // Eight extents for every lane of the column
+        STATS_ADD(extents, 8*size);
+        #define AI_LOAD(table, dir, x) _mm_loadu_si128((const __m128i *)field->run[table][dir][x])
+        __m256i viewLeft  = _mm256_cvtepu8_epi16(AI_LOAD(0, LEFT,  column));
+        __m256i viewRight = _mm256_cvtepu8_epi16(AI_LOAD(0, RIGHT, column));
+        __m256i viewUp    = _mm256_cvtepu8_epi16(AI_LOAD(0, UP,    column));
+        __m256i viewDown  = _mm256_cvtepu8_epi16(AI_LOAD(0, DOWN,  column));
+        __m256i nearLeft  = (column > 0)? _mm256_cvtepu8_epi16(AI_LOAD(1, LEFT, column-1)): zero;
+        __m256i nearRight = (column < size-1)? _mm256_cvtepu8_epi16(AI_LOAD(1, RIGHT, column+1)): zero;
+        __m256i nearUp    = _mm256_cvtepu8_epi16(_mm_slli_si128(AI_LOAD(1, UP, column), 1));
+        __m256i nearDown  = _mm256_cvtepu8_epi16(_mm_srli_si128(AI_LOAD(1, DOWN, column), 1));
+        #undef AI_LOAD
+
+        // A line is open if the shortest ship that could be
+        // there fits in it.
+        __m256i nearHorizontal = _mm256_add_epi16(nearLeft, nearRight);
+        __m256i nearVertical = _mm256_add_epi16(nearUp, nearDown);
+        __m256i needHorizontal = _mm256_sub_epi16(_mm256_blendv_epi8(full, partial,
+            _mm256_cmpgt_epi16(nearHorizontal, zero)), nearHorizontal);
+        __m256i needVertical = _mm256_sub_epi16(_mm256_blendv_epi8(full, partial,
+            _mm256_cmpgt_epi16(nearVertical, zero)), nearVertical);
+        __m256i open = _mm256_or_si256(
+            _mm256_cmpgt_epi16(_mm256_add_epi16(viewLeft, viewRight), needHorizontal),
+            _mm256_cmpgt_epi16(_mm256_add_epi16(viewUp, viewDown), needVertical));
+
+        // Score the open untried tiles; blocked ones score 0
+        // and tried ones -1.
+        __m256i probability = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(viewLeft, viewRight), _mm256_mullo_epi16(viewUp, viewDown)),
+            _mm256_mullo_epi16(_mm256_add_epi16(nearHorizontal, nearVertical), weight));
+        probability = _mm256_and_si256(probability, open);
+        __m256i isUntried = _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_set1_epi16((short)line), bit), bit);
+        probability = _mm256_blendv_epi8(_mm256_set1_epi16(-1), probability, isUntried);
+
+        // Keep each lane's first best column
+        __m256i better = _mm256_cmpgt_epi16(probability, best);
+        best = _mm256_max_epi16(best, probability);
+        bestX = _mm256_blendv_epi8(bestX, _mm256_set1_epi16((short)column), better);
     }
 
-    // Sanity check after attacking
-    assert(field_GetStatus(field, tileX, tileY) != UNTRIED);
-    assert(field_GetStatus(field, tileX, tileY) == result);
+    // The best tile first in x-major order
+    int16_t score[16];
+    int16_t scoreX[16];
+    _mm256_storeu_si256((__m256i *)score, best);
+    _mm256_storeu_si256((__m256i *)scoreX, bestX);
+    int probabilityMax = -1;
+    int tile = -1;
+    for (int lane = 0; lane < size; lane++) {
+        int index = scoreX[lane]*size + lane;
+        if (score[lane] > probabilityMax || (score[lane] == probabilityMax && index < tile)) {
+            probabilityMax = score[lane];
+            tile = index;
+        }
+    }
+    if (probabilityMax < 0) {
+        eprintf("No tile left to attack.\n");
+        return false;
+    }
+    assert(field_GetStatus(field, tile/size, tile%size) == UNTRIED);
+    *x = tile / size;
+    *y = tile % size;
     return true;
 }
+#endif
+
+/**********************************************************//**
+ * @brief Choose the tile to attack next with the scalar code.
+ * The common field sizes have their own copies of the
+ * heuristic, with the size known at compile time; other sizes
+ * share a generic one.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+static bool ai_ChooseTileScalar(const FIELD *field, int *x, int *y) {
+    switch (field_GetSize()) {
+    case 8:
+        return ai_ChooseTileSized(field, x, y, 8);
+    case 10:
+        return ai_ChooseTileSized(field, x, y, 10);
+    case 12:
+        return ai_ChooseTileSized(field, x, y, 12);
+    case 16:
+        return ai_ChooseTileSized(field, x, y, 16);
+    default:
+        return ai_ChooseTileSized(field, x, y, field_GetSize());
+    }
+}
+
+/**********************************************************//**
+ * @brief Choose the tile to attack next, with the configured
+ * kernel. crosscheck.exe tests that both kernels pick the same
+ * tile.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+bool ai_ChooseTile(const FIELD *field, int *x, int *y) {
+#ifdef AI_AVX2
+    if (Kernel == KERNEL_AVX2) {
+        return ai_ChooseTileAvx2(field, x, y);
+    }
+#endif
+    return ai_ChooseTileScalar(field, x, y);
+}
 
 /**************************************************************/
@@ -14,11 +14,24 @@
 #include "field.h"
 
 /**********************************************************//**
- * @brief Play one turn of a game.
- * @param field: The field to take a turn on.
- * @return Whether the gameplay succeeded.
+ * @enum KERNEL
+ * @brief The implementations of the heuristic's scoring. They
+ * always choose the same tile.
  **************************************************************/
-extern bool ai_PlayTurn(FIELD *field);
+typedef enum {
+    /// AVX2 if the processor has it, else scalar.
+    KERNEL_AUTO,
+    /// One tile at a time.
+    KERNEL_SCALAR,
+    /// A column of 16 tiles at a time, with AVX2.
+    KERNEL_AVX2,
+} KERNEL;
+
+/**************************************************************/
+extern bool ai_Configure(KERNEL kernel);
+extern KERNEL ai_GetKernel(void);
+extern void ai_GetMinimumLengths(const int health[N_SHIPS_MAX], int *full, int *partial);
+extern bool ai_ChooseTile(const FIELD *field, int *x, int *y);
 
 /**************************************************************/
 #endif // _AI_H_
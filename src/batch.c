@@ -0,0 +1,554 @@
+/**********************************************************//**
+ * @file batch.c
+ * @brief Implementation of the batch engine.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail Each step scores every tile for all the lanes, in
+ * x-major order: a lane's score at a tile comes from the same
+ * runs as the heuristic's, and a lane only takes a tile that
+ * beats its best so far, so it chooses the tile ai_ChooseTile
+ * would. With AVX2, BATCH_WIDTH lanes are scored per vector,
+ * and their attacks are resolved per vector too: the status
+ * and ship under each lane's move are gathered, and the hits
+ * decrement the gathered health without a branch per lane.
+ * Only then are the runs of the lines through the tiles that
+ * changed updated, walking the lanes of each kind of result.
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ai.h"
+#include "batch.h"
+#include "debug.h"
+#include "field.h"
+#include "mask.h"
+#include "stats.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BATCH_AVX2
+#include <immintrin.h>
+#endif
+
+/**********************************************************//**
+ * @brief Get where a tile of a lane is in the per-tile arrays.
+ * @param batch: The batch in question.
+ * @param tile: The tile, as field_GetIndex(x, y).
+ * @param lane: The lane.
+ * @return The index.
+ **************************************************************/
+static inline int batch_GetIndex(const BATCH *batch, int tile, int lane) {
+    return tile*batch->lanes + lane;
+}
+
+/**********************************************************//**
+ * @brief Get the run table of one status and direction.
+ * @param batch: The batch in question.
+ * @param run: 0 for UNTRIED runs, 1 for HIT runs.
+ * @param dir: The direction.
+ * @return The table, indexed like the per-tile arrays.
+ **************************************************************/
+static inline uint8_t *batch_GetRun(const BATCH *batch, int run, VIEW dir) {
+    return &batch->run[(run*N_VIEWS + dir)*TURN_MAX*batch->lanes];
+}
+
+/**********************************************************//**
+ * @brief Set up a batch with no games in it.
+ * @param batch: The batch to set up.
+ * @param lanes: The number of games to play at once. It is
+ * rounded up to a multiple of BATCH_WIDTH.
+ * @return Whether the batch could be allocated.
+ **************************************************************/
+bool batch_Create(BATCH *batch, int lanes) {
+    memset(batch, 0, sizeof(BATCH));
+    if (lanes < 1 || lanes > BATCH_LANES_MAX) {
+        eprintf("A batch has 1 to %d lanes.\n", BATCH_LANES_MAX);
+        return false;
+    }
+    batch->lanes = (lanes + BATCH_WIDTH - 1) / BATCH_WIDTH * BATCH_WIDTH;
+    // The attacks gather 4 bytes at a time from the byte arrays
+    size_t cells = (size_t)TURN_MAX*batch->lanes;
+    batch->status = calloc(cells + sizeof(int), 1);
+    batch->untried = calloc(cells, 1);
+    batch->ship = calloc(cells + sizeof(int), 1);
+    batch->run = calloc(N_RUNS*N_VIEWS*cells, 1);
+    if (!batch->status || !batch->untried || !batch->ship || !batch->run) {
+        eprintf("Failed to allocate the batch.\n");
+        batch_Free(batch);
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Free the boards of a batch.
+ * @param batch: The batch.
+ **************************************************************/
+void batch_Free(BATCH *batch) {
+    free(batch->status);
+    free(batch->untried);
+    free(batch->ship);
+    free(batch->run);
+    batch->status = NULL;
+    batch->untried = NULL;
+    batch->ship = NULL;
+    batch->run = NULL;
+}
+
+/**********************************************************//**
+ * @brief Recompute the runs of one status along one line of
+ * tiles of a lane, like field_UpdateLine.
+ * @param batch: The batch to update.
+ * @param lane: The lane.
+ * @param status: The status of the runs (UNTRIED or HIT).
+ * @param x: The x-coordinate of a tile on the line.
+ * @param y: The y-coordinate of a tile on the line.
+ * @param vertical: Whether the line is the column through the
+ * tile (true) or the row through the tile (false).
+ **************************************************************/
+static void batch_UpdateLine(BATCH *batch, int lane, STATUS status, int x, int y, bool vertical) {
+    int size = field_GetSize();
+    int run = (status == HIT);
+    uint8_t *back = batch_GetRun(batch, run, vertical? UP: LEFT);
+    uint8_t *ahead = batch_GetRun(batch, run, vertical? DOWN: RIGHT);
+    int first = vertical? x*size: y;
+    int stride = (vertical? 1: size)*batch->lanes;
+    int start = first*batch->lanes + lane;
+
+    // Runs looking back grow forwards along the line, and
+    // runs looking ahead grow backwards along the line.
+    int length = 0;
+    for (int i = 0, index = start; i < size; i++, index += stride) {
+        length = (batch->status[index] == status)? length+1: 0;
+        back[index] = (uint8_t)length;
+    }
+    length = 0;
+    for (int i = size-1, index = start + (size-1)*stride; i >= 0; i--, index -= stride) {
+        length = (batch->status[index] == status)? length+1: 0;
+        ahead[index] = (uint8_t)length;
+    }
+}
+
+/**********************************************************//**
+ * @brief Put a new game in a lane. The field must be freshly
+ * set up, with no attacks made yet.
+ * @param batch: The batch.
+ * @param lane: The lane, which must not have a game in play.
+ * @param field: The board of the game.
+ **************************************************************/
+void batch_Load(BATCH *batch, int lane, const FIELD *field) {
+    assert(!batch->active[lane]);
+    int size = field_GetSize();
+    for (int tile = 0; tile < field_GetTileCount(); tile++) {
+        int index = batch_GetIndex(batch, tile, lane);
+        batch->status[index] = UNTRIED;
+        batch->untried[index] = 0xFF;
+        batch->ship[index] = EMPTY;
+    }
+    batch->remaining[lane] = 0;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        batch->health[lane][ship] = field_GetShipHealth(field, ship);
+        batch->sinkTurn[lane][ship] = TURN_INVALID;
+        batch->placement[lane][ship] = *field_GetPlacement(field, ship);
+        batch->remaining[lane] += field_GetShipHealth(field, ship);
+        MASK mask = field->ship[ship];
+        for (int tile = mask_Pop(&mask); tile >= 0; tile = mask_Pop(&mask)) {
+            batch->ship[batch_GetIndex(batch, tile, lane)] = (int8_t)ship;
+        }
+    }
+    for (int i = 0; i < size; i++) {
+        batch_UpdateLine(batch, lane, UNTRIED, i, i, true);
+        batch_UpdateLine(batch, lane, UNTRIED, i, i, false);
+        batch_UpdateLine(batch, lane, HIT, i, i, true);
+        batch_UpdateLine(batch, lane, HIT, i, i, false);
+    }
+    batch->turns[lane] = 0;
+    batch->active[lane] = true;
+}
+
+/**********************************************************//**
+ * @brief Score every tile for a group of lanes and keep each
+ * lane's best, one lane at a time.
+ * @param batch: The batch.
+ * @param group: The first lane of the group.
+ * @param full: The shortest unhit ship of each lane.
+ * @param partial: The shortest fragment of a hit ship of each
+ * lane.
+ * @param move: Output parameter for each lane's tile, or -1.
+ **************************************************************/
+static void batch_ScoreScalar(const BATCH *batch, int group, const int16_t full[BATCH_WIDTH],
+const int16_t partial[BATCH_WIDTH], int move[BATCH_LANES_MAX]) {
+    int size = field_GetSize();
+    const uint8_t *view[N_VIEWS];
+    const uint8_t *near[N_VIEWS];
+    for (VIEW dir = 0; dir < N_VIEWS; dir++) {
+        view[dir] = batch_GetRun(batch, 0, dir);
+        near[dir] = batch_GetRun(batch, 1, dir);
+    }
+    int lanes = batch->lanes;
+    for (int lane = group; lane < group + BATCH_WIDTH; lane++) {
+        int probabilityMax = -1;
+        move[lane] = -1;
+        for (int tile = 0; tile < field_GetTileCount(); tile++) {
+            int index = tile*lanes + lane;
+            if (!batch->untried[index]) {
+                continue;
+            }
+            STATS_ADD(extents, 8);
+            int x = tile / size;
+            int y = tile % size;
+            int viewLeft  = view[LEFT][index];
+            int viewRight = view[RIGHT][index];
+            int viewUp    = view[UP][index];
+            int viewDown  = view[DOWN][index];
+            int nearLeft  = (x > 0)?      near[LEFT][index - size*lanes]: 0;
+            int nearRight = (x < size-1)? near[RIGHT][index + size*lanes]: 0;
+            int nearUp    = (y > 0)?      near[UP][index - lanes]: 0;
+            int nearDown  = (y < size-1)? near[DOWN][index + lanes]: 0;
+            int nearHorizontal = nearLeft + nearRight;
+            int nearVertical = nearUp + nearDown;
+            int needHorizontal = ((nearHorizontal > 0)? partial[lane-group]: full[lane-group]) - nearHorizontal;
+            int needVertical = ((nearVertical > 0)? partial[lane-group]: full[lane-group]) - nearVertical;
+            int probability = 0;
+            if (viewLeft+viewRight > needHorizontal || viewUp+viewDown > needVertical) {
+                probability = viewLeft*viewRight + viewUp*viewDown + (nearHorizontal+nearVertical)*(size*size);
+            }
+            if (probability > probabilityMax) {
+                probabilityMax = probability;
+                move[lane] = tile;
+            }
+        }
+    }
+}
+
+#ifdef BATCH_AVX2
+/**********************************************************//**
+ * @brief Score every tile for a group of lanes and keep each
+ * lane's best, BATCH_WIDTH lanes per vector.
+ * @param batch: The batch.
+ * @param group: The first lane of the group.
+ * @param full: The shortest unhit ship of each lane.
+ * @param partial: The shortest fragment of a hit ship of each
+ * lane.
+ * @param move: Output parameter for each lane's tile, or -1.
+ **************************************************************/
+__attribute__((target("avx2")))
+static void batch_ScoreAvx2(const BATCH *batch, int group, const int16_t full[BATCH_WIDTH],
+const int16_t partial[BATCH_WIDTH], int move[BATCH_LANES_MAX]) {
+#if BATCH_WIDTH != 16
+#error "The AVX2 kernel scores 16 lanes at once."
+#endif
+    int size = field_GetSize();
+    const uint8_t *view[N_VIEWS];
+    const uint8_t *near[N_VIEWS];
+    for (VIEW dir = 0; dir < N_VIEWS; dir++) {
+        view[dir] = batch_GetRun(batch, 0, dir) + group;
+        near[dir] = batch_GetRun(batch, 1, dir) + group;
+    }
+    const uint8_t *untried = batch->untried + group;
+    int lanes = batch->lanes;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i fullMin = _mm256_loadu_si256((const __m256i *)full);
+    const __m256i partialMin = _mm256_loadu_si256((const __m256i *)partial);
+    const __m256i weight = _mm256_set1_epi16((short)(size*size));
+    __m256i best = _mm256_set1_epi16(-1);
+    __m256i bestTile = _mm256_set1_epi16(-1);
+
+    #define BATCH_LOAD(table, offset) _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)&(table)[offset]))
+    for (int tile = 0; tile < field_GetTileCount(); tile++) {
+        int index = tile*lanes;
+        __m128i isUntried = _mm_loadu_si128((const __m128i *)&untried[index]);
+        if (_mm_testz_si128(isUntried, isUntried)) {
+            continue;
+        }
+        STATS_ADD(extents, 8*BATCH_WIDTH);
+        int x = tile / size;
+        int y = tile % size;
+        __m256i viewLeft  = BATCH_LOAD(view[LEFT],  index);
+        __m256i viewRight = BATCH_LOAD(view[RIGHT], index);
+        __m256i viewUp    = BATCH_LOAD(view[UP],    index);
+        __m256i viewDown  = BATCH_LOAD(view[DOWN],  index);
+        __m256i nearLeft  = (x > 0)?      BATCH_LOAD(near[LEFT],  index - size*lanes): zero;
+        __m256i nearRight = (x < size-1)? BATCH_LOAD(near[RIGHT], index + size*lanes): zero;
+        __m256i nearUp    = (y > 0)?      BATCH_LOAD(near[UP],    index - lanes): zero;
+        __m256i nearDown  = (y < size-1)? BATCH_LOAD(near[DOWN],  index + lanes): zero;
+
+        // The same blocked checks and score as the heuristic
+        __m256i nearHorizontal = _mm256_add_epi16(nearLeft, nearRight);
+        __m256i nearVertical = _mm256_add_epi16(nearUp, nearDown);
+        __m256i needHorizontal = _mm256_sub_epi16(_mm256_blendv_epi8(fullMin, partialMin,
+            _mm256_cmpgt_epi16(nearHorizontal, zero)), nearHorizontal);
+        __m256i needVertical = _mm256_sub_epi16(_mm256_blendv_epi8(fullMin, partialMin,
+            _mm256_cmpgt_epi16(nearVertical, zero)), nearVertical);
+        __m256i open = _mm256_or_si256(
+            _mm256_cmpgt_epi16(_mm256_add_epi16(viewLeft, viewRight), needHorizontal),
+            _mm256_cmpgt_epi16(_mm256_add_epi16(viewUp, viewDown), needVertical));
+        __m256i probability = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(viewLeft, viewRight), _mm256_mullo_epi16(viewUp, viewDown)),
+            _mm256_mullo_epi16(_mm256_add_epi16(nearHorizontal, nearVertical), weight));
+        probability = _mm256_and_si256(probability, open);
+        probability = _mm256_blendv_epi8(_mm256_set1_epi16(-1), probability,
+            _mm256_cvtepi8_epi16(isUntried));
+
+        // Keep each lane's first best tile
+        __m256i better = _mm256_cmpgt_epi16(probability, best);
+        best = _mm256_max_epi16(best, probability);
+        bestTile = _mm256_blendv_epi8(bestTile, _mm256_set1_epi16((short)tile), better);
+    }
+    #undef BATCH_LOAD
+
+    int16_t tile[BATCH_WIDTH];
+    _mm256_storeu_si256((__m256i *)tile, bestTile);
+    for (int lane = 0; lane < BATCH_WIDTH; lane++) {
+        move[group+lane] = tile[lane];
+    }
+}
+#endif
+
+/**********************************************************//**
+ * @brief Sink a ship of one lane whose last tile was just hit:
+ * only the HIT runs along it and across each of its tiles
+ * change.
+ * @param batch: The batch.
+ * @param lane: The lane.
+ * @param ship: The ship.
+ **************************************************************/
+static void batch_Sink(BATCH *batch, int lane, SHIP ship) {
+    int size = field_GetSize();
+    const PLACEMENT *placement = &batch->placement[lane][ship];
+    bool vertical = (placement->view == DOWN);
+    for (int i = 0; i < placement->length; i++) {
+        int shipX = placement->x + (vertical? 0: i);
+        int shipY = placement->y + (vertical? i: 0);
+        batch->status[batch_GetIndex(batch, shipX*size + shipY, lane)] = SUNK;
+    }
+    batch_UpdateLine(batch, lane, HIT, placement->x, placement->y, vertical);
+    for (int i = 0; i < placement->length; i++) {
+        int shipX = placement->x + (vertical? 0: i);
+        int shipY = placement->y + (vertical? i: 0);
+        batch_UpdateLine(batch, lane, HIT, shipX, shipY, !vertical);
+    }
+    batch->sinkTurn[lane][ship] = batch->turns[lane];
+}
+
+/**********************************************************//**
+ * @brief Attack a tile in one lane, like field_Attack.
+ * @param batch: The batch.
+ * @param lane: The lane.
+ * @param tile: The untried tile to attack.
+ **************************************************************/
+static void batch_Attack(BATCH *batch, int lane, int tile) {
+    int size = field_GetSize();
+    int x = tile / size;
+    int y = tile % size;
+    int index = batch_GetIndex(batch, tile, lane);
+    assert(batch->untried[index]);
+    batch->turns[lane]++;
+    batch->untried[index] = 0;
+    SHIP ship = batch->ship[index];
+    if (ship == EMPTY) {
+        batch->status[index] = MISS;
+        batch_UpdateLine(batch, lane, UNTRIED, x, y, true);
+        batch_UpdateLine(batch, lane, UNTRIED, x, y, false);
+        STATS_ADD(attacks[MISS], 1);
+        return;
+    }
+    batch->status[index] = HIT;
+    batch_UpdateLine(batch, lane, UNTRIED, x, y, true);
+    batch_UpdateLine(batch, lane, UNTRIED, x, y, false);
+    batch->remaining[lane]--;
+    if (--batch->health[lane][ship] > 0) {
+        batch_UpdateLine(batch, lane, HIT, x, y, true);
+        batch_UpdateLine(batch, lane, HIT, x, y, false);
+        STATS_ADD(attacks[HIT], 1);
+        return;
+    }
+    batch_Sink(batch, lane, ship);
+    STATS_ADD(attacks[SUNK], 1);
+}
+
+#ifdef BATCH_AVX2
+/**********************************************************//**
+ * @brief Attack each lane's tile in a group of lanes, like
+ * batch_Attack, 8 lanes per vector. The lanes without a game
+ * are left as they are. The runs are left to
+ * batch_UpdateAttacks.
+ * @param batch: The batch.
+ * @param group: The first lane of the group.
+ * @param move: The untried tile to attack in each lane with a
+ * game.
+ * @param hit: Output parameter for the lanes that hit, a bit
+ * per lane of the group.
+ * @param sunk: Output parameter for the lanes that sank a
+ * ship.
+ * @return The lanes that attacked.
+ **************************************************************/
+__attribute__((target("avx2")))
+static uint32_t batch_AttackAvx2(BATCH *batch, int group, const int move[BATCH_LANES_MAX], uint32_t *hit, uint32_t *sunk) {
+    int lanes = batch->lanes;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i empty = _mm256_set1_epi32(EMPTY);
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+    uint32_t active = 0;
+    *hit = 0;
+    *sunk = 0;
+    for (int half = 0; half < BATCH_WIDTH; half += 8) {
+        int first = group + half;
+        __m256i lane = _mm256_add_epi32(_mm256_set1_epi32(first), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i isActive = _mm256_cmpgt_epi32(_mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i *)&batch->active[first])), zero);
+        __m256i tile = _mm256_max_epi32(_mm256_loadu_si256((const __m256i *)&move[first]), zero);
+        __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(tile, _mm256_set1_epi32(lanes)), lane);
+
+        // Gather the status and ship under each lane's move
+        __m256i status = _mm256_and_si256(_mm256_i32gather_epi32((const int *)batch->status, index, 1), byte);
+        __m256i ship = _mm256_srai_epi32(_mm256_slli_epi32(
+            _mm256_i32gather_epi32((const int *)batch->ship, index, 1), 24), 24);
+
+        // The hits take one from the health of their ship; the
+        // other lanes write back the health they gathered.
+        __m256i isHit = _mm256_and_si256(isActive, _mm256_cmpgt_epi32(ship, empty));
+        __m256i slot = _mm256_add_epi32(_mm256_mullo_epi32(lane, _mm256_set1_epi32(N_SHIPS_MAX)),
+            _mm256_max_epi32(ship, zero));
+        __m256i health = _mm256_add_epi32(_mm256_i32gather_epi32(&batch->health[0][0], slot, 4), isHit);
+        __m256i isSunk = _mm256_and_si256(isHit, _mm256_cmpeq_epi32(health, zero));
+        __m256i *remaining = (__m256i *)&batch->remaining[first];
+        __m256i *turns = (__m256i *)&batch->turns[first];
+        _mm256_storeu_si256(remaining, _mm256_add_epi32(_mm256_loadu_si256(remaining), isHit));
+        _mm256_storeu_si256(turns, _mm256_sub_epi32(_mm256_loadu_si256(turns), isActive));
+        status = _mm256_blendv_epi8(status, _mm256_blendv_epi8(_mm256_set1_epi32(MISS),
+            _mm256_set1_epi32(HIT), isHit), isActive);
+
+        // AVX2 has no scatter, so the results are stored lane
+        // by lane, without branching on them.
+        int32_t indexOf[8];
+        int32_t slotOf[8];
+        int32_t healthOf[8];
+        int32_t statusOf[8];
+        int32_t activeOf[8];
+        _mm256_storeu_si256((__m256i *)indexOf, index);
+        _mm256_storeu_si256((__m256i *)slotOf, slot);
+        _mm256_storeu_si256((__m256i *)healthOf, health);
+        _mm256_storeu_si256((__m256i *)statusOf, status);
+        _mm256_storeu_si256((__m256i *)activeOf, isActive);
+        for (int i = 0; i < 8; i++) {
+            batch->status[indexOf[i]] = (uint8_t)statusOf[i];
+            batch->untried[indexOf[i]] &= (uint8_t)~activeOf[i];
+            (&batch->health[0][0])[slotOf[i]] = healthOf[i];
+        }
+        active |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(isActive)) << half;
+        *hit |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(isHit)) << half;
+        *sunk |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(isSunk)) << half;
+    }
+    STATS_ADD(attacks[MISS], __builtin_popcount(active & ~*hit));
+    STATS_ADD(attacks[HIT], __builtin_popcount(*hit & ~*sunk));
+    STATS_ADD(attacks[SUNK], __builtin_popcount(*sunk));
+    return active;
+}
+#endif
+
+/**********************************************************//**
+ * @brief Update the runs through the tiles a group of lanes
+ * attacked, walking the lanes of each kind of result.
+ * @param batch: The batch.
+ * @param group: The first lane of the group.
+ * @param move: The tile each lane attacked.
+ * @param active: The lanes that attacked, a bit per lane of
+ * the group.
+ * @param hit: The lanes that hit.
+ * @param sunk: The lanes that sank a ship.
+ **************************************************************/
+static void batch_UpdateAttacks(BATCH *batch, int group, const int move[BATCH_LANES_MAX],
+uint32_t active, uint32_t hit, uint32_t sunk) {
+    int size = field_GetSize();
+    for (uint32_t bits = active; bits; bits &= bits-1) {
+        int lane = group + __builtin_ctz(bits);
+        batch_UpdateLine(batch, lane, UNTRIED, move[lane] / size, move[lane] % size, true);
+        batch_UpdateLine(batch, lane, UNTRIED, move[lane] / size, move[lane] % size, false);
+    }
+    for (uint32_t bits = hit & ~sunk; bits; bits &= bits-1) {
+        int lane = group + __builtin_ctz(bits);
+        batch_UpdateLine(batch, lane, HIT, move[lane] / size, move[lane] % size, true);
+        batch_UpdateLine(batch, lane, HIT, move[lane] / size, move[lane] % size, false);
+    }
+    for (uint32_t bits = sunk; bits; bits &= bits-1) {
+        int lane = group + __builtin_ctz(bits);
+        batch_Sink(batch, lane, batch->ship[batch_GetIndex(batch, move[lane], lane)]);
+    }
+}
+
+/**********************************************************//**
+ * @brief Play one turn of the heuristic in every lane with a
+ * game in play.
+ * @param batch: The batch.
+ * @param move: Output parameter for the tile attacked in each
+ * lane, or -1 for lanes without a game.
+ * @return Whether every game in play had a tile to attack.
+ **************************************************************/
+bool batch_Step(BATCH *batch, int move[BATCH_LANES_MAX]) {
+    for (int group = 0; group < batch->lanes; group += BATCH_WIDTH) {
+        // Skip groups without games
+        bool active = false;
+        int16_t full[BATCH_WIDTH];
+        int16_t partial[BATCH_WIDTH];
+        for (int lane = 0; lane < BATCH_WIDTH; lane++) {
+            int fullMin = 0;
+            int partialMin = 0;
+            if (batch->active[group+lane]) {
+                active = true;
+                ai_GetMinimumLengths(batch->health[group+lane], &fullMin, &partialMin);
+            }
+            // No run is longer than the field, so the minimums
+            // only matter up to twice its size.
+            full[lane] = (int16_t)((fullMin < 2*field_GetSize())? fullMin: 2*field_GetSize());
+            partial[lane] = (int16_t)((partialMin < 2*field_GetSize())? partialMin: 2*field_GetSize());
+        }
+        if (!active) {
+            for (int lane = group; lane < group + BATCH_WIDTH; lane++) {
+                move[lane] = -1;
+            }
+            continue;
+        }
+#ifdef BATCH_AVX2
+        if (ai_GetKernel() == KERNEL_AVX2) {
+            batch_ScoreAvx2(batch, group, full, partial, move);
+        } else
+#endif
+        {
+            batch_ScoreScalar(batch, group, full, partial, move);
+        }
+    }
+
+    // Resolve the attacks
+    for (int lane = 0; lane < batch->lanes; lane++) {
+        if (!batch->active[lane]) {
+            move[lane] = -1;
+            continue;
+        }
+        if (move[lane] < 0) {
+            eprintf("No tile left to attack.\n");
+            return false;
+        }
+    }
+    for (int group = 0; group < batch->lanes; group += BATCH_WIDTH) {
+#ifdef BATCH_AVX2
+        if (ai_GetKernel() == KERNEL_AVX2) {
+            uint32_t hit;
+            uint32_t sunk;
+            uint32_t active = batch_AttackAvx2(batch, group, move, &hit, &sunk);
+            batch_UpdateAttacks(batch, group, move, active, hit, sunk);
+            continue;
+        }
+#endif
+        for (int lane = group; lane < group + BATCH_WIDTH; lane++) {
+            if (batch->active[lane]) {
+                batch_Attack(batch, lane, move[lane]);
+            }
+        }
+    }
+    return true;
+}
+
+/**************************************************************/
@@ -0,0 +1,77 @@
+/**********************************************************//**
+ * @file batch.h
+ * @brief Definition of the batch engine, which plays several
+ * games of the heuristic in lockstep. The boards of all the
+ * games are stored structure-of-arrays: for each tile, the
+ * status, ship and run lengths of every game are contiguous,
+ * so one tile can be scored for many games at once.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _BATCH_H_
+#define _BATCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "field.h"
+
+/**************************************************************/
+/// The number of games scored at once; lanes are padded to it.
+#define BATCH_WIDTH 16
+
+/// The most games a batch can play at once.
+#define BATCH_LANES_MAX 256
+
+/**********************************************************//**
+ * @struct BATCH
+ * @brief The boards of the games being played in lockstep.
+ * Each game is in a lane; the per-tile arrays are indexed by
+ * tile, then lane.
+ **************************************************************/
+typedef struct {
+    /// The number of lanes, a multiple of BATCH_WIDTH.
+    int lanes;
+    /// Whether each lane has a game in play.
+    bool active[BATCH_LANES_MAX];
+    /// Turns taken in each lane.
+    int turns[BATCH_LANES_MAX];
+    /// The total health left of the ships in each lane.
+    int remaining[BATCH_LANES_MAX];
+    /// The health of each ship in each lane.
+    int health[BATCH_LANES_MAX][N_SHIPS_MAX];
+    /// The turn each ship sank in each lane.
+    int sinkTurn[BATCH_LANES_MAX][N_SHIPS_MAX];
+    /// Where each ship lies in each lane.
+    PLACEMENT placement[BATCH_LANES_MAX][N_SHIPS_MAX];
+    /// The status of each tile.
+    uint8_t *status;
+    /// 0xFF for each untried tile, else 0.
+    uint8_t *untried;
+    /// The ship on each tile, or EMPTY.
+    int8_t *ship;
+    /// @brief The UNTRIED (0) and HIT (1) runs through each tile
+    /// in each direction, like the run tables of a FIELD.
+    uint8_t *run;
+} BATCH;
+
+/**********************************************************//**
+ * @brief Get the status of a tile in a lane.
+ * @param batch: The batch in question.
+ * @param lane: The lane.
+ * @param tile: The tile, as field_GetIndex(x, y).
+ * @return The status of the tile.
+ **************************************************************/
+static inline STATUS batch_GetStatus(const BATCH *batch, int lane, int tile) {
+    return (STATUS)batch->status[tile*batch->lanes + lane];
+}
+
+/**************************************************************/
+extern bool batch_Create(BATCH *batch, int lanes);
+extern void batch_Free(BATCH *batch);
+extern void batch_Load(BATCH *batch, int lane, const FIELD *field);
+extern bool batch_Step(BATCH *batch, int move[BATCH_LANES_MAX]);
+
+/**************************************************************/
+#endif // _BATCH_H_
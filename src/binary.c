@@ -0,0 +1,80 @@
+/**********************************************************//**
+ * @file binary.c
+ * @brief Implementation of the read-only memory maps.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "binary.h"
+
+/**********************************************************//**
+ * @brief Map a whole file into memory, read only.
+ * @param filename: The file to map.
+ * @param size: Output parameter for the size of the file.
+ * @return The start of the mapping, or NULL on failure.
+ **************************************************************/
+void *binary_MapFile(const char *filename, size_t *size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER length;
+    void *base = NULL;
+    if (GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        *size = (size_t)length.QuadPart;
+    }
+    CloseHandle(file);
+    return base;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    void *base = NULL;
+    if (!fstat(fd, &info) && info.st_size > 0) {
+        base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        base = (base == MAP_FAILED)? NULL: base;
+        *size = (size_t)info.st_size;
+    }
+    close(fd);
+    return base;
+#endif
+}
+
+/**********************************************************//**
+ * @brief Unmap a file mapped by binary_MapFile.
+ * @param base: The start of the mapping, or NULL.
+ * @param size: The size of the mapping.
+ **************************************************************/
+void binary_UnmapFile(void *base, size_t size) {
+    if (!base) {
+        return;
+    }
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(base);
+#else
+    munmap(base, size);
+#endif
+}
+
+/**************************************************************/
@@ -0,0 +1,47 @@
+/**********************************************************//**
+ * @file binary.h
+ * @brief Helpers shared by the binary file formats: integers
+ * stored in little endian order, and read-only memory maps of
+ * whole files.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _BINARY_H_
+#define _BINARY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**********************************************************//**
+ * @brief Store an integer in little endian order.
+ * @param buffer: Where to store the integer.
+ * @param value: The integer.
+ * @param size: The number of bytes to store.
+ **************************************************************/
+static inline void binary_Put(unsigned char *buffer, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        buffer[i] = (unsigned char)(value >> (8*i));
+    }
+}
+
+/**********************************************************//**
+ * @brief Load an integer stored in little endian order.
+ * @param buffer: Where the integer is stored.
+ * @param size: The number of bytes to load.
+ * @return The integer.
+ **************************************************************/
+static inline uint64_t binary_Get(const unsigned char *buffer, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= (uint64_t)buffer[i] << (8*i);
+    }
+    return value;
+}
+
+/**************************************************************/
+extern void *binary_MapFile(const char *filename, size_t *size);
+extern void binary_UnmapFile(void *base, size_t size);
+
+/**************************************************************/
+#endif // _BINARY_H_
@@ -0,0 +1,170 @@
+/**********************************************************//**
+ * @file book.c
+ * @brief Implementation of the opening book.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail The file is laid out as, with all integers little
+ * endian:
+ * - Header (32 bytes): "BSBK", version, field size, number of
+ *   ships, 0, number of moves (u16), then from byte 16 the
+ *   fleet name, zero padded.
+ * - One byte per move holding the tile attacked, indexed by
+ *   field_GetIndex.
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ai.h"
+#include "book.h"
+#include "debug.h"
+#include "field.h"
+#include "mask.h"
+#include "memo.h"
+
+/**************************************************************/
+/// The format version written in the header.
+#define BOOK_VERSION 1
+
+/// The size of the header in bytes.
+#define BOOK_HEADER 32
+
+/// Where the fleet name starts in the header.
+#define BOOK_NAME 16
+
+#if TURN_MAX > UINT8_MAX+1 || BOOK_NAME + BOOK_NAME_MAX > BOOK_HEADER
+#error "The book doesn't fit its format."
+#endif
+
+/// The book the AI plays from, or NULL for none.
+static const BOOK *Book = NULL;
+
+/// The tiles missed before each move of the book.
+static MASK Missed[TURN_MAX+1];
+
+/**********************************************************//**
+ * @brief Work out the book for the configured field size and
+ * fleet, by letting the heuristic play a field where every
+ * attack misses. A real game has room for at most as many
+ * misses as the tiles no ship covers, so the book stops after
+ * the move that follows that many.
+ * @param book: Output parameter for the book.
+ **************************************************************/
+void book_Create(BOOK *book) {
+    memset(book, 0, sizeof(BOOK));
+    book->size = field_GetSize();
+    strncpy(book->fleet, FieldRules.fleet->name, BOOK_NAME_MAX-1);
+
+    int covered = 0;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        covered += field_GetShipLength(ship);
+    }
+    FIELD field;
+    field_Clear(&field);
+    field_CreateHidden(&field);
+    int x, y;
+    while (book->moves <= field_GetTileCount() - covered && ai_ChooseTile(&field, &x, &y)) {
+        book->move[book->moves++] = (unsigned char)field_GetIndex(x, y);
+        field_Attack(&field, x, y);
+    }
+}
+
+/**********************************************************//**
+ * @brief Write a book to a file.
+ * @param book: The book.
+ * @param file: The file to write to, opened in binary mode.
+ * @return Whether the book was written.
+ **************************************************************/
+bool book_Write(const BOOK *book, FILE *file) {
+    unsigned char header[BOOK_HEADER] = {
+        'B', 'S', 'B', 'K', BOOK_VERSION, (unsigned char)book->size,
+        (unsigned char)field_GetShipCount(), 0,
+        (unsigned char)book->moves, (unsigned char)(book->moves >> 8),
+    };
+    memcpy(&header[BOOK_NAME], book->fleet, BOOK_NAME_MAX);
+    return fwrite(header, BOOK_HEADER, 1, file) == 1
+        && fwrite(book->move, 1, book->moves, file) == (size_t)book->moves;
+}
+
+/**********************************************************//**
+ * @brief Read a book from a file. It must be for the
+ * configured field size and fleet.
+ * @param book: Output parameter for the book.
+ * @param file: The file to read from, opened in binary mode.
+ * @return Whether the file holds a book for these rules.
+ **************************************************************/
+bool book_Read(BOOK *book, FILE *file) {
+    unsigned char header[BOOK_HEADER];
+    if (fread(header, BOOK_HEADER, 1, file) != 1 || memcmp(header, "BSBK", 4)
+    || header[4] != BOOK_VERSION || header[BOOK_NAME + BOOK_NAME_MAX - 1] != '\0') {
+        eprintf("Not an opening book.\n");
+        return false;
+    }
+    book->size = header[5];
+    book->moves = header[8] | (header[9] << 8);
+    memcpy(book->fleet, &header[BOOK_NAME], BOOK_NAME_MAX);
+    if (book->size != field_GetSize() || header[6] != field_GetShipCount()
+    || strcmp(book->fleet, FieldRules.fleet->name)) {
+        eprintf("The book is for another field size or fleet.\n");
+        return false;
+    }
+    if (book->moves > field_GetTileCount()
+    || fread(book->move, 1, book->moves, file) != (size_t)book->moves) {
+        eprintf("The book is truncated.\n");
+        return false;
+    }
+    for (int i = 0; i < book->moves; i++) {
+        if (book->move[i] >= field_GetTileCount()) {
+            eprintf("The book has an invalid move.\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Set the book the AI plays from. This must be done
+ * before any games start, and the book must outlive them.
+ * @param book: The book, or NULL to always play the heuristic.
+ **************************************************************/
+void book_Configure(const BOOK *book) {
+    Book = book;
+    if (book) {
+        Missed[0] = mask_Empty();
+        for (int i = 0; i < book->moves; i++) {
+            Missed[i+1] = Missed[i];
+            mask_Set(&Missed[i+1], book->move[i]);
+        }
+    }
+}
+
+/**********************************************************//**
+ * @brief Choose the tile to attack next. While every attack so
+ * far was a miss on the book's own line, the next move is
+ * looked up; after that the heuristic plays, through the memo
+ * cache.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+bool book_ChooseTile(const FIELD *field, int *x, int *y) {
+    int turns = field_GetTurnCount(field);
+    if (Book && turns < Book->moves) {
+        MASK missed = field_GetMask(field, MISS);
+        bool inBook = true;
+        for (int w = 0; w < MASK_WORDS; w++) {
+            inBook &= (missed.word[w] == Missed[turns].word[w]);
+        }
+        if (inBook) {
+            *x = Book->move[turns] / field_GetSize();
+            *y = Book->move[turns] % field_GetSize();
+            return true;
+        }
+    }
+    return memo_ChooseTile(field, x, y);
+}
+
+/**************************************************************/
@@ -0,0 +1,47 @@
+/**********************************************************//**
+ * @file book.h
+ * @brief Definition of the opening book. Until its first hit
+ * the heuristic only sees misses, so its moves form a single
+ * fixed line that depends on the field size and fleet alone.
+ * The book stores that line, so those moves are looked up
+ * instead of scanned for.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _BOOK_H_
+#define _BOOK_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "field.h"
+
+/**************************************************************/
+/// The longest fleet name a book header has room for.
+#define BOOK_NAME_MAX 16
+
+/**********************************************************//**
+ * @struct BOOK
+ * @brief The heuristic's moves before its first hit.
+ **************************************************************/
+typedef struct {
+    /// The size of the field the book is for.
+    int size;
+    /// The name of the fleet the book is for.
+    char fleet[BOOK_NAME_MAX];
+    /// The number of moves.
+    int moves;
+    /// The tile of each move, as field_GetIndex(x, y).
+    unsigned char move[TURN_MAX];
+} BOOK;
+
+/**************************************************************/
+extern void book_Create(BOOK *book);
+extern bool book_Write(const BOOK *book, FILE *file);
+extern bool book_Read(BOOK *book, FILE *file);
+extern void book_Configure(const BOOK *book);
+extern bool book_ChooseTile(const FIELD *field, int *x, int *y);
+
+/**************************************************************/
+#endif // _BOOK_H_
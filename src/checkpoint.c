@@ -0,0 +1,193 @@
+/**********************************************************//**
+ * @file checkpoint.c
+ * @brief Implementation of run checkpoints.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail A checkpoint is a short text file: one "key value"
+ * line for each field, then the summary as summary_Write
+ * writes it. It is written to a temporary file first and then
+ * renamed over the last one, so a run killed while saving
+ * leaves the last checkpoint whole.
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "checkpoint.h"
+#include "summary.h"
+
+/**************************************************************/
+/// The format version written in the first line.
+#define CHECKPOINT_VERSION 3
+
+/**********************************************************//**
+ * @brief Write out everything buffered for a file, through to
+ * the disk, and get where it ends.
+ * @param file: The file, or NULL.
+ * @param offset: Output parameter for the end of the file, or
+ * -1 if there is no file.
+ * @return Whether the file was written out.
+ **************************************************************/
+bool checkpoint_Sync(FILE *file, int64_t *offset) {
+    *offset = -1;
+    if (!file) {
+        return true;
+    }
+    if (fflush(file)) {
+        return false;
+    }
+#ifdef _WIN32
+    bool synced = !_commit(_fileno(file));
+#else
+    bool synced = !fsync(fileno(file));
+#endif
+    *offset = (int64_t)ftello(file);
+    return synced && *offset >= 0;
+}
+
+/**********************************************************//**
+ * @brief Cut a file opened for update to a length, and move to
+ * its end, to write after what a checkpoint kept.
+ * @param file: The file.
+ * @param offset: The length to keep.
+ * @return Whether the file was cut.
+ **************************************************************/
+bool checkpoint_Truncate(FILE *file, int64_t offset) {
+    if (fflush(file)) {
+        return false;
+    }
+#ifdef _WIN32
+    bool cut = !_chsize_s(_fileno(file), offset);
+#else
+    bool cut = !ftruncate(fileno(file), (off_t)offset);
+#endif
+    return cut && !fseeko(file, (off_t)offset, SEEK_SET);
+}
+
+/**********************************************************//**
+ * @brief Save a checkpoint, replacing the last one at once.
+ * @param checkpoint: The checkpoint.
+ * @param filename: The file to save it to.
+ * @return Whether the checkpoint was saved.
+ **************************************************************/
+bool checkpoint_Save(const CHECKPOINT *checkpoint, const char *filename) {
+    size_t length = strlen(filename);
+    char *temporary = malloc(length + sizeof(".tmp"));
+    if (!temporary) {
+        fprintf(stderr, "Failed to allocate the checkpoint name.\n");
+        return false;
+    }
+    memcpy(temporary, filename, length);
+    memcpy(temporary + length, ".tmp", sizeof(".tmp"));
+
+    FILE *file = fopen(temporary, "w");
+    if (!file) {
+        fprintf(stderr, "Failed to open \"%s\".\n", temporary);
+        free(temporary);
+        return false;
+    }
+    fprintf(file, "checkpoint %d\n", CHECKPOINT_VERSION);
+    fprintf(file, "seed %llu\n", (unsigned long long)checkpoint->seed);
+    fprintf(file, "run_games %llu\n", (unsigned long long)checkpoint->games);
+    fprintf(file, "played %llu\n", (unsigned long long)checkpoint->played);
+    fprintf(file, "size %d\n", checkpoint->size);
+    fprintf(file, "fleet %s\n", checkpoint->fleet);
+    fprintf(file, "ai %s\n", checkpoint->strategy);
+    fprintf(file, "corpus %llu\n", (unsigned long long)checkpoint->corpus);
+    fprintf(file, "samples %d\n", checkpoint->samples);
+    fprintf(file, "sample_micros %d\n", checkpoint->sampleMicros);
+    fprintf(file, "endgame_layouts %d\n", checkpoint->endgameLayouts);
+    fprintf(file, "endgame_nodes %d\n", checkpoint->endgameNodes);
+    fprintf(file, "endgame_micros %d\n", checkpoint->endgameMicros);
+    fprintf(file, "output %lld\n", (long long)checkpoint->output);
+    fprintf(file, "columns %d\n", checkpoint->columns);
+    fprintf(file, "game_log %lld\n", (long long)checkpoint->gameLog);
+    fprintf(file, "binary_log %lld\n", (long long)checkpoint->binaryLog);
+    fprintf(file, "summary %d\n", checkpoint->summarized);
+    if (checkpoint->summarized) {
+        summary_Write(&checkpoint->summary, file);
+    }
+    int64_t end;
+    bool written = !ferror(file) && checkpoint_Sync(file, &end);
+    written = !fclose(file) && written;
+
+    // Only replace the last checkpoint with a whole one
+#ifdef _WIN32
+    written = written && MoveFileExA(temporary, filename, MOVEFILE_REPLACE_EXISTING);
+#else
+    written = written && !rename(temporary, filename);
+#endif
+    if (!written) {
+        fprintf(stderr, "Failed to save the checkpoint \"%s\".\n", filename);
+        remove(temporary);
+    }
+    free(temporary);
+    return written;
+}
+
+/**********************************************************//**
+ * @brief Load a checkpoint.
+ * @param checkpoint: Output parameter for the checkpoint.
+ * @param filename: The file to load it from.
+ * @return Whether the file is a whole checkpoint. The rules
+ * must be configured like the run's to read its summary.
+ **************************************************************/
+bool checkpoint_Load(CHECKPOINT *checkpoint, const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Failed to open \"%s\".\n", filename);
+        return false;
+    }
+    int version;
+    unsigned long long seed;
+    unsigned long long games;
+    unsigned long long played;
+    unsigned long long corpus;
+    long long output;
+    long long gameLog;
+    long long binaryLog;
+    int columns;
+    int summarized;
+    int read = fscanf(file,
+        "checkpoint %d seed %llu run_games %llu played %llu size %d fleet %31s ai %31s "
+        "corpus %llu samples %d sample_micros %d endgame_layouts %d endgame_nodes %d endgame_micros %d "
+        "output %lld columns %d game_log %lld binary_log %lld summary %d",
+        &version, &seed, &games, &played, &checkpoint->size,
+        checkpoint->fleet, checkpoint->strategy, &corpus, &checkpoint->samples,
+        &checkpoint->sampleMicros, &checkpoint->endgameLayouts, &checkpoint->endgameNodes,
+        &checkpoint->endgameMicros, &output, &columns, &gameLog, &binaryLog, &summarized);
+    bool success = (read == 18 && version == CHECKPOINT_VERSION && played <= games);
+    checkpoint->seed = seed;
+    checkpoint->games = games;
+    checkpoint->played = played;
+    checkpoint->corpus = corpus;
+    checkpoint->output = output;
+    checkpoint->gameLog = gameLog;
+    checkpoint->binaryLog = binaryLog;
+    checkpoint->columns = columns;
+    checkpoint->summarized = summarized;
+    if (success && summarized) {
+        success = summary_Read(&checkpoint->summary, file)
+            && checkpoint->summary.games == checkpoint->played;
+    } else {
+        summary_Clear(&checkpoint->summary);
+    }
+    fclose(file);
+    if (!success) {
+        fprintf(stderr, "\"%s\" is not a whole checkpoint.\n", filename);
+    }
+    return success;
+}
+
+/**************************************************************/
@@ -0,0 +1,79 @@
+/**********************************************************//**
+ * @file checkpoint.h
+ * @brief Checkpoints of a long simulation run. A checkpoint
+ * says how many games were played and logged, and where each
+ * output file ends after them, so a killed run can be resumed
+ * from there with the same results. Every game draws from its
+ * own random stream of the run's seed, so the game index is
+ * all the random state there is.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "summary.h"
+
+/**************************************************************/
+/// The longest AI or fleet name a checkpoint has room for.
+#define CHECKPOINT_NAME_MAX 32
+
+/// The default least seconds between checkpoints.
+#define CHECKPOINT_INTERVAL 60
+
+/**********************************************************//**
+ * @struct CHECKPOINT
+ * @brief Where a run was when it saved a checkpoint.
+ **************************************************************/
+typedef struct {
+    /// The seed of the run.
+    uint64_t seed;
+    /// The number of games of the run.
+    uint64_t games;
+    /// The number of games played and logged.
+    uint64_t played;
+    /// The size of the field.
+    int size;
+    /// The name of the fleet.
+    char fleet[CHECKPOINT_NAME_MAX];
+    /// The name of the AI.
+    char strategy[CHECKPOINT_NAME_MAX];
+    /// The digest of the corpus played, or 0 for random fleets.
+    uint64_t corpus;
+    /// The Monte Carlo AI's layouts to draw per turn.
+    int samples;
+    /// The Monte Carlo AI's microseconds per turn, or 0.
+    int sampleMicros;
+    /// The layouts left when the endgame AI starts searching.
+    int endgameLayouts;
+    /// The endgame AI's positions to search per turn.
+    int endgameNodes;
+    /// The endgame AI's microseconds per turn, or 0.
+    int endgameMicros;
+    /// The end of the CSV output, or -1 if there is none.
+    int64_t output;
+    /// Whether the run writes binary columns.
+    bool columns;
+    /// The end of the markdown game log, or -1 if there is none.
+    int64_t gameLog;
+    /// The end of the binary game log, or -1 if there is none.
+    int64_t binaryLog;
+    /// Whether the run keeps a summary.
+    bool summarized;
+    /// The summary of the games played, if the run keeps one.
+    SUMMARY summary;
+} CHECKPOINT;
+
+/**************************************************************/
+extern bool checkpoint_Sync(FILE *file, int64_t *offset);
+extern bool checkpoint_Truncate(FILE *file, int64_t offset);
+extern bool checkpoint_Save(const CHECKPOINT *checkpoint, const char *filename);
+extern bool checkpoint_Load(CHECKPOINT *checkpoint, const char *filename);
+
+/**************************************************************/
+#endif // _CHECKPOINT_H_
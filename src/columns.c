@@ -0,0 +1,234 @@
+/**********************************************************//**
+ * @file columns.c
+ * @brief Implementation of the binary columnar results file.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail The file is laid out as, with all integers little
+ * endian:
+ * - Header (64 bytes): "BSCO", version, field size, number of
+ *   ships, bytes per value, seed (u64), games (u64), the length
+ *   of each ship (room for N_SHIPS_MAX), then from byte 40 the
+ *   fleet name, zero padded.
+ * - The turn count of every game, in game order.
+ * - The sink turn of every game for each ship, in ship order.
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "binary.h"
+#include "columns.h"
+#include "field.h"
+
+/**************************************************************/
+/// The format version written in the header.
+#define COLUMNS_VERSION 2
+
+/// The size of the header in bytes.
+#define COLUMNS_HEADER 64
+
+/// Where the fleet name starts in the header.
+#define COLUMNS_NAME 40
+
+#if 24 + N_SHIPS_MAX > COLUMNS_NAME || COLUMNS_NAME + COLUMNS_NAME_MAX > COLUMNS_HEADER
+#error "The fleet doesn't fit in the columns header."
+#endif
+
+/**********************************************************//**
+ * @brief Start writing a columnar results file. The number of
+ * games must be known up front, since it fixes where each
+ * column starts.
+ * @param columns: The file to set up.
+ * @param file: The file to write to, opened in binary mode.
+ * It must be seekable.
+ * @param seed: The seed of the run.
+ * @param games: The number of games of the run.
+ * @return Whether the header was written.
+ **************************************************************/
+bool columns_Create(COLUMNS *columns, FILE *file, uint64_t seed, uint64_t games) {
+    columns->file = file;
+    columns->games = games;
+    columns->added = 0;
+    columns->buffered = 0;
+    columns->width = (field_GetTileCount() > UINT8_MAX)? 2: 1;
+
+    const char *name = FieldRules.fleet->name;
+    if (strlen(name) >= COLUMNS_NAME_MAX) {
+        fprintf(stderr, "The fleet name \"%s\" is too long.\n", name);
+        return false;
+    }
+    unsigned char header[COLUMNS_HEADER] = {
+        'B', 'S', 'C', 'O', COLUMNS_VERSION, (unsigned char)field_GetSize(),
+        (unsigned char)field_GetShipCount(), (unsigned char)columns->width
+    };
+    binary_Put(&header[8], seed, 8);
+    binary_Put(&header[16], games, 8);
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        header[24+ship] = (unsigned char)field_GetShipLength(ship);
+    }
+    memcpy(&header[COLUMNS_NAME], name, strlen(name));
+    return fwrite(header, COLUMNS_HEADER, 1, file) == 1;
+}
+
+/**********************************************************//**
+ * @brief Write the buffered games to each column.
+ * @param columns: The file to write to.
+ * @return Whether the games were written.
+ **************************************************************/
+static bool columns_Flush(COLUMNS *columns) {
+    static unsigned char packed[COLUMNS_BUFFER*sizeof(COLUMN)];
+    uint64_t first = columns->added - columns->buffered;
+    int width = columns->width;
+    for (int c = 0; c <= field_GetShipCount(); c++) {
+        for (int i = 0; i < columns->buffered; i++) {
+            binary_Put(&packed[i*width], columns->buffer[c][i], width);
+        }
+        uint64_t offset = COLUMNS_HEADER + (c*columns->games + first)*width;
+        if (fseeko(columns->file, (off_t)offset, SEEK_SET)
+        || fwrite(packed, width, columns->buffered, columns->file) != (size_t)columns->buffered) {
+            fprintf(stderr, "Failed to write column %d.\n", c);
+            return false;
+        }
+    }
+    columns->buffered = 0;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Add the next game to the file.
+ * @param columns: The file to add to.
+ * @param turns: The number of turns the game took.
+ * @param sinkTurn: The turn each ship sank.
+ * @return Whether the game fits and could be written.
+ **************************************************************/
+bool columns_Add(COLUMNS *columns, int turns, const int sinkTurn[N_SHIPS_MAX]) {
+    if (columns->added == columns->games) {
+        fprintf(stderr, "The columns file is full.\n");
+        return false;
+    }
+    columns->buffer[0][columns->buffered] = (COLUMN)turns;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        columns->buffer[1+ship][columns->buffered] = (COLUMN)sinkTurn[ship];
+    }
+    columns->added++;
+    columns->buffered++;
+    return (columns->buffered < COLUMNS_BUFFER) || columns_Flush(columns);
+}
+
+/**********************************************************//**
+ * @brief Write out the buffered games, so the file holds every
+ * game added so far.
+ * @param columns: The file to write to.
+ * @return Whether the games were written.
+ **************************************************************/
+bool columns_Sync(COLUMNS *columns) {
+    return (columns->buffered == 0 || columns_Flush(columns)) && !fflush(columns->file);
+}
+
+/**********************************************************//**
+ * @brief Continue writing a columnar results file that an
+ * earlier run started, after the games it synced.
+ * @param columns: The file to set up.
+ * @param file: The file to write to, opened for update in
+ * binary mode.
+ * @param seed: The seed of the run.
+ * @param games: The number of games of the run.
+ * @param added: The number of games already in the file.
+ * @return Whether the file's header matches the run.
+ **************************************************************/
+bool columns_Resume(COLUMNS *columns, FILE *file, uint64_t seed, uint64_t games, uint64_t added) {
+    columns->file = file;
+    columns->games = games;
+    columns->added = added;
+    columns->buffered = 0;
+    columns->width = (field_GetTileCount() > UINT8_MAX)? 2: 1;
+
+    unsigned char header[COLUMNS_HEADER];
+    if (fseek(file, 0, SEEK_SET) || fread(header, COLUMNS_HEADER, 1, file) != 1
+    || memcmp(header, "BSCO", 4) || header[4] != COLUMNS_VERSION || header[5] != field_GetSize()
+    || header[6] != field_GetShipCount() || header[7] != columns->width
+    || binary_Get(&header[8], 8) != seed || binary_Get(&header[16], 8) != games || added > games) {
+        fprintf(stderr, "The columns file is for another run.\n");
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Finish writing a columnar results file. The file
+ * itself is left open.
+ * @param columns: The file to finish.
+ * @return Whether all the games were written.
+ **************************************************************/
+bool columns_Finish(COLUMNS *columns) {
+    if (columns->buffered > 0 && !columns_Flush(columns)) {
+        return false;
+    }
+    if (columns->added != columns->games) {
+        fprintf(stderr, "Only %llu of %llu games were written.\n",
+            (unsigned long long)columns->added, (unsigned long long)columns->games);
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Map a columnar results file into memory.
+ * @param map: Output parameter for the mapped columns.
+ * @param filename: The file to map.
+ * @return Whether the file is a complete columnar results file.
+ **************************************************************/
+bool columns_Map(COLUMNS_MAP *map, const char *filename) {
+    memset(map, 0, sizeof(COLUMNS_MAP));
+    map->base = binary_MapFile(filename, &map->size);
+    if (!map->base) {
+        fprintf(stderr, "Failed to map \"%s\".\n", filename);
+        return false;
+    }
+
+    const unsigned char *header = map->base;
+    if (map->size < COLUMNS_HEADER || memcmp(header, "BSCO", 4) || header[4] != COLUMNS_VERSION
+    || header[6] > N_SHIPS_MAX || (header[7] != 1 && header[7] != 2)
+    || header[COLUMNS_NAME + COLUMNS_NAME_MAX - 1] != '\0') {
+        fprintf(stderr, "Not a columns file.\n");
+        columns_Unmap(map);
+        return false;
+    }
+    map->fieldSize = header[5];
+    map->ships = header[6];
+    map->width = header[7];
+    map->seed = binary_Get(&header[8], 8);
+    map->games = binary_Get(&header[16], 8);
+    for (SHIP ship = 0; ship < map->ships; ship++) {
+        map->length[ship] = header[24+ship];
+    }
+    memcpy(map->fleet, &header[COLUMNS_NAME], COLUMNS_NAME_MAX);
+    if (map->size < COLUMNS_HEADER + (map->ships+1)*map->games*map->width) {
+        fprintf(stderr, "The columns file is truncated.\n");
+        columns_Unmap(map);
+        return false;
+    }
+
+    const unsigned char *column = header + COLUMNS_HEADER;
+    map->turns = column;
+    for (SHIP ship = 0; ship < map->ships; ship++) {
+        map->sinkTurn[ship] = column + (1+ship)*map->games*map->width;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Unmap a columnar results file.
+ * @param map: The mapped columns.
+ **************************************************************/
+void columns_Unmap(COLUMNS_MAP *map) {
+    binary_UnmapFile(map->base, map->size);
+    map->base = NULL;
+    map->size = 0;
+}
+
+/**************************************************************/
@@ -0,0 +1,91 @@
+/**********************************************************//**
+ * @file columns.h
+ * @brief Binary columnar results file: the turn count of every
+ * game, then each ship's sink turn of every game, as fixed
+ * width integers behind a small header. Values are one byte
+ * while every turn count fits in one, else two. The reader memory-maps
+ * the file, so each column is a plain array.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _COLUMNS_H_
+#define _COLUMNS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "field.h"
+
+/**************************************************************/
+/// The number of games buffered per column before writing.
+#define COLUMNS_BUFFER 4096
+
+/// The longest fleet name a header has room for.
+#define COLUMNS_NAME_MAX 24
+
+/// @brief One value of a column while buffered; it is written
+/// with the width of the file.
+typedef uint16_t COLUMN;
+
+/**********************************************************//**
+ * @struct COLUMNS
+ * @brief A columnar results file being written.
+ **************************************************************/
+typedef struct {
+    /// The file, which must be seekable.
+    FILE *file;
+    /// The number of games the file has room for.
+    uint64_t games;
+    /// The number of games added so far.
+    uint64_t added;
+    /// The number of games buffered but not written.
+    int buffered;
+    /// The number of bytes per value.
+    int width;
+    /// The buffered turn counts, then sink turns of each ship.
+    COLUMN buffer[N_SHIPS_MAX+1][COLUMNS_BUFFER];
+} COLUMNS;
+
+/**********************************************************//**
+ * @struct COLUMNS_MAP
+ * @brief A columnar results file mapped into memory.
+ **************************************************************/
+typedef struct {
+    /// The seed of the run.
+    uint64_t seed;
+    /// The number of games.
+    uint64_t games;
+    /// The size of the field the games were played on.
+    int fieldSize;
+    /// The name of the fleet.
+    char fleet[COLUMNS_NAME_MAX];
+    /// The number of ships of the fleet.
+    int ships;
+    /// The length of each ship of the fleet.
+    int length[N_SHIPS_MAX];
+    /// The number of bytes per value, 1 or 2.
+    int width;
+    /// The turn count of each game.
+    const unsigned char *turns;
+    /// The sink turn of each ship in each game.
+    const unsigned char *sinkTurn[N_SHIPS_MAX];
+    /// The start of the mapping.
+    void *base;
+    /// The size of the mapping in bytes.
+    size_t size;
+} COLUMNS_MAP;
+
+/**************************************************************/
+extern bool columns_Create(COLUMNS *columns, FILE *file, uint64_t seed, uint64_t games);
+extern bool columns_Add(COLUMNS *columns, int turns, const int sinkTurn[N_SHIPS_MAX]);
+extern bool columns_Sync(COLUMNS *columns);
+extern bool columns_Resume(COLUMNS *columns, FILE *file, uint64_t seed, uint64_t games, uint64_t added);
+extern bool columns_Finish(COLUMNS *columns);
+extern bool columns_Map(COLUMNS_MAP *map, const char *filename);
+extern void columns_Unmap(COLUMNS_MAP *map);
+
+/**************************************************************/
+#endif // _COLUMNS_H_
@@ -0,0 +1,178 @@
+/**********************************************************//**
+ * @file corpus.c
+ * @brief Implementation of the layout corpus.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail The file is laid out as, with all integers little
+ * endian:
+ * - Header (32 bytes): "BSLY", version, field size, number of
+ *   ships, 0, number of layouts (u32), then from byte 16 the
+ *   fleet name, zero padded.
+ * - Each layout: its turn count (u16), then per ship the index
+ *   of its first tile, plus 0x8000 if it lies DOWN (u16).
+ *   Tiles are indexed by field_GetIndex.
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "corpus.h"
+#include "debug.h"
+#include "field.h"
+
+/**************************************************************/
+/// The format version written in the header.
+#define CORPUS_VERSION 1
+
+/// The size of the header in bytes.
+#define CORPUS_HEADER 32
+
+/// Where the fleet name starts in the header.
+#define CORPUS_NAME 16
+
+/// Flag on a ship entry for ships that lie DOWN.
+#define CORPUS_DOWN 0x8000
+
+#if CORPUS_NAME + CORPUS_NAME_MAX > CORPUS_HEADER
+#error "The fleet name doesn't fit in the corpus header."
+#endif
+
+/**********************************************************//**
+ * @brief Write a corpus to a file.
+ * @param corpus: The corpus, for the configured rules.
+ * @param file: The file to write to, opened in binary mode.
+ * @return Whether the corpus was written.
+ **************************************************************/
+bool corpus_Write(const CORPUS *corpus, FILE *file) {
+    unsigned char header[CORPUS_HEADER] = {
+        'B', 'S', 'L', 'Y', CORPUS_VERSION, (unsigned char)corpus->size,
+        (unsigned char)field_GetShipCount(), 0,
+        (unsigned char)corpus->count, (unsigned char)(corpus->count >> 8),
+        (unsigned char)(corpus->count >> 16), (unsigned char)(corpus->count >> 24),
+    };
+    memcpy(&header[CORPUS_NAME], corpus->fleet, CORPUS_NAME_MAX);
+    if (fwrite(header, CORPUS_HEADER, 1, file) != 1) {
+        return false;
+    }
+    for (int i = 0; i < corpus->count; i++) {
+        const LAYOUT *layout = &corpus->layout[i];
+        unsigned char entry[2*(N_SHIPS_MAX+1)];
+        int size = 0;
+        entry[size++] = (unsigned char)layout->turns;
+        entry[size++] = (unsigned char)(layout->turns >> 8);
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            const PLACEMENT *placement = &layout->fleet[ship];
+            int value = field_GetIndex(placement->x, placement->y);
+            value |= (placement->view == DOWN)? CORPUS_DOWN: 0;
+            entry[size++] = (unsigned char)value;
+            entry[size++] = (unsigned char)(value >> 8);
+        }
+        if (fwrite(entry, 1, size, file) != (size_t)size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Read a corpus from a file. It must be for the
+ * configured field size and fleet, and every layout must fit.
+ * @param corpus: Output parameter for the corpus. Free it with
+ * corpus_Free.
+ * @param file: The file to read from, opened in binary mode.
+ * @return Whether the file holds a corpus for these rules.
+ **************************************************************/
+bool corpus_Read(CORPUS *corpus, FILE *file) {
+    memset(corpus, 0, sizeof(CORPUS));
+    unsigned char header[CORPUS_HEADER];
+    if (fread(header, CORPUS_HEADER, 1, file) != 1 || memcmp(header, "BSLY", 4)
+    || header[4] != CORPUS_VERSION || header[CORPUS_NAME + CORPUS_NAME_MAX - 1] != '\0') {
+        eprintf("Not a layout corpus.\n");
+        return false;
+    }
+    corpus->size = header[5];
+    uint32_t count = header[8] | (header[9] << 8) | ((uint32_t)header[10] << 16) | ((uint32_t)header[11] << 24);
+    memcpy(corpus->fleet, &header[CORPUS_NAME], CORPUS_NAME_MAX);
+    if (corpus->size != field_GetSize() || header[6] != field_GetShipCount()
+    || strcmp(corpus->fleet, FieldRules.fleet->name)) {
+        eprintf("The corpus is for another field size or fleet.\n");
+        return false;
+    }
+    if (count == 0 || count > INT32_MAX / sizeof(LAYOUT)) {
+        eprintf("The corpus has no layouts.\n");
+        return false;
+    }
+    corpus->layout = malloc(count*sizeof(LAYOUT));
+    if (!corpus->layout) {
+        eprintf("Failed to allocate the corpus.\n");
+        return false;
+    }
+    corpus->count = (int)count;
+
+    // Check each layout by setting it up on a field
+    for (int i = 0; i < corpus->count; i++) {
+        LAYOUT *layout = &corpus->layout[i];
+        unsigned char entry[2*(N_SHIPS_MAX+1)];
+        size_t size = 2*(field_GetShipCount()+1);
+        if (fread(entry, 1, size, file) != size) {
+            eprintf("The corpus is truncated.\n");
+            corpus_Free(corpus);
+            return false;
+        }
+        layout->turns = entry[0] | (entry[1] << 8);
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            int value = entry[2*ship+2] | (entry[2*ship+3] << 8);
+            int tile = value & ~CORPUS_DOWN;
+            layout->fleet[ship].x = tile / field_GetSize();
+            layout->fleet[ship].y = tile % field_GetSize();
+            layout->fleet[ship].view = (value & CORPUS_DOWN)? DOWN: RIGHT;
+            layout->fleet[ship].length = field_GetShipLength(ship);
+        }
+        FIELD field;
+        field_Clear(&field);
+        if (!field_CreateFleet(&field, layout->fleet)) {
+            eprintf("Layout %d of the corpus doesn't fit.\n", i+1);
+            corpus_Free(corpus);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Get a digest of the layouts of a corpus, in order, so
+ * runs can tell whether they play the same corpus.
+ * @param corpus: The corpus, or NULL for random fleets.
+ * @return The digest, or 0 for random fleets.
+ **************************************************************/
+uint64_t corpus_GetDigest(const CORPUS *corpus) {
+    if (!corpus) {
+        return 0;
+    }
+    uint64_t digest = UINT64_C(0xCBF29CE484222325);
+    digest = (digest ^ (uint64_t)corpus->count) * UINT64_C(0x100000001B3);
+    for (int i = 0; i < corpus->count; i++) {
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            const PLACEMENT *placement = &corpus->layout[i].fleet[ship];
+            uint64_t value = (uint64_t)field_GetIndex(placement->x, placement->y);
+            value |= (placement->view == DOWN)? CORPUS_DOWN: 0;
+            digest = (digest ^ value) * UINT64_C(0x100000001B3);
+        }
+    }
+    return digest;
+}
+
+/**********************************************************//**
+ * @brief Free the layouts of a corpus.
+ * @param corpus: The corpus.
+ **************************************************************/
+void corpus_Free(CORPUS *corpus) {
+    free(corpus->layout);
+    corpus->layout = NULL;
+    corpus->count = 0;
+}
+
+/**************************************************************/
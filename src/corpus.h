@@ -0,0 +1,56 @@
+/**********************************************************//**
+ * @file corpus.h
+ * @brief Definition of the layout corpus: a ranked list of
+ * fixed fleet layouts, such as the ones an AI found hardest,
+ * that the simulator can play instead of random fleets.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _CORPUS_H_
+#define _CORPUS_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "field.h"
+
+/**************************************************************/
+/// The longest fleet name a corpus header has room for.
+#define CORPUS_NAME_MAX 16
+
+/**********************************************************//**
+ * @struct LAYOUT
+ * @brief One fleet layout of a corpus.
+ **************************************************************/
+typedef struct {
+    /// The turns the layout took when it was ranked.
+    int turns;
+    /// Where each ship lies.
+    PLACEMENT fleet[N_SHIPS_MAX];
+} LAYOUT;
+
+/**********************************************************//**
+ * @struct CORPUS
+ * @brief Fleet layouts for one field size and fleet, hardest
+ * first.
+ **************************************************************/
+typedef struct {
+    /// The size of the field the layouts are for.
+    int size;
+    /// The name of the fleet the layouts are for.
+    char fleet[CORPUS_NAME_MAX];
+    /// The number of layouts.
+    int count;
+    /// The layouts.
+    LAYOUT *layout;
+} CORPUS;
+
+/**************************************************************/
+extern bool corpus_Write(const CORPUS *corpus, FILE *file);
+extern bool corpus_Read(CORPUS *corpus, FILE *file);
+extern uint64_t corpus_GetDigest(const CORPUS *corpus);
+extern void corpus_Free(CORPUS *corpus);
+
+/**************************************************************/
+#endif // _CORPUS_H_
@@ -0,0 +1,169 @@
+/**********************************************************//**
+ * @file density.c
+ * @brief Implementation of the probability density AI.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "debug.h"
+#include "density.h"
+#include "field.h"
+#include "mask.h"
+#include "placement.h"
+
+/**************************************************************/
+/// @brief The most slot combinations to enumerate jointly. The
+/// leading ships are enumerated while the product of their slot
+/// counts stays within this; the others are counted on their
+/// own.
+#define DENSITY_JOINT_MAX 4096
+
+/**********************************************************//**
+ * @struct CANDIDATES
+ * @brief The slots one afloat ship could still be in.
+ **************************************************************/
+typedef struct {
+    /// The consistent slots.
+    const SLOT *slot[SLOTS_MAX];
+    /// The number of consistent slots.
+    int count;
+    /// The number of fleet layouts that use each slot.
+    uint64_t weight[SLOTS_MAX];
+} CANDIDATES;
+
+/**********************************************************//**
+ * @brief Count the ways to lay the remaining ships without
+ * overlapping, and how many of those ways use each slot. Each
+ * slot already covers exactly its own ship's hits, so any
+ * non-overlapping layout accounts for every HIT tile.
+ * @param ship: The candidates of each remaining ship.
+ * @param depth: The ship to place next.
+ * @param ships: The number of remaining ships.
+ * @param occupied: The tiles taken by the ships placed so far.
+ * @return The number of layouts of ships [depth, ships).
+ **************************************************************/
+static uint64_t density_Enumerate(CANDIDATES *ship[], int depth, int ships, MASK occupied) {
+    if (depth == ships) {
+        return 1;
+    }
+    CANDIDATES *candidates = ship[depth];
+    uint64_t total = 0;
+    for (int i = 0; i < candidates->count; i++) {
+        MASK mask = candidates->slot[i]->mask;
+        if (!mask_IsEmpty(mask_And(mask, occupied))) {
+            continue;
+        }
+        uint64_t layouts = density_Enumerate(ship, depth+1, ships, mask_Or(occupied, mask));
+        candidates->weight[i] += layouts;
+        total += layouts;
+    }
+    return total;
+}
+
+/**********************************************************//**
+ * @brief Get the probability that each tile holds a ship.
+ * The afloat ships are ordered hit ones first, then fewest
+ * consistent slots first. The leading ships are enumerated
+ * jointly, without overlaps, while the product of their slot
+ * counts stays within DENSITY_JOINT_MAX: all of them when that
+ * is small enough, else a prefix that may hold only some of the
+ * hit ships, or the hit ships and some others. Each ship past
+ * the prefix is weighted evenly over its own consistent slots,
+ * with no check against the others. The per-ship probabilities
+ * of covering each tile are added up.
+ * @param field: The field to score.
+ * @param score: Output parameter for the score of each tile,
+ * indexed by field_GetIndex(x, y).
+ **************************************************************/
+void density_GetScores(const FIELD *field, double score[TURN_MAX]) {
+    for (int i = 0; i < field_GetTileCount(); i++) {
+        score[i] = 0;
+    }
+
+    // Find the slots each afloat ship could be in. Ships we have
+    // hit come first, and within each group the most constrained
+    // ships come first so overlaps prune early.
+    CANDIDATES candidates[N_SHIPS_MAX];
+    int count[N_SHIPS_MAX];
+    for (SHIP s = 0; s < field_GetShipCount(); s++) {
+        if (field_GetShipHealth(field, s) > 0) {
+            candidates[s].count = placement_GetConsistent(field, s, candidates[s].slot);
+            count[s] = candidates[s].count;
+        }
+    }
+    SHIP order[N_SHIPS_MAX];
+    CANDIDATES *ship[N_SHIPS_MAX];
+    int ships = placement_SortShips(field, count, order);
+    for (int s = 0; s < ships; s++) {
+        ship[s] = &candidates[order[s]];
+    }
+
+    // Enumerate the layouts of the leading ships while their
+    // slot counts multiply out within the budget. The remaining
+    // ships are weighted evenly over their own slots.
+    int joint = 0;
+    uint64_t product = 1;
+    while (joint < ships && product*ship[joint]->count <= DENSITY_JOINT_MAX) {
+        product *= ship[joint++]->count;
+    }
+    uint64_t total = 0;
+    if (joint > 0) {
+        for (int s = 0; s < joint; s++) {
+            for (int i = 0; i < ship[s]->count; i++) {
+                ship[s]->weight[i] = 0;
+            }
+        }
+        total = density_Enumerate(ship, 0, joint, mask_Empty());
+    }
+    MASK untried = field_GetMask(field, UNTRIED);
+    for (int s = 0; s < ships; s++) {
+        CANDIDATES *c = ship[s];
+        for (int i = 0; i < c->count; i++) {
+            double weight;
+            if (s < joint && total > 0) {
+                weight = (double)c->weight[i] / (double)total;
+            } else {
+                weight = 1.0 / c->count;
+            }
+            MASK mask = mask_And(c->slot[i]->mask, untried);
+            for (int index = mask_Pop(&mask); index >= 0; index = mask_Pop(&mask)) {
+                score[index] += weight;
+            }
+        }
+    }
+}
+
+/**********************************************************//**
+ * @brief Choose the untried tile most likely to hold a ship.
+ * Ties go to the first tile in x-major order.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+bool density_ChooseTile(const FIELD *field, int *x, int *y) {
+    double score[TURN_MAX];
+    density_GetScores(field, score);
+
+    double scoreMax = -1;
+    int tile = -1;
+    MASK untried = field_GetMask(field, UNTRIED);
+    for (int index = mask_Pop(&untried); index >= 0; index = mask_Pop(&untried)) {
+        if (score[index] > scoreMax) {
+            scoreMax = score[index];
+            tile = index;
+        }
+    }
+    if (tile == -1) {
+        eprintf("No tile left to attack.\n");
+        return false;
+    }
+    *x = tile / field_GetSize();
+    *y = tile % field_GetSize();
+    return true;
+}
+
+/**************************************************************/
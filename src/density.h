@@ -0,0 +1,21 @@
+/**********************************************************//**
+ * @file density.h
+ * @brief Definition of the probability density AI, which
+ * fires where the most placements of the remaining ships are.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _DENSITY_H_
+#define _DENSITY_H_
+
+#include <stdbool.h>
+
+#include "field.h"
+
+/**************************************************************/
+extern void density_GetScores(const FIELD *field, double score[TURN_MAX]);
+extern bool density_ChooseTile(const FIELD *field, int *x, int *y);
+
+/**************************************************************/
+#endif // _DENSITY_H_
@@ -0,0 +1,648 @@
+/**********************************************************//**
+ * @file endgame.c
+ * @brief Implementation of the endgame AI.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail Every layout of the afloat ships consistent with the
+ * field is taken as equally likely. Firing at a tile splits
+ * the layouts by what the field would show: a miss, a hit on
+ * some ship, or some ship sinking on certain tiles. The
+ * expected turns left from a position is then
+ * E = 1 + min over tiles of the sum over outcomes of
+ * P(outcome) * E(position after the outcome),
+ * which is 0 once every ship sank, and the total health left
+ * when a single layout is left. Which layouts are left only
+ * depends on the untried tiles some layout could still have a
+ * ship on, so positions are keyed by those, the hit and sunk
+ * tiles and the ship healths. Positions reached by firing at
+ * the same tiles in another order, or at tiles that only ruled
+ * out layouts already ruled out, share a key, and the solved
+ * ones are kept in the transposition table for the rest of the
+ * game.
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "ai.h"
+#include "debug.h"
+#include "density.h"
+#include "endgame.h"
+#include "field.h"
+#include "mask.h"
+#include "placement.h"
+
+/**************************************************************/
+/// The number of positions searched between checks of the time.
+#define ENDGAME_CLOCK 16
+
+/// The current search budget.
+static ENDGAME Config = {
+    .layouts = ENDGAME_LAYOUTS,
+    .nodes = ENDGAME_NODES,
+    .micros = ENDGAME_MICROS,
+};
+
+/**********************************************************//**
+ * @struct POSITION
+ * @brief What is visible on the field during the search.
+ **************************************************************/
+typedef struct {
+    /// The untried tiles.
+    MASK untried;
+    /// The tiles hit on ships that are still afloat.
+    MASK hit;
+    /// The tiles of the ships sunk during the search.
+    MASK sunk;
+    /// The health of each ship.
+    int health[N_SHIPS_MAX];
+    /// The total health of the ships.
+    int remaining;
+} POSITION;
+
+/**********************************************************//**
+ * @struct SEARCH
+ * @brief The budget of one turn's search. The layouts are in
+ * the state of the game.
+ **************************************************************/
+typedef struct {
+    /// The state of the game.
+    ENDGAME_STATE *state;
+    /// The number of layouts.
+    int count;
+    /// The number of positions searched so far.
+    int nodes;
+    /// The level of the search, which is the frame it uses.
+    int depth;
+    /// Set when the budget ran out; the result is then invalid.
+    bool cutoff;
+    /// The time to stop searching when there is a time budget.
+    struct timespec deadline;
+} SEARCH;
+
+/**********************************************************//**
+ * @brief Set the search budget of the endgame AI. This must be
+ * done before any games start.
+ * @param config: The budget.
+ * @return False if the search can't start with that many
+ * layouts, or a budget is negative.
+ **************************************************************/
+bool endgame_Configure(const ENDGAME *config) {
+    if (config->layouts < 0 || config->layouts > ENDGAME_LAYOUTS_MAX
+    || config->nodes < 0 || config->micros < 0) {
+        return false;
+    }
+    Config = *config;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Start a new game, forgetting the positions solved in
+ * earlier games.
+ * @param state: The state. It must have been zeroed when it
+ * was allocated.
+ **************************************************************/
+void endgame_Init(ENDGAME_STATE *state) {
+    state->generation++;
+    state->turns = -1;
+}
+
+/**********************************************************//**
+ * @brief Spend one position of the budget.
+ * @param search: The search in question.
+ * @return Whether the budget ran out.
+ **************************************************************/
+static inline bool endgame_IsCutoff(SEARCH *search) {
+    if (search->cutoff) {
+        return true;
+    }
+    search->nodes++;
+    if (search->nodes > Config.nodes) {
+        search->cutoff = true;
+    } else if (Config.micros > 0 && search->nodes % ENDGAME_CLOCK == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        search->cutoff = (now.tv_sec > search->deadline.tv_sec)
+            || (now.tv_sec == search->deadline.tv_sec && now.tv_nsec >= search->deadline.tv_nsec);
+    }
+    return search->cutoff;
+}
+
+/**********************************************************//**
+ * @brief Get the hash of a position.
+ * @param position: The position.
+ * @param live: The untried tiles some layout left could still
+ * have a ship on.
+ * @return The hash.
+ **************************************************************/
+static uint64_t endgame_GetKey(const POSITION *position, MASK live) {
+    uint64_t key = UINT64_C(0xCBF29CE484222325);
+    for (int w = 0; w < MASK_WORDS; w++) {
+        key = (key ^ live.word[w]) * UINT64_C(0x100000001B3);
+        key ^= key >> 29;
+        key = (key ^ position->hit.word[w]) * UINT64_C(0x100000001B3);
+        key ^= key >> 29;
+        key = (key ^ position->sunk.word[w]) * UINT64_C(0x100000001B3);
+        key ^= key >> 29;
+    }
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        key = (key ^ (uint64_t)position->health[ship]) * UINT64_C(0x100000001B3);
+        key ^= key >> 29;
+    }
+    return key;
+}
+
+/**********************************************************//**
+ * @brief Find a position's entry in the transposition table.
+ * @param search: The search in question.
+ * @param key: The hash of the position.
+ * @return The only entry the position can be stored in.
+ **************************************************************/
+static inline ENDGAME_ENTRY *endgame_GetEntry(SEARCH *search, uint64_t key) {
+    uint64_t index = (key * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - ENDGAME_TABLE_BITS);
+    return &search->state->entry[index];
+}
+
+/**********************************************************//**
+ * @brief Collect every layout of the afloat ships that doesn't
+ * overlap, from the slots each ship could still be in.
+ * @param search: The search to add the layouts to.
+ * @param ship: The afloat ships, in the order to place them.
+ * @param depth: The ship to place next.
+ * @param ships: The number of afloat ships.
+ * @param layout: The layout so far.
+ * @param occupied: The tiles taken by the ships placed so far.
+ * @return False if there are more layouts than the search may
+ * start with, or the budget ran out.
+ **************************************************************/
+static bool endgame_Enumerate(SEARCH *search, const SHIP ship[], int depth, int ships, ENDGAME_LAYOUT *layout, MASK occupied) {
+    if (depth == ships) {
+        if (search->count == Config.layouts) {
+            return false;
+        }
+        search->state->layout[search->count++] = *layout;
+        return true;
+    }
+    if (endgame_IsCutoff(search)) {
+        return false;
+    }
+    SHIP s = ship[depth];
+    int count;
+    const SLOT *slot = placement_GetSlots(field_GetShipLength(s), &count);
+    for (int i = 0; i < search->state->count[s]; i++) {
+        MASK mask = slot[search->state->slot[s][i]].mask;
+        if (!mask_IsEmpty(mask_And(mask, occupied))) {
+            continue;
+        }
+        layout->ship[s] = mask;
+        if (!endgame_Enumerate(search, ship, depth+1, ships, layout, mask_Or(occupied, mask))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Bring the slots each ship could still be in up to
+ * date. After one more attack only the attacked tile matters:
+ * a ship that was hit must lie on it, and every other ship
+ * can't. Otherwise the slots are found from scratch.
+ * @param state: The state of the game.
+ * @param field: The field in question.
+ **************************************************************/
+static void endgame_Update(ENDGAME_STATE *state, const FIELD *field) {
+    if (state->turns >= 0 && field->turns == state->turns + 1) {
+        int t = field_GetIndex(field->lastAttackX, field->lastAttackY);
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            if (field_GetShipHealth(field, ship) <= 0) {
+                continue;
+            }
+            bool hit = (field_GetShipHealth(field, ship) != state->health[ship]);
+            int count;
+            const SLOT *slot = placement_GetSlots(field_GetShipLength(ship), &count);
+            int kept = 0;
+            for (int i = 0; i < state->count[ship]; i++) {
+                uint16_t index = state->slot[ship][i];
+                state->slot[ship][kept] = index;
+                kept += (mask_Test(&slot[index].mask, t) == hit);
+            }
+            state->count[ship] = kept;
+        }
+    } else if (state->turns != field->turns) {
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            state->count[ship] = 0;
+            if (field_GetShipHealth(field, ship) <= 0) {
+                continue;
+            }
+            const SLOT *consistent[SLOTS_MAX];
+            int count;
+            const SLOT *slot = placement_GetSlots(field_GetShipLength(ship), &count);
+            state->count[ship] = placement_GetConsistent(field, ship, consistent);
+            for (int i = 0; i < state->count[ship]; i++) {
+                state->slot[ship][i] = (uint16_t)(consistent[i] - slot);
+            }
+        }
+    }
+    state->turns = field->turns;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        state->health[ship] = field_GetShipHealth(field, ship);
+    }
+}
+
+/**********************************************************//**
+ * @brief Get a lower bound on the expected number of misses
+ * left. Each turn hits at most cover of the n layouts, so the
+ * first k turns all miss with chance at least 1 - k*cover/n,
+ * and the chances of each turn missing add up.
+ * @param n: The number of layouts.
+ * @param cover: The most layouts any tile has a ship on.
+ * @return The lower bound.
+ **************************************************************/
+static inline double endgame_GetMisses(int n, int cover) {
+    int k = (n - 1) / cover;
+    return k - (double)cover * k * (k + 1) / (2.0 * n);
+}
+
+static double endgame_Solve(SEARCH *search, const POSITION *position, const int member[], int n, double limit, int *tile);
+
+/**********************************************************//**
+ * @brief Get the expected turns left from a position, looking
+ * it up in the transposition table if it was solved before.
+ * @param search: The search in question.
+ * @param position: The position.
+ * @param member: The layouts consistent with the position.
+ * @param n: The number of layouts.
+ * @param limit: Only values below this are of interest.
+ * @return The expected turns left if below limit, or else a
+ * lower bound on them that is at least limit.
+ **************************************************************/
+static double endgame_Expect(SEARCH *search, const POSITION *position, const int member[], int n, double limit) {
+    if (position->remaining == 0) {
+        return 0;
+    }
+    if (n == 1) {
+        // Every tile left to fire at is a hit
+        return position->remaining;
+    }
+    MASK live = mask_Empty();
+    for (int i = 0; i < n; i++) {
+        const ENDGAME_LAYOUT *layout = &search->state->layout[member[i]];
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            if (position->health[ship] > 0) {
+                live = mask_Or(live, layout->ship[ship]);
+            }
+        }
+    }
+    uint64_t key = endgame_GetKey(position, mask_And(live, position->untried));
+    ENDGAME_ENTRY *entry = endgame_GetEntry(search, key);
+    if (entry->generation == search->state->generation && entry->key == key
+    && (entry->exact || entry->turns >= limit)) {
+        return entry->turns;
+    }
+    double turns = endgame_Solve(search, position, member, n, limit, NULL);
+    if (!search->cutoff) {
+        entry->key = key;
+        entry->turns = turns;
+        entry->exact = (turns < limit);
+        entry->generation = search->state->generation;
+    }
+    return turns;
+}
+
+/**********************************************************//**
+ * @brief Get the position after firing at a tile.
+ * @param search: The search in question.
+ * @param position: The position before.
+ * @param t: The tile fired at.
+ * @param code: The outcome: 0 for a miss, 1+ship for a hit,
+ * or above N_SHIPS_MAX for a ship sinking.
+ * @param example: A layout with that outcome.
+ * @param next: Output parameter for the position after.
+ **************************************************************/
+static void endgame_Advance(SEARCH *search, const POSITION *position, int t, int code, int example, POSITION *next) {
+    *next = *position;
+    mask_Reset(&next->untried, t);
+    if (code == 0) {
+        return;
+    }
+    SHIP ship = (code <= N_SHIPS_MAX)? code-1: -1;
+    const ENDGAME_LAYOUT *layout = &search->state->layout[example];
+    if (ship < 0) {
+        // Find the ship that sank
+        ship = 0;
+        while (!mask_Test(&layout->ship[ship], t) || position->health[ship] <= 0) {
+            ship++;
+        }
+    }
+    next->health[ship]--;
+    next->remaining--;
+    mask_Set(&next->hit, t);
+    if (next->health[ship] == 0) {
+        next->hit = mask_AndNot(next->hit, layout->ship[ship]);
+        next->sunk = mask_Or(next->sunk, layout->ship[ship]);
+    }
+}
+
+/**********************************************************//**
+ * @brief Find the tile with the fewest expected turns left from
+ * a position. If some tile has a ship in every layout, it has
+ * to be fired at sooner or later, and firing at it first only
+ * tells more, so it is the only tile tried. Otherwise tiles are
+ * tried most likely hit first. A tile is given up on as soon as
+ * it can't beat the best so far, counting each of its outcomes
+ * not yet solved at its lower bound.
+ * @param search: The search in question.
+ * @param position: The position.
+ * @param member: The layouts consistent with the position.
+ * @param n: The number of layouts (at least 2).
+ * @param limit: Only values below this are of interest.
+ * @param tile: Output parameter for the best tile, or -1 if no
+ * tile is below limit (may be NULL).
+ * @param frame: The working space of this level.
+ * @return The expected turns left if below limit, or else a
+ * lower bound on them that is at least limit.
+ **************************************************************/
+static double endgame_SolveFrame(SEARCH *search, const POSITION *position, const int member[], int n, double limit, int *tile, ENDGAME_FRAME *frame) {
+    if (tile) {
+        *tile = -1;
+    }
+
+    // Count the layouts that have a ship on each tile
+    int *cover = frame->cover;
+    memset(cover, 0, field_GetTileCount()*sizeof(cover[0]));
+    for (int i = 0; i < n; i++) {
+        const ENDGAME_LAYOUT *layout = &search->state->layout[member[i]];
+        MASK fleet = mask_Empty();
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            if (position->health[ship] > 0) {
+                fleet = mask_Or(fleet, layout->ship[ship]);
+            }
+        }
+        fleet = mask_And(fleet, position->untried);
+        for (int index = mask_Pop(&fleet); index >= 0; index = mask_Pop(&fleet)) {
+            cover[index]++;
+        }
+    }
+
+    // Tiles no layout has a ship on would only waste a turn.
+    // Sort the others by cover, ties in x-major order.
+    int *candidate = frame->candidate;
+    int candidates = 0;
+    for (int index = 0; index < field_GetTileCount(); index++) {
+        if (cover[index] == 0) {
+            continue;
+        }
+        int j = candidates++;
+        while (j > 0 && cover[candidate[j-1]] < cover[index]) {
+            candidate[j] = candidate[j-1];
+            j--;
+        }
+        candidate[j] = index;
+    }
+    int coverMax = cover[candidate[0]];
+    double lower = position->remaining + endgame_GetMisses(n, coverMax);
+    if (lower >= limit) {
+        return lower;
+    }
+    if (coverMax == n) {
+        candidates = 1;
+    }
+
+    double best = limit;
+    uint64_t *seen = frame->seen;
+    int seenCount = 0;
+    for (int c = 0; c < candidates; c++) {
+        int t = candidate[c];
+        if (1 + position->remaining - (double)cover[t] / n >= best) {
+            // Every later tile has a lower chance to hit
+            break;
+        }
+        if (endgame_IsCutoff(search)) {
+            break;
+        }
+
+        // Label each layout with the outcome of firing at t: 0 for
+        // a miss, 1+ship for a hit, or 1+N_SHIPS_MAX+i for a ship
+        // sinking where it lies in layout member[i].
+        int *code = frame->code;
+        int *sunk = frame->sunk;
+        SHIP *sunkShip = frame->sunkShip;
+        int sunkCount = 0;
+        int codeMax = 0;
+        for (int i = 0; i < n; i++) {
+            const ENDGAME_LAYOUT *layout = &search->state->layout[member[i]];
+            code[i] = 0;
+            for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+                if (position->health[ship] > 0 && mask_Test(&layout->ship[ship], t)) {
+                    code[i] = 1 + ship;
+                    if (position->health[ship] == 1) {
+                        int s = 0;
+                        while (s < sunkCount && (sunkShip[s] != ship || !mask_IsEmpty(mask_AndNot(
+                        layout->ship[ship], search->state->layout[member[sunk[s]]].ship[ship])))) {
+                            s++;
+                        }
+                        if (s == sunkCount) {
+                            sunkShip[sunkCount] = ship;
+                            sunk[sunkCount++] = i;
+                        }
+                        code[i] = 1 + N_SHIPS_MAX + sunk[s];
+                    }
+                    break;
+                }
+            }
+            codeMax = (code[i] > codeMax)? code[i]: codeMax;
+        }
+
+        // Tiles with the same outcome in every layout only differ
+        // by swapping them, so only the first one is searched
+        uint64_t signature = UINT64_C(0xCBF29CE484222325);
+        for (int i = 0; i < n; i++) {
+            signature = (signature ^ (uint64_t)code[i]) * UINT64_C(0x100000001B3);
+        }
+        int j = 0;
+        while (j < seenCount && seen[j] != signature) {
+            j++;
+        }
+        if (j < seenCount) {
+            continue;
+        }
+        seen[seenCount++] = signature;
+
+        // Group the layouts by outcome, keeping their order
+        int *start = frame->start;
+        memset(start, 0, (codeMax + 2)*sizeof(start[0]));
+        for (int i = 0; i < n; i++) {
+            start[code[i] + 1]++;
+        }
+        for (int k = 1; k <= codeMax + 1; k++) {
+            start[k] += start[k-1];
+        }
+        int *group = frame->group;
+        int *fill = frame->fill;
+        for (int k = 0; k <= codeMax; k++) {
+            fill[k] = start[k];
+        }
+        for (int i = 0; i < n; i++) {
+            group[fill[code[i]]++] = member[i];
+        }
+
+        // The lower bound of each outcome. Only the miss leaves
+        // the health the same.
+        double bound = 1;
+        for (int k = 0; k <= codeMax; k++) {
+            int size = start[k+1] - start[k];
+            if (size == 0) {
+                continue;
+            }
+            int remaining = position->remaining - (k > 0);
+            double lowerNext = (size > 1)? remaining + endgame_GetMisses(size, coverMax): remaining;
+            bound += (double)size / n * lowerNext;
+        }
+
+        // Solve each outcome, until the tile can't be the best.
+        // Each outcome only has to beat what is left of the best
+        // after the bounds of the others.
+        for (int k = 0; k <= codeMax && bound < best; k++) {
+            int size = start[k+1] - start[k];
+            if (size == 0) {
+                continue;
+            }
+            POSITION next;
+            endgame_Advance(search, position, t, k, group[start[k]], &next);
+            double p = (double)size / n;
+            double lowerNext = (size > 1)? next.remaining + endgame_GetMisses(size, coverMax): next.remaining;
+            double limitNext = lowerNext + (best - bound) / p;
+            double expect = endgame_Expect(search, &next, &group[start[k]], size, limitNext);
+            bound += p * (expect - lowerNext);
+        }
+        if (bound < best && !search->cutoff) {
+            best = bound;
+            if (tile) {
+                *tile = t;
+            }
+        }
+    }
+    return best;
+}
+
+/**********************************************************//**
+ * @brief Find the tile with the fewest expected turns left from
+ * a position, like endgame_SolveFrame, on the next level's
+ * working space. Running out of levels counts as running out of
+ * budget.
+ * @param search: The search in question.
+ * @param position: The position.
+ * @param member: The layouts consistent with the position.
+ * @param n: The number of layouts (at least 2).
+ * @param limit: Only values below this are of interest.
+ * @param tile: Output parameter for the best tile, or -1 if no
+ * tile is below limit (may be NULL).
+ * @return The expected turns left if below limit, or else a
+ * lower bound on them that is at least limit.
+ **************************************************************/
+static double endgame_Solve(SEARCH *search, const POSITION *position, const int member[], int n, double limit, int *tile) {
+    if (search->depth == ENDGAME_DEPTH) {
+        search->cutoff = true;
+        if (tile) {
+            *tile = -1;
+        }
+        return limit;
+    }
+    ENDGAME_FRAME *frame = &search->state->frame[search->depth++];
+    double turns = endgame_SolveFrame(search, position, member, n, limit, tile, frame);
+    search->depth--;
+    return turns;
+}
+
+/**********************************************************//**
+ * @brief Choose the tile to attack next. Once few enough fleet
+ * layouts are left, the tile with the fewest expected turns
+ * left is chosen; if the search runs out of budget, the density
+ * AI chooses instead. Before then, the heuristic AI chooses.
+ * @param state: The state of the game.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+bool endgame_ChooseTile(ENDGAME_STATE *state, const FIELD *field, int *x, int *y) {
+    if (Config.layouts <= 0) {
+        return ai_ChooseTile(field, x, y);
+    }
+    endgame_Update(state, field);
+
+    // Only look for the layouts if the slots of the ships multiply
+    // out to few enough. Place the most constrained ships first,
+    // so overlaps prune early.
+    SHIP ship[N_SHIPS_MAX];
+    int ships = 0;
+    uint64_t product = 1;
+    POSITION position;
+    position.untried = field_GetMask(field, UNTRIED);
+    position.hit = field_GetMask(field, HIT);
+    position.sunk = mask_Empty();
+    position.remaining = 0;
+    for (SHIP s = 0; s < field_GetShipCount(); s++) {
+        position.health[s] = field_GetShipHealth(field, s);
+        if (position.health[s] <= 0) {
+            continue;
+        }
+        position.remaining += position.health[s];
+        product *= state->count[s];
+        if (product > (uint64_t)Config.layouts * ENDGAME_SLACK) {
+            return ai_ChooseTile(field, x, y);
+        }
+        int j = ships++;
+        while (j > 0 && state->count[ship[j-1]] > state->count[s]) {
+            ship[j] = ship[j-1];
+            j--;
+        }
+        ship[j] = s;
+    }
+
+    SEARCH search;
+    search.state = state;
+    search.count = 0;
+    search.nodes = 0;
+    search.depth = 0;
+    search.cutoff = false;
+    clock_gettime(CLOCK_MONOTONIC, &search.deadline);
+    search.deadline.tv_sec += Config.micros / 1000000;
+    search.deadline.tv_nsec += (long)(Config.micros % 1000000) * 1000;
+    if (search.deadline.tv_nsec >= 1000000000) {
+        search.deadline.tv_sec++;
+        search.deadline.tv_nsec -= 1000000000;
+    }
+    ENDGAME_LAYOUT layout;
+    if (ships == 0 || !endgame_Enumerate(&search, ship, 0, ships, &layout, mask_Empty())) {
+        return search.cutoff? density_ChooseTile(field, x, y): ai_ChooseTile(field, x, y);
+    }
+
+    // Search the layouts
+    int tile = -1;
+    if (search.count == 1) {
+        // Every tile left of the only layout is a hit
+        MASK left = mask_Empty();
+        for (int i = 0; i < ships; i++) {
+            left = mask_Or(left, state->layout[0].ship[ship[i]]);
+        }
+        left = mask_And(left, position.untried);
+        tile = mask_Pop(&left);
+    } else if (search.count > 1) {
+        int member[ENDGAME_LAYOUTS_MAX];
+        for (int i = 0; i < search.count; i++) {
+            member[i] = i;
+        }
+        endgame_Solve(&search, &position, member, search.count, (double)TURN_MAX + 1, &tile);
+    }
+    if (search.cutoff || tile < 0) {
+        return density_ChooseTile(field, x, y);
+    }
+    *x = tile / field_GetSize();
+    *y = tile % field_GetSize();
+    return true;
+}
+
+/**************************************************************/
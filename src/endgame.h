@@ -0,0 +1,146 @@
+/**********************************************************//**
+ * @file endgame.h
+ * @brief Definition of the endgame AI. It plays like the
+ * heuristic AI until few enough fleet layouts are consistent
+ * with the field, then searches them exactly for the tile that
+ * minimizes the expected number of turns left.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _ENDGAME_H_
+#define _ENDGAME_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "field.h"
+#include "mask.h"
+#include "placement.h"
+
+/**************************************************************/
+/// The default most layouts left for the search to start.
+#define ENDGAME_LAYOUTS 16
+
+/// The most layouts left the search can ever start with.
+#define ENDGAME_LAYOUTS_MAX 256
+
+/// The default most positions to search per turn.
+#define ENDGAME_NODES 4000
+
+/// The default most microseconds to search per turn.
+#define ENDGAME_MICROS 20
+
+/// The deepest the search may go, in turns ahead.
+#define ENDGAME_DEPTH 64
+
+/// The transposition table has 2^ENDGAME_TABLE_BITS entries.
+#define ENDGAME_TABLE_BITS 13
+
+/// @brief How many times more layouts than the most the search
+/// may start with can be checked for, when the slots of each
+/// ship multiply out to that many.
+#define ENDGAME_SLACK 16
+
+/**********************************************************//**
+ * @struct ENDGAME
+ * @brief When the endgame search starts and how much work it
+ * may do per turn. A turn whose search runs out of budget is
+ * played by the density AI instead.
+ **************************************************************/
+typedef struct {
+    /// @brief Search once at most this many layouts are left
+    /// (0 never searches).
+    int layouts;
+    /// The most positions to search per turn.
+    int nodes;
+    /// The most microseconds to search per turn (0 for none).
+    int micros;
+} ENDGAME;
+
+/**********************************************************//**
+ * @struct ENDGAME_ENTRY
+ * @brief One solved position of the transposition table.
+ **************************************************************/
+typedef struct {
+    /// The hash of the position.
+    uint64_t key;
+    /// @brief The expected number of turns left from the
+    /// position, or a lower bound on them.
+    double turns;
+    /// The game the entry was stored in.
+    uint32_t generation;
+    /// Whether turns is exact rather than a lower bound.
+    bool exact;
+} ENDGAME_ENTRY;
+
+/**********************************************************//**
+ * @struct ENDGAME_LAYOUT
+ * @brief Where each afloat ship lies in one consistent layout.
+ **************************************************************/
+typedef struct {
+    MASK ship[N_SHIPS_MAX];
+} ENDGAME_LAYOUT;
+
+/**********************************************************//**
+ * @struct ENDGAME_FRAME
+ * @brief The working space of one level of the search.
+ **************************************************************/
+typedef struct {
+    /// The number of layouts with a ship on each tile.
+    int cover[TURN_MAX];
+    /// The tiles to try, most covered first.
+    int candidate[TURN_MAX];
+    /// The outcomes of the tiles tried, to skip the same ones.
+    uint64_t seen[TURN_MAX];
+    /// The outcome of firing at the tile in each layout.
+    int code[ENDGAME_LAYOUTS_MAX];
+    /// The first layout each sinking outcome was found in.
+    int sunk[ENDGAME_LAYOUTS_MAX];
+    /// The ship that sinks in each sinking outcome.
+    SHIP sunkShip[ENDGAME_LAYOUTS_MAX];
+    /// The layouts grouped by outcome.
+    int group[ENDGAME_LAYOUTS_MAX];
+    /// Where each outcome's layouts start in group.
+    int start[1 + N_SHIPS_MAX + ENDGAME_LAYOUTS_MAX + 1];
+    /// Where the next layout of each outcome goes in group.
+    int fill[1 + N_SHIPS_MAX + ENDGAME_LAYOUTS_MAX];
+} ENDGAME_FRAME;
+
+/**********************************************************//**
+ * @struct ENDGAME_STATE
+ * @brief The per-game state of the endgame AI. The slots each
+ * ship could still be in are narrowed down by each turn's
+ * attack, and solved positions are kept in a fixed size
+ * transposition table, so memory is bounded. Entries of earlier
+ * games are told apart by their generation, so a new game
+ * doesn't have to clear the table. The layouts and the working
+ * space of each level of the search are kept here too, so the
+ * search doesn't grow the stack.
+ **************************************************************/
+typedef struct {
+    /// The current game, counting from 1.
+    uint32_t generation;
+    /// The turn the slots are up to date for, or -1 for none.
+    int turns;
+    /// The health of each ship on that turn.
+    int health[N_SHIPS_MAX];
+    /// The number of slots each ship could still be in.
+    int count[N_SHIPS_MAX];
+    /// The slots each ship could still be in, by their index.
+    uint16_t slot[N_SHIPS_MAX][SLOTS_MAX];
+    /// The solved positions.
+    ENDGAME_ENTRY entry[1 << ENDGAME_TABLE_BITS];
+    /// Every layout consistent with the field on this turn.
+    ENDGAME_LAYOUT layout[ENDGAME_LAYOUTS_MAX];
+    /// The working space of each level of the search.
+    ENDGAME_FRAME frame[ENDGAME_DEPTH];
+} ENDGAME_STATE;
+
+/**************************************************************/
+extern bool endgame_Configure(const ENDGAME *config);
+extern void endgame_Init(ENDGAME_STATE *state);
+extern bool endgame_ChooseTile(ENDGAME_STATE *state, const FIELD *field, int *x, int *y);
+
+/**************************************************************/
+#endif // _ENDGAME_H_
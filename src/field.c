@@ -6,55 +6,192 @@
  **************************************************************/
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "debug.h"
 #include "field.h"
+#include "mask.h"
+#include "placement.h"
+#include "rng.h"
+#include "stats.h"
 
 /**********************************************************//**
- * @brief Converts a VIEW direction to a 2D vector.
- * @param view: The viewing direction.
- * @param di: Output parameter for the x coordinate.
- * @param dj: Output parameter for the y coordinate.
+ * @brief Change the status of one tile, keeping both mask
+ * orientations up to date.
+ * @param field: The field to modify.
+ * @param x: The x-coordinate of the tile.
+ * @param y: The y-coordinate of the tile.
+ * @param from: The current status of the tile.
+ * @param to: The new status of the tile.
+ * @param size: The size of the field.
  **************************************************************/
-static inline void view_GetVector(VIEW view, int *di, int *dj) {
-    switch (view) {
-    case LEFT:
-        *di = -1;
-        *dj = 0;
-        break;
-    case RIGHT:
-        *di = 1;
-        *dj = 0;
-        break;
-    case UP:
-        *di = 0;
-        *dj = -1;
-        break;
-    case DOWN:
-        *di = 0;
-        *dj = 1;
-        break;
-    default:
-        break;
+static inline __attribute__((always_inline))
+void field_SetStatus(FIELD *field, int x, int y, STATUS from, STATUS to, int size) {
+    int index = x*size + y;
+    int transpose = y*size + x;
+    mask_Reset(&field->status[from], index);
+    mask_Reset(&field->transpose[from], transpose);
+    mask_Set(&field->status[to], index);
+    mask_Set(&field->transpose[to], transpose);
+}
+
+/**************************************************************/
+/// @brief The fleets that can be played with. The standard
+/// fleet is from the Hasbro game; the salvo fleet is the ten
+/// ship fleet of the pencil and paper game.
+static const FLEET Fleets[] = {
+    {
+        .name = "standard",
+        .ships = 5,
+        .length = {5, 4, 3, 3, 2},
+        .shipName = {"Carrier", "Battleship", "Submarine", "Cruiser", "Destroyer"},
+    },
+    {
+        .name = "salvo",
+        .ships = 10,
+        .length = {4, 3, 3, 2, 2, 2, 1, 1, 1, 1},
+        .shipName = {
+            "Battleship", "Cruiser1", "Cruiser2", "Destroyer1", "Destroyer2",
+            "Destroyer3", "Submarine1", "Submarine2", "Submarine3", "Submarine4",
+        },
+    },
+};
+
+/// The configured rules; the standard game until configured.
+RULES FieldRules = {
+    .size = FIELD_SIZE_DEFAULT,
+    .tiles = FIELD_SIZE_DEFAULT*FIELD_SIZE_DEFAULT,
+    .fleet = &Fleets[0],
+};
+
+/**********************************************************//**
+ * @brief Get one of the fleets.
+ * @param i: The index of the fleet; 0 is the standard fleet.
+ * @return The fleet, or NULL past the last one.
+ **************************************************************/
+const FLEET *field_GetFleet(int i) {
+    if (i < 0 || i >= (int)(sizeof(Fleets)/sizeof(Fleets[0]))) {
+        return NULL;
+    }
+    return &Fleets[i];
+}
+
+/**********************************************************//**
+ * @brief Find a fleet by name.
+ * @param name: The name of the fleet.
+ * @return The fleet, or NULL if there is none by that name.
+ **************************************************************/
+const FLEET *field_FindFleet(const char *name) {
+    for (int i = 0; field_GetFleet(i); i++) {
+        if (!strcmp(field_GetFleet(i)->name, name)) {
+            return field_GetFleet(i);
+        }
+    }
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Set the board size and fleet of every field. This
+ * must be done before any field is set up, and before any
+ * other thread starts.
+ * @param size: The size of the field square in tiles.
+ * @param fleet: The fleet.
+ * @return Whether the fleet can be played on a field of that
+ * size. The rules are left alone if not.
+ **************************************************************/
+bool field_Configure(int size, const FLEET *fleet) {
+    if (size < FIELD_SIZE_MIN || size > FIELD_SIZE_MAX) {
+        eprintf("Field size %d is not in [%d, %d].\n", size, FIELD_SIZE_MIN, FIELD_SIZE_MAX);
+        return false;
+    }
+    if (fleet->ships < 1 || fleet->ships > N_SHIPS_MAX) {
+        eprintf("A fleet of %d ships is not supported.\n", fleet->ships);
+        return false;
+    }
+
+    // Leave plenty of room so random fleets always fit
+    int tiles = 0;
+    for (int i = 0; i < fleet->ships; i++) {
+        if (fleet->length[i] < 1 || fleet->length[i] > size) {
+            eprintf("A ship of length %d doesn't fit.\n", fleet->length[i]);
+            return false;
+        }
+        tiles += fleet->length[i];
+    }
+    if (2*tiles > size*size) {
+        eprintf("The fleet covers more than half of the field.\n");
+        return false;
+    }
+    if (!placement_Configure(size)) {
+        return false;
+    }
+    FieldRules.size = size;
+    FieldRules.tiles = size*size;
+    FieldRules.fleet = fleet;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Recompute one run table along one line of tiles.
+ * @param field: The field to update.
+ * @param status: The status of the runs (UNTRIED or HIT).
+ * @param x: The x-coordinate of a tile on the line.
+ * @param y: The y-coordinate of a tile on the line.
+ * @param vertical: Whether the line is the column through the
+ * tile (true) or the row through the tile (false).
+ * @param size: The size of the field.
+ **************************************************************/
+static inline __attribute__((always_inline))
+void field_UpdateLine(FIELD *field, STATUS status, int x, int y, bool vertical, int size) {
+    // Get the line out of the bitboard, and the tables to fill.
+    // Position i on the line is the tile at (x, i) or (i, y).
+    int run = (status == HIT);
+    uint32_t line;
+    uint8_t *back;
+    uint8_t *ahead;
+    int stride;
+    if (vertical) {
+        line = mask_GetBits(&field->status[status], x*size, size);
+        back = &field->run[run][UP][x][0];
+        ahead = &field->run[run][DOWN][x][0];
+        stride = 1;
+    } else {
+        line = mask_GetBits(&field->transpose[status], y*size, size);
+        back = &field->run[run][LEFT][0][y];
+        ahead = &field->run[run][RIGHT][0][y];
+        stride = FIELD_SIZE_MAX;
+    }
+
+    // Runs looking back grow forwards along the line, and
+    // runs looking ahead grow backwards along the line.
+    int length = 0;
+    for (int i = 0; i < size; i++) {
+        length = ((line >> i) & 1)? length+1: 0;
+        back[i*stride] = length;
+    }
+    length = 0;
+    for (int i = size-1; i >= 0; i--) {
+        length = ((line >> i) & 1)? length+1: 0;
+        ahead[i*stride] = length;
     }
 }
 
 /**********************************************************//**
- * @brief Get the length of the given ship.
- * @param ship: The ship to check.
- * @return The length of the ship.
+ * @brief Recompute one run table along the row and the column
+ * through a tile.
+ * @param field: The field to update.
+ * @param status: The status of the runs (UNTRIED or HIT).
+ * @param x: The x-coordinate of the tile.
+ * @param y: The y-coordinate of the tile.
+ * @param size: The size of the field.
  **************************************************************/
-int field_GetShipLength(SHIP ship) {
-    static const int length[N_SHIPS] = {
-        [CARRIER]    = 5,
-        [BATTLESHIP] = 4,
-        [SUBMARINE]  = 3,
-        [CRUISER]    = 3,
-        [DESTROYER]  = 2,
-    };
-    return length[ship];
+static inline __attribute__((always_inline))
+void field_UpdateCross(FIELD *field, STATUS status, int x, int y, int size) {
+    field_UpdateLine(field, status, x, y, true, size);
+    field_UpdateLine(field, status, x, y, false, size);
 }
 
 /**********************************************************//**
@@ -65,19 +202,29 @@ int field_GetShipLength(SHIP ship) {
  **************************************************************/
 void field_Clear(FIELD *field) {
     // Set all entries to null
-    for (int i = 0; i < FIELD_SIZE; i++) {
-        for (int j = 0; j < FIELD_SIZE; j++) {
-            field->entry[i][j].status = FREE;
-            field->entry[i][j].ship = EMPTY;
-        }
+    for (STATUS status = 0; status < N_STATUS; status++) {
+        field->status[status] = mask_Empty();
+        field->transpose[status] = mask_Empty();
     }
+    field->status[FREE] = mask_Fill(field_GetTileCount());
+    field->transpose[FREE] = mask_Fill(field_GetTileCount());
+    for (SHIP ship = 0; ship < N_SHIPS_MAX; ship++) {
+        field->ship[ship] = mask_Empty();
+        field->placement[ship].x = -1;
+        field->placement[ship].y = -1;
+        field->placement[ship].view = RIGHT;
+        field->placement[ship].length = 0;
+    }
+    field->fleet = mask_Empty();
+    memset(field->run, 0, sizeof(field->run));
+
     // Set all ship health to empty
-    for (int i = 0; i < N_SHIPS; i++) {
+    for (int i = 0; i < N_SHIPS_MAX; i++) {
         field->health[i] = -1;
     }
     // Reset the turn counts
     field->turns = 0;
-    for (int i = 0; i < N_SHIPS; i++) {
+    for (int i = 0; i < N_SHIPS_MAX; i++) {
         field->sinkTurn[i] = TURN_INVALID;
     }
     
@@ -87,138 +234,208 @@ void field_Clear(FIELD *field) {
 }
 
 /**********************************************************//**
- * @brief Get the amount of equal statuses in the VIEW
- * direction from the origin point. This goes along the unit
- * vector of the direction from (x, y) until it is out of
- * bounds or reaches an entry with a different status.
- * @param field: The field to get information from.
- * @param dir: The view direction to look in.
- * @param x: The x-coordinate of the origin.
- * @param y: The y-coordinate of the origin.
- * @param status: The status of squares to check.
- * @return The distance travelled.
+ * @brief Places a ship on the field. The tile statuses are
+ * left alone; the caller finalizes them once the whole fleet
+ * is placed.
+ * @param field: The field to modify.
+ * @param ship: The ship to place.
+ * @param slot: Where to place the ship. It must not overlap
+ * any ship already placed.
  **************************************************************/
-int field_GetExtent(const FIELD *field, VIEW dir, int x, int y, STATUS status) {
-    // Get the distance from x, y to an obstruction on the field
-    if (!field_IsInBounds(x, y)) {
-        // Error, not in bounds whatsoever
-        return 0;
-    }
-
-    // Get the directions
-    int distance = 0;
-    int di = 0;
-    int dj = 0;
-    view_GetVector(dir, &di, &dj);
-
-    // Get horizontal distance to an obstruction (tile without the same status)
-    int i = x;
-    int j = y;
-    while (field_IsInBounds(i, j) && (status == field->entry[i][j].status)) {
-        i += di;
-        j += dj;
-        distance++;
-    }
-    return distance;
+static void field_PlaceShip(FIELD *field, SHIP ship, const SLOT *slot) {
+    assert(mask_IsEmpty(mask_And(field->fleet, slot->mask)));
+    field->ship[ship] = slot->mask;
+    field->fleet = mask_Or(field->fleet, slot->mask);
+    field->placement[ship] = slot->placement;
+
+    // Write initial ship HP
+    field->health[ship] = slot->placement.length;
 }
 
 /**********************************************************//**
- * @brief Places a ship on the field.
- * @param field: The field to modify.
- * @param view: The viewing direction.
- * @param x: The x-coordinate of the ship's upper left corner.
- * @param y: The y-coordinate of the ship's upper left corner.
- * @param ship: The ship to place.
- * @return True if the ship could be placed.
+ * @brief Finishes setting up the field once the whole fleet
+ * is placed: every tile becomes UNTRIED.
+ * @param field: The field to finalize.
+ * @param size: The size of the field.
  **************************************************************/
-static bool field_PlaceShip(FIELD *field, VIEW view, int x, int y, SHIP ship) {
-    // Put a ship on the field
-    int length = field_GetShipLength(ship);
-    if (field_GetExtent(field, view, x, y, FREE) < length) {
-        // Can't place the ship here but not an error
-        return false;
+static inline __attribute__((always_inline))
+void field_FinalizeSized(FIELD *field, int size) {
+    // Make all statuses UNTRIED, finalizing the field
+    for (STATUS status = 0; status < N_STATUS; status++) {
+        field->status[status] = mask_Empty();
+        field->transpose[status] = mask_Empty();
     }
+    field->status[UNTRIED] = mask_Fill(size*size);
+    field->transpose[UNTRIED] = mask_Fill(size*size);
 
-    // Get the viewing vector
-    int di = 0;
-    int dj = 0;
-    view_GetVector(view, &di, &dj);
+    // Now that the statuses are final, fill the run tables
+    for (int i = 0; i < size; i++) {
+        field_UpdateCross(field, UNTRIED, i, i, size);
+        field_UpdateCross(field, HIT, i, i, size);
+    }
+}
 
-    // Write ship into array
-    int i = x;
-    int j = y;
-    int distance = 0;
-    while (distance < length) {
-        // Ensure valid coordinates are here
-        if (field->entry[i][j].ship != EMPTY) {
-            eprintf("Ship erroneously placed at the location.\n");
-            return false;
+/**********************************************************//**
+ * @brief Finishes setting up the field once the whole fleet
+ * is placed, on a field of the configured size.
+ * @param field: The field to finalize.
+ **************************************************************/
+static void field_Finalize(FIELD *field) {
+    field_FinalizeSized(field, field_GetSize());
+}
+
+/**********************************************************//**
+ * @brief Places all the ships randomly on the field. Each ship
+ * in turn picks uniformly among the precomputed slots that
+ * don't overlap the ships placed before it. The slots each
+ * ship still to place can't take are kept up to date as the
+ * ships are placed, from the slots covering each tile, so no
+ * ship scans the whole slot table. On a crowded field the
+ * ships placed first may leave no room for a later one, and
+ * then the whole fleet is placed again.
+ * @param field: The field to set up.
+ * @param rng: The random number stream to draw positions from.
+ * @param size: The size of the field.
+ **************************************************************/
+static inline __attribute__((always_inline))
+void field_CreateRandomSized(FIELD *field, RNG *rng, int size) {
+    int ships = field_GetShipCount();
+    const SLOT *slot[N_SHIPS_MAX];
+    const SLOT_SET *covering[N_SHIPS_MAX];
+    int count[N_SHIPS_MAX];
+    for (SHIP ship = 0; ship < ships; ship++) {
+        slot[ship] = placement_GetSlots(field_GetShipLength(ship), &count[ship]);
+        covering[ship] = placement_GetCovering(field_GetShipLength(ship));
+    }
+
+    // The slots of each ship that overlap the ships placed
+    SLOT_SET taken[N_SHIPS_MAX];
+    memset(taken, 0, sizeof(taken));
+    SHIP ship = 0;
+    while (ship < ships) {
+        // Count the slots left; the bits past the last slot are
+        // never free.
+        int words = (count[ship] + 63) / 64;
+        uint64_t free[SLOT_WORDS];
+        int fitCount = 0;
+        for (int w = 0; w < words; w++) {
+            free[w] = ~taken[ship].word[w];
+            if (w == words-1 && count[ship] % 64) {
+                free[w] &= (UINT64_C(1) << (count[ship] % 64)) - 1;
+            }
+            fitCount += __builtin_popcountll(free[w]);
+        }
+        if (fitCount == 0) {
+            STATS_ADD(retries, 1);
+            field->fleet = mask_Empty();
+            memset(taken, 0, sizeof(taken));
+            ship = 0;
+            continue;
+        }
+
+        // Find the chosen slot left, in slot order
+        int pick = rng_Range(rng, fitCount);
+        int w = 0;
+        while (pick >= __builtin_popcountll(free[w])) {
+            pick -= __builtin_popcountll(free[w++]);
+        }
+        uint64_t bits = free[w];
+        while (pick--) {
+            bits &= bits - 1;
         }
+        const SLOT *chosen = &slot[ship][64*w + __builtin_ctzll(bits)];
+        field_PlaceShip(field, ship, chosen);
 
-        // Write the ship element
-        field->entry[i][j].ship = ship;
-        field->entry[i][j].status = UNTRIED;
-        distance++;
-        i += di;
-        j += dj;
+        // Rule out the slots of the later ships on its tiles
+        MASK tiles = chosen->mask;
+        for (int tile = mask_Pop(&tiles); tile >= 0; tile = mask_Pop(&tiles)) {
+            for (SHIP later = ship+1; later < ships; later++) {
+                const SLOT_SET *cover = &covering[later][tile];
+                for (int v = 0; v < (count[later] + 63) / 64; v++) {
+                    taken[later].word[v] |= cover->word[v];
+                }
+            }
+        }
+        ship++;
     }
+    field_FinalizeSized(field, size);
+}
 
-    // Write initial ship HP
-    field->health[ship] = length;
-    return true;
+/**********************************************************//**
+ * @brief Places all the ships randomly on the field. The
+ * common field sizes have their own copies of the placement
+ * loop; other sizes share a generic one.
+ * @param field: The field to set up.
+ * @param rng: The random number stream to draw positions from.
+ **************************************************************/
+void field_CreateRandom(FIELD *field, RNG *rng) {
+    switch (field_GetSize()) {
+    case 8:
+        field_CreateRandomSized(field, rng, 8);
+        break;
+    case 10:
+        field_CreateRandomSized(field, rng, 10);
+        break;
+    case 12:
+        field_CreateRandomSized(field, rng, 12);
+        break;
+    case 16:
+        field_CreateRandomSized(field, rng, 16);
+        break;
+    default:
+        field_CreateRandomSized(field, rng, field_GetSize());
+        break;
+    }
 }
 
 /**********************************************************//**
- * @brief Places all the ships randomly on the field.
+ * @brief Places all the ships on the field where given, such
+ * as a fleet read back from a game log.
  * @param field: The field to set up.
+ * @param placement: Where each ship lies.
+ * @return Whether every ship is in bounds and no ships overlap.
  **************************************************************/
-void field_CreateRandom(FIELD *field) {
-    for (SHIP ship = 0; ship < N_SHIPS; ship++) {
-        int length = field_GetShipLength(ship);
-
-        // Generate positions until we find one that works
-        // We ban any position where the ship will extend
-        // off of the board. Hence, the top left corner is referred
-        // to as an "anchor" point. If the ship points right, the
-        // leftmost part of the ship can't be more than thr anchor.
-        // If the ship points down, the topmost part of the ship
-        // can't be more than the anchor.
-        int anchor = (FIELD_SIZE - length + 1);
-
-        // Randomly generate anchor points until we find a place that
-        // works. An anchor point doesn't work if it causes ships to
-        // overlap or extend off the board.
-        VIEW view;
-        int x;
-        int y;
-        do {
-            // Pick if the ship is horizontal or vertical.
-            view = (rand() % 2)? RIGHT: DOWN;
-            // Generate random position for the view.
-            switch (view) {
-            case RIGHT:
-                x = rand()%anchor;
-                y = rand()%FIELD_SIZE;
-                break;
-            
-            case DOWN:
-                x = rand()%FIELD_SIZE;
-                y = rand()%anchor;
-                break;
-            
-            default:
-                eprintf("This can't happen.\n");
-                break;
+bool field_CreateFleet(FIELD *field, const PLACEMENT placement[N_SHIPS_MAX]) {
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        SLOT slot = {
+            .mask = mask_Empty(),
+            .placement = placement[ship],
+        };
+        VIEW view = slot.placement.view;
+        if (slot.placement.length != field_GetShipLength(ship) || (view != RIGHT && view != DOWN)) {
+            eprintf("Invalid placement of ship %d.\n", ship);
+            return false;
+        }
+        for (int i = 0; i < slot.placement.length; i++) {
+            int x = slot.placement.x + ((view == RIGHT)? i: 0);
+            int y = slot.placement.y + ((view == DOWN)? i: 0);
+            if (!field_IsInBounds(x, y)) {
+                eprintf("Ship %d is out of bounds.\n", ship);
+                return false;
             }
-        } while (!field_PlaceShip(field, view, x, y, ship));
+            mask_Set(&slot.mask, field_GetIndex(x, y));
+        }
+        if (!mask_IsEmpty(mask_And(slot.mask, field->fleet))) {
+            eprintf("Ship %d overlaps another ship.\n", ship);
+            return false;
+        }
+        field_PlaceShip(field, ship, &slot);
     }
+    field_Finalize(field);
+    return true;
+}
 
-    // Make all statuses UNTRIED, finalizing the field
-    for (int x = 0; x < FIELD_SIZE; x++) {
-        for (int y = 0; y < FIELD_SIZE; y++) {
-            field->entry[x][y].status = UNTRIED;
-        }
+/**********************************************************//**
+ * @brief Sets up a field where the whole fleet is afloat but
+ * lies nowhere, so every attack misses. This is what an agent
+ * sees of any field before its first hit.
+ * @param field: The field to set up.
+ **************************************************************/
+void field_CreateHidden(FIELD *field) {
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        field->health[ship] = field_GetShipLength(ship);
     }
+    field_Finalize(field);
 }
 
 /**********************************************************//**
@@ -226,14 +443,18 @@ void field_CreateRandom(FIELD *field) {
  * @param field: The field to attack.
  * @param x: The x-coordinate to attack.
  * @param y: The y-coordinate to attack.
+ * @param size: The size of the field.
  * @return The result of the attack or -1 on failure.
  **************************************************************/
-STATUS field_Attack(FIELD *field, int x, int y) {
+static inline __attribute__((always_inline))
+STATUS field_AttackSized(FIELD *field, int x, int y, int size) {
     // Error check the input
-    if (!field_IsInBounds(x, y)) {
+    if (!field_IsInBoundsSized(x, y, size)) {
         eprintf("Attack out of bounds.\n");
         return ERROR;
-    } else if (field->entry[x][y].status != UNTRIED) {
+    }
+    int index = x*size + y;
+    if (!mask_Test(&field->status[UNTRIED], index)) {
         eprintf("Already attacked that location.\n");
         return ERROR;
     }
@@ -242,61 +463,187 @@ STATUS field_Attack(FIELD *field, int x, int y) {
     field->turns++;
     field->lastAttackX = x;
     field->lastAttackY = y;
-    SHIP ship = field->entry[x][y].ship;
-    if (ship != EMPTY) {
+    if (mask_Test(&field->fleet, index)) {
         // The attack struck a ship
-        field->entry[x][y].status = HIT;
+        SHIP ship = 0;
+        while (!mask_Test(&field->ship[ship], index)) {
+            ship++;
+        }
+        field_SetStatus(field, x, y, UNTRIED, HIT, size);
+        field_UpdateCross(field, UNTRIED, x, y, size);
         field->health[ship]--;
 
         // Check if the ship sank. If it did, mark the
         // entire ship with SUNK status.
         if (field->health[ship] <= 0) {
-            for (int x = 0; x < FIELD_SIZE; x++) {
-                for (int y = 0; y < FIELD_SIZE; y++) {
-                    if (field->entry[x][y].ship == ship) {
-                        field->entry[x][y].status = SUNK;
-                    }
-                }
+            // Only the ship's own tiles are visited.
+            const PLACEMENT *placement = field_GetPlacement(field, ship);
+            for (int i = 0; i < placement->length; i++) {
+                int shipX;
+                int shipY;
+                field_GetShipTile(field, ship, i, &shipX, &shipY);
+                field_SetStatus(field, shipX, shipY, HIT, SUNK, size);
+            }
+
+            // Only the HIT runs changed: along the ship once,
+            // and across it at each of its tiles.
+            bool vertical = (placement->view == DOWN);
+            field_UpdateLine(field, HIT, placement->x, placement->y, vertical, size);
+            for (int i = 0; i < placement->length; i++) {
+                int shipX;
+                int shipY;
+                field_GetShipTile(field, ship, i, &shipX, &shipY);
+                field_UpdateLine(field, HIT, shipX, shipY, !vertical, size);
             }
             // Register the sink turn.
             field->sinkTurn[ship] = field->turns;
+            STATS_ADD(attacks[SUNK], 1);
             return SUNK;
         } else {
             // The ship didn't sink
+            field_UpdateCross(field, HIT, x, y, size);
+            STATS_ADD(attacks[HIT], 1);
             return HIT;
         }
     } else {
         // The attack missed any ship
-        field->entry[x][y].status = MISS;
+        field_SetStatus(field, x, y, UNTRIED, MISS, size);
+        field_UpdateCross(field, UNTRIED, x, y, size);
+        STATS_ADD(attacks[MISS], 1);
         return MISS;
     }
 }
 
 /**********************************************************//**
- * @brief Check if the field has been won.
- * @param field: The field to check.
- * @return Whether the field is complete or not.
+ * @brief Make an attack on the field. The common field sizes
+ * have their own copies of the attack, with the size known at
+ * compile time; other sizes share a generic one.
+ * @param field: The field to attack.
+ * @param x: The x-coordinate to attack.
+ * @param y: The y-coordinate to attack.
+ * @return The result of the attack or -1 on failure.
  **************************************************************/
-bool field_IsWon(const FIELD *field) {
-    for (SHIP ship = 0; ship < N_SHIPS; ship++) {
-        if (field->health[ship] > 0) {
+STATUS field_Attack(FIELD *field, int x, int y) {
+    switch (field_GetSize()) {
+    case 8:
+        return field_AttackSized(field, x, y, 8);
+    case 10:
+        return field_AttackSized(field, x, y, 10);
+    case 12:
+        return field_AttackSized(field, x, y, 12);
+    case 16:
+        return field_AttackSized(field, x, y, 16);
+    default:
+        return field_AttackSized(field, x, y, field_GetSize());
+    }
+}
+
+/**********************************************************//**
+ * @brief Record the result of an attack that an opponent
+ * reported, on a field set up with field_CreateHidden. Until a
+ * ship sinks, an agent can't tell which ship a hit belongs to,
+ * so only sinking a ship changes the fleet's health. The ship
+ * that sank must lie along a row or column of hits through the
+ * tile. If the opponent doesn't say where, and more than one
+ * way fits, the first one in slot order is taken, which can be
+ * wrong when ships touch.
+ * @param field: The field to record the attack on.
+ * @param x: The x-coordinate attacked.
+ * @param y: The y-coordinate attacked.
+ * @param result: MISS, HIT or SUNK.
+ * @param ship: The ship that sank, for SUNK.
+ * @param placement: Where the ship that sank lay, or NULL if the
+ * opponent didn't say.
+ * @return Whether the result fits what is known of the field.
+ **************************************************************/
+bool field_Report(FIELD *field, int x, int y, STATUS result, SHIP ship, const PLACEMENT *placement) {
+    int size = field_GetSize();
+    if (!field_IsInBounds(x, y) || field_GetStatus(field, x, y) != UNTRIED) {
+        eprintf("Already attacked that location.\n");
+        return false;
+    }
+    if (result == SUNK && (ship < 0 || ship >= field_GetShipCount() || field->health[ship] <= 0)) {
+        eprintf("No such ship is afloat.\n");
+        return false;
+    }
+    if (result != MISS && result != HIT && result != SUNK) {
+        eprintf("Invalid result.\n");
+        return false;
+    }
+
+    // Find where the ship that sank lies before changing
+    // anything: its tiles are all hits but the attacked one.
+    SLOT found;
+    if (result == SUNK) {
+        int count;
+        const SLOT *slot = placement_GetSlots(field_GetShipLength(ship), &count);
+        MASK hits = field_GetMask(field, HIT);
+        mask_Set(&hits, field_GetIndex(x, y));
+        int i = 0;
+        while (i < count && (!mask_Test(&slot[i].mask, field_GetIndex(x, y))
+        || !mask_IsEmpty(mask_AndNot(slot[i].mask, hits))
+        || (placement && (slot[i].placement.x != placement->x || slot[i].placement.y != placement->y
+        || slot[i].placement.view != placement->view)))) {
+            i++;
+        }
+        if (i == count) {
+            eprintf("The ship can't have sunk there.\n");
             return false;
         }
+        found = slot[i];
+    }
+
+    // Register the turn and attack
+    field->turns++;
+    field->lastAttackX = x;
+    field->lastAttackY = y;
+    field_SetStatus(field, x, y, UNTRIED, (result == MISS)? MISS: HIT, size);
+    field_UpdateCross(field, UNTRIED, x, y, size);
+    if (result == MISS) {
+        return true;
+    }
+    if (result == HIT) {
+        field_UpdateCross(field, HIT, x, y, size);
+        return true;
+    }
+
+    // The ship sank: it is where it was found
+    field_PlaceShip(field, ship, &found);
+    field->health[ship] = 0;
+    field->sinkTurn[ship] = field->turns;
+    const PLACEMENT *sunk = &found.placement;
+    bool vertical = (sunk->view == DOWN);
+    for (int i = 0; i < sunk->length; i++) {
+        field_SetStatus(field, sunk->x + (vertical? 0: i), sunk->y + (vertical? i: 0), HIT, SUNK, size);
+    }
+    field_UpdateLine(field, HIT, sunk->x, sunk->y, vertical, size);
+    for (int i = 0; i < sunk->length; i++) {
+        field_UpdateLine(field, HIT, sunk->x + (vertical? 0: i), sunk->y + (vertical? i: 0), !vertical, size);
     }
     return true;
 }
 
+/**********************************************************//**
+ * @brief Check if the field has been won.
+ * @param field: The field to check.
+ * @return Whether the field is complete or not.
+ **************************************************************/
+bool field_IsWon(const FIELD *field) {
+    // Won once every tile of every ship is SUNK
+    return mask_IsEmpty(mask_AndNot(field->fleet, field->status[SUNK]));
+}
+
 /**********************************************************//**
  * @brief Prints the field using ASCII characters.
  * @param field: Field to output.
  * @param file:  Open file to output the field into.
  **************************************************************/
 void field_Print(const FIELD *field, FILE *file) {
-    for (int y=0; y<FIELD_SIZE; y++) {
-        for (int x=0; x<FIELD_SIZE; x++) {
+    for (int y=0; y<field_GetSize(); y++) {
+        for (int x=0; x<field_GetSize(); x++) {
             bool isLastAttack = x==field->lastAttackX && y==field->lastAttackY;
             fprintf(file, isLastAttack? "[": " ");
-            switch (field->entry[x][y].status) {
+            switch (field_GetStatus(field, x, y)) {
             case HIT:
             case SUNK:
                 fprintf(file, "O");
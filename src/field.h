@@ -10,29 +10,43 @@
 #define _FIELD_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
+#include "mask.h"
+#include "rng.h"
+
 /**************************************************************/
-/// @brief The total number of ships possible on the board
-/// (from the standard Hasbro game). We have one carrier, one
-/// battleship, one submarine, one cruiser, and one destroyer.
-#define N_SHIPS 5
+/// @brief The most ships a fleet can have.
+#define N_SHIPS_MAX 10
+
+/// The smallest field size in tiles.
+#define FIELD_SIZE_MIN 4
+
+/// The largest field size in tiles.
+#define FIELD_SIZE_MAX 16
 
 /// @brief The size of the field square in tiles (from standard
-/// Hasbro game).
-#define FIELD_SIZE 10
+/// Hasbro game), used unless another size is configured.
+#define FIELD_SIZE_DEFAULT 10
 
-/// @brief The maximum number of turns possible (the same as the
-/// number of different tiles on the field).
-#define TURN_MAX (FIELD_SIZE*FIELD_SIZE)
+/// @brief The maximum number of turns possible on any field
+/// (the same as the number of different tiles on the largest
+/// field). Arrays indexed by tile use this size.
+#define TURN_MAX (FIELD_SIZE_MAX*FIELD_SIZE_MAX)
 
 /// @brief Denotes an invalid sink turn.
 #define TURN_INVALID -1
 
+#if TURN_MAX > MASK_BITS
+#error "The field doesn't fit in a MASK."
+#endif
+
 /**********************************************************//**
  * @enum SHIP
  * @brief Enumerates all possuble battleships as well as the
- * empty square.
+ * empty square. A SHIP indexes the configured fleet; these are
+ * the ships of the standard fleet.
  **************************************************************/
 typedef enum {
     EMPTY      = -1,
@@ -63,45 +77,171 @@ typedef enum {
     SUNK,
 } STATUS;
 
+/// @brief The number of STATUS values (the size of arrays
+/// indexed by STATUS).
+#define N_STATUS (SUNK+1)
+
+/**********************************************************//**
+ * @enum VIEW
+ * @brief Enumerates all possible viewing directions from a
+ * given tile on the field. We can look left, right, up, and
+ * down (although special cases happen on edge tiles).
+ **************************************************************/
+typedef enum {
+    LEFT,
+    RIGHT,
+    UP,
+    DOWN,
+} VIEW;
+
+/// The number of VIEW directions.
+#define N_VIEWS (DOWN+1)
+
 /**********************************************************//**
- * @struct ENTRY
- * @brief Stores data for one tile on the game field.
+ * @struct PLACEMENT
+ * @brief Where a ship lies on the field.
  **************************************************************/
 typedef struct {
-    STATUS status;
-    SHIP ship;
-} ENTRY;
+    /// The x-coordinate of the ship's upper left corner.
+    int x;
+    /// The y-coordinate of the ship's upper left corner.
+    int y;
+    /// The direction the ship extends in (RIGHT or DOWN).
+    VIEW view;
+    /// The length of the ship (0 if it isn't placed).
+    int length;
+} PLACEMENT;
+
+/**********************************************************//**
+ * @struct FLEET
+ * @brief The ships a game is played with.
+ **************************************************************/
+typedef struct {
+    /// The name of the fleet, for -F.
+    const char *name;
+    /// The number of ships.
+    int ships;
+    /// The length of each ship, longest first.
+    int length[N_SHIPS_MAX];
+    /// The name of each ship.
+    const char *shipName[N_SHIPS_MAX];
+} FLEET;
+
+/**********************************************************//**
+ * @struct RULES
+ * @brief The board size and fleet of every field. They are set
+ * once by field_Configure, before any games start.
+ **************************************************************/
+typedef struct {
+    /// The size of the field square in tiles.
+    int size;
+    /// The number of tiles on the field.
+    int tiles;
+    /// The fleet.
+    const FLEET *fleet;
+} RULES;
+
+/// The configured rules.
+extern RULES FieldRules;
+
+/// @brief The number of statuses whose extents are kept in
+/// tables: UNTRIED and HIT.
+#define N_RUNS 2
 
 /**********************************************************//**
  * @struct FIELD
- * @brief Stores all game board information.
+ * @brief Stores all game board information. Tiles are stored
+ * as bitboards: each STATUS and each ship has a MASK of the
+ * tiles it applies to.
  **************************************************************/
 typedef struct {
-    ENTRY entry[FIELD_SIZE][FIELD_SIZE];
+    /// @brief The tiles with each status, indexed by
+    /// field_GetIndex(x, y), so each column is contiguous.
+    MASK status[N_STATUS];
+    /// @brief The same masks transposed, indexed by
+    /// field_GetIndex(y, x), so each row is contiguous.
+    MASK transpose[N_STATUS];
+    /// The tiles occupied by each ship.
+    MASK ship[N_SHIPS_MAX];
+    /// Where each ship lies, for walking its tiles in order.
+    PLACEMENT placement[N_SHIPS_MAX];
+    /// The tiles occupied by any ship.
+    MASK fleet;
     /// The health of each ship (health 0 means the ship sank).
-    int health[N_SHIPS];
+    int health[N_SHIPS_MAX];
     /// Turns taken on the field by whichever agent is playing.
     int turns;
     /// @brief Administrative logging data for when a ship sank.
     /// It will be TURN_INVALID if the ship didn't sink yet.
-    int sinkTurn[N_SHIPS];
+    int sinkTurn[N_SHIPS_MAX];
     // Where the last attack was.
     int lastAttackX;
     int lastAttackY;
+    /// @brief The extent of the UNTRIED (0) and HIT (1) runs
+    /// through each tile in each direction, as returned by
+    /// field_GetExtent. field_Attack updates the row and column
+    /// of each tile it changes.
+    uint8_t run[N_RUNS][N_VIEWS][FIELD_SIZE_MAX][FIELD_SIZE_MAX];
 } FIELD;
 
+// The counters need the sizes above.
+#include "stats.h"
+
 /**********************************************************//**
- * @enum VIEW
- * @brief Enumerates all possible viewing directions from a
- * given tile on the field. We can look left, right, up, and
- * down (although special cases happen on edge tiles).
+ * @brief Get the size of the field square.
+ * @return The number of tiles along each side of the field.
  **************************************************************/
-typedef enum {
-    LEFT,
-    RIGHT,
-    UP,
-    DOWN,
-} VIEW;
+static inline int field_GetSize(void) {
+    return FieldRules.size;
+}
+
+/**********************************************************//**
+ * @brief Get the number of tiles on the field.
+ * @return The number of tiles, and the most turns a game can
+ * take.
+ **************************************************************/
+static inline int field_GetTileCount(void) {
+    return FieldRules.tiles;
+}
+
+/**********************************************************//**
+ * @brief Get the number of ships in the fleet.
+ * @return The number of ships.
+ **************************************************************/
+static inline int field_GetShipCount(void) {
+    return FieldRules.fleet->ships;
+}
+
+/**********************************************************//**
+ * @brief Get the length of the given ship.
+ * @param ship: The ship to check.
+ * @return The length of the ship.
+ **************************************************************/
+static inline int field_GetShipLength(SHIP ship) {
+    return FieldRules.fleet->length[ship];
+}
+
+/**********************************************************//**
+ * @brief Get the name of the given ship.
+ * @param ship: The ship to check.
+ * @return The name of the ship.
+ **************************************************************/
+static inline const char *field_GetShipName(SHIP ship) {
+    return FieldRules.fleet->shipName[ship];
+}
+
+/**********************************************************//**
+ * @brief Check if the coordinates are in bounds of a field of
+ * the given size. Kernels specialized for one size pass it as
+ * a constant.
+ * @param x: The x-coordinate to check.
+ * @param y: The y-coordinate to check.
+ * @param size: The size of the field.
+ * @return Whether the location is in bounds.
+ **************************************************************/
+static inline bool field_IsInBoundsSized(int x, int y, int size) {
+    return ((unsigned)x < (unsigned)size) && ((unsigned)y < (unsigned)size);
+}
 
 /**********************************************************//**
  * @brief Check if the coordinates are in bounds.
@@ -110,7 +250,27 @@ typedef enum {
  * @return Whether the location is in bounds.
  **************************************************************/
 static inline bool field_IsInBounds(int x, int y) {
-    return ((0 <= x) && (x < FIELD_SIZE)) && ((0 <= y) && (y < FIELD_SIZE));
+    return field_IsInBoundsSized(x, y, field_GetSize());
+}
+
+/**********************************************************//**
+ * @brief Get the bit index of a tile in the field masks.
+ * @param x: The x-coordinate of the tile.
+ * @param y: The y-coordinate of the tile.
+ * @return The bit index.
+ **************************************************************/
+static inline int field_GetIndex(int x, int y) {
+    return x*field_GetSize() + y;
+}
+
+/**********************************************************//**
+ * @brief Get the mask of tiles with the given status.
+ * @param field: The field in question.
+ * @param status: The status to look for.
+ * @return The mask of tiles, indexed by field_GetIndex(x, y).
+ **************************************************************/
+static inline MASK field_GetMask(const FIELD *field, STATUS status) {
+    return field->status[status];
 }
 
 /**********************************************************//**
@@ -121,7 +281,90 @@ static inline bool field_IsInBounds(int x, int y) {
  * @return The tile status.
  **************************************************************/
 static inline STATUS field_GetStatus(const FIELD *field, int x, int y) {
-    return field->entry[x][y].status;
+    int index = field_GetIndex(x, y);
+    for (STATUS status = FREE; status < N_STATUS; status++) {
+        if (mask_Test(&field->status[status], index)) {
+            return status;
+        }
+    }
+    return ERROR;
+}
+
+/**********************************************************//**
+ * @brief Get the amount of equal statuses in the VIEW
+ * direction from the origin point. This goes along the unit
+ * vector of the direction from (x, y) until it is out of
+ * bounds or reaches an entry with a different status. UNTRIED
+ * and HIT runs are looked up in the run tables; other runs are
+ * read straight out of the status bitboard.
+ * @param field: The field to get information from.
+ * @param dir: The view direction to look in.
+ * @param x: The x-coordinate of the origin.
+ * @param y: The y-coordinate of the origin.
+ * @param status: The status of squares to check.
+ * @param size: The size of the field.
+ * @return The distance travelled.
+ **************************************************************/
+static inline __attribute__((always_inline))
+int field_GetExtentSized(const FIELD *field, VIEW dir, int x, int y, STATUS status, int size) {
+    STATS_ADD(extents, 1);
+
+    // Get the distance from x, y to an obstruction on the field
+    if (!field_IsInBoundsSized(x, y, size) || status <= ERROR || status >= N_STATUS) {
+        // Error, not in bounds whatsoever
+        return 0;
+    }
+
+    // The runs the AI looks at are tabulated
+    if (status == UNTRIED) {
+        return field->run[0][dir][x][y];
+    } else if (status == HIT) {
+        return field->run[1][dir][x][y];
+    }
+
+    // Get the line through the tile in the viewing direction. A
+    // column is contiguous in the mask, and a row is contiguous
+    // in the transposed mask.
+    uint32_t line;
+    int position;
+    switch (dir) {
+    case UP:
+    case DOWN:
+        line = mask_GetBits(&field->status[status], x*size, size);
+        position = y;
+        break;
+
+    case LEFT:
+    case RIGHT:
+        line = mask_GetBits(&field->transpose[status], y*size, size);
+        position = x;
+        break;
+
+    default:
+        return 0;
+    }
+
+    // Count the run of set bits starting at the tile. The bits
+    // past either end of the line are clear, which ends the run.
+    if (dir == DOWN || dir == RIGHT) {
+        return __builtin_ctz(~(line >> position));
+    } else {
+        return __builtin_clz(~(line << (31 - position)));
+    }
+}
+
+/**********************************************************//**
+ * @brief Get the amount of equal statuses in the VIEW
+ * direction from the origin point; see field_GetExtentSized.
+ * @param field: The field to get information from.
+ * @param dir: The view direction to look in.
+ * @param x: The x-coordinate of the origin.
+ * @param y: The y-coordinate of the origin.
+ * @param status: The status of squares to check.
+ * @return The distance travelled.
+ **************************************************************/
+static inline int field_GetExtent(const FIELD *field, VIEW dir, int x, int y, STATUS status) {
+    return field_GetExtentSized(field, dir, x, y, status, field_GetSize());
 }
 
 /**********************************************************//**
@@ -134,6 +377,31 @@ static inline int field_GetShipHealth(const FIELD *field, SHIP ship) {
     return field->health[ship];
 }
 
+/**********************************************************//**
+ * @brief Get where a ship lies on the field.
+ * @param field: The field to check.
+ * @param ship: The ship to check.
+ * @return The placement of the ship.
+ **************************************************************/
+static inline const PLACEMENT *field_GetPlacement(const FIELD *field, SHIP ship) {
+    return &field->placement[ship];
+}
+
+/**********************************************************//**
+ * @brief Get one of the tiles a ship occupies.
+ * @param field: The field to check.
+ * @param ship: The ship to check.
+ * @param i: Which tile of the ship, counting from its upper
+ * left corner (less than the ship length).
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ **************************************************************/
+static inline void field_GetShipTile(const FIELD *field, SHIP ship, int i, int *x, int *y) {
+    const PLACEMENT *placement = &field->placement[ship];
+    *x = placement->x + ((placement->view == RIGHT)? i: 0);
+    *y = placement->y + ((placement->view == DOWN)? i: 0);
+}
+
 /**********************************************************//**
  * @brief Get the turn count on the given field.
  * @param field: The field in question.
@@ -155,11 +423,15 @@ static inline int field_GetSinkTurn(const FIELD *field, SHIP ship) {
 }
 
 /**************************************************************/
+extern const FLEET *field_GetFleet(int i);
+extern const FLEET *field_FindFleet(const char *name);
+extern bool field_Configure(int size, const FLEET *fleet);
 extern void field_Clear(FIELD *field);
-extern int field_GetShipLength(SHIP ship);
-extern void field_CreateRandom(FIELD *field);
-extern int field_GetExtent(const FIELD *field, VIEW dir, int x, int y, STATUS status);
+extern void field_CreateRandom(FIELD *field, RNG *rng);
+extern bool field_CreateFleet(FIELD *field, const PLACEMENT placement[N_SHIPS_MAX]);
+extern void field_CreateHidden(FIELD *field);
 extern STATUS field_Attack(FIELD *field, int x, int y);
+extern bool field_Report(FIELD *field, int x, int y, STATUS result, SHIP ship, const PLACEMENT *placement);
 extern bool field_IsWon(const FIELD *field);
 extern void field_Print(const FIELD *field, FILE *file);
 
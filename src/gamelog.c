@@ -0,0 +1,456 @@
+/**********************************************************//**
+ * @file gamelog.c
+ * @brief Implementation of the binary game log.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail The file is laid out as, with all integers little
+ * endian:
+ * - Header (32 bytes): "BSLG", version, field size, number of
+ *   ships, 0, seed (u64), then the fleet name, zero padded.
+ * - Each game: one byte per ship holding the index of its
+ *   first tile, plus 0x80 if it lies DOWN; one byte with the
+ *   turn count; one byte per turn holding the tile attacked.
+ *   Tiles are indexed by field_GetIndex. On fields of more
+ *   than 128 tiles, the ship entries (with 0x8000 for DOWN)
+ *   and the turn count take two bytes instead.
+ * - Index: the file offset of every GAMELOG_STRIDE-th game
+ *   (u64), starting with the first. A game is found by going
+ *   to the entry before it and skipping the records between.
+ * - Trailer: index offset (u64), game count (u64), "BSIX".
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "binary.h"
+#include "field.h"
+#include "gamelog.h"
+
+/**************************************************************/
+/// The format version written in the header.
+#define GAMELOG_VERSION 4
+
+/// The size of the header in bytes.
+#define GAMELOG_HEADER 32
+
+/// Where the fleet name starts in the header.
+#define GAMELOG_NAME 16
+
+/// The size of the trailer in bytes.
+#define GAMELOG_TRAILER 20
+
+/// Flag on a ship byte for ships that lie DOWN.
+#define GAMELOG_DOWN 0x80
+
+/// Games per entry of the index.
+#define GAMELOG_STRIDE 64
+
+#if TURN_MAX > UINT8_MAX+1 || GAMELOG_NAME + GAMELOG_NAME_MAX > GAMELOG_HEADER
+#error "Moves don't fit in one byte of the game log."
+#endif
+
+/**********************************************************//**
+ * @brief Get how many bytes the ship entries and turn count
+ * of each game take on the configured field.
+ * @return 1 while tiles and the DOWN flag fit in a byte, else 2.
+ **************************************************************/
+static inline int gamelog_GetWidth(void) {
+    return (field_GetTileCount() > GAMELOG_DOWN)? 2: 1;
+}
+
+/**********************************************************//**
+ * @brief Get the number of entries in the index of a log.
+ * @param games: The number of games in the log.
+ * @return One entry for each GAMELOG_STRIDE games begun.
+ **************************************************************/
+static inline uint64_t gamelog_GetEntries(uint64_t games) {
+    return games/GAMELOG_STRIDE + (games%GAMELOG_STRIDE != 0);
+}
+
+/**********************************************************//**
+ * @brief Get the turn count from the start of a game's record,
+ * to skip over the game.
+ * @param record: The record.
+ * @return The number of turns in the game.
+ **************************************************************/
+static inline int gamelog_GetTurns(const unsigned char *record) {
+    int width = gamelog_GetWidth();
+    return (int)binary_Get(&record[width*field_GetShipCount()], width);
+}
+
+/**********************************************************//**
+ * @brief Decode the fleet and turn count at the start of a
+ * game's record.
+ * @param record: The record.
+ * @param fleet: Output parameter for where each ship started.
+ * @return The number of turns in the game.
+ **************************************************************/
+static int gamelog_Decode(const unsigned char *record, PLACEMENT fleet[N_SHIPS_MAX]) {
+    int width = gamelog_GetWidth();
+    int ships = field_GetShipCount();
+    int down = GAMELOG_DOWN << (8*(width-1));
+    for (SHIP ship = 0; ship < ships; ship++) {
+        int entry = (int)binary_Get(&record[width*ship], width);
+        int tile = entry & ~down;
+        fleet[ship].x = tile / field_GetSize();
+        fleet[ship].y = tile % field_GetSize();
+        fleet[ship].view = (entry & down)? DOWN: RIGHT;
+        fleet[ship].length = field_GetShipLength(ship);
+    }
+    return gamelog_GetTurns(record);
+}
+
+/**********************************************************//**
+ * @brief Start writing a game log.
+ * @param log: The log to set up.
+ * @param file: The file to write to, opened in binary mode.
+ * @param seed: The seed of the run.
+ * @return Whether the header was written.
+ **************************************************************/
+bool gamelog_Create(GAMELOG *log, FILE *file, uint64_t seed) {
+    log->file = file;
+    log->seed = seed;
+    log->size = field_GetSize();
+    log->games = 0;
+    log->offset = NULL;
+    log->capacity = 0;
+    log->index = 0;
+
+    const char *name = FieldRules.fleet->name;
+    if (strlen(name) >= GAMELOG_NAME_MAX) {
+        fprintf(stderr, "The fleet name \"%s\" is too long.\n", name);
+        return false;
+    }
+    strcpy(log->fleet, name);
+    unsigned char header[GAMELOG_HEADER] = {
+        'B', 'S', 'L', 'G', GAMELOG_VERSION, (unsigned char)field_GetSize(),
+        (unsigned char)field_GetShipCount(), 0
+    };
+    binary_Put(&header[8], seed, 8);
+    memcpy(&header[GAMELOG_NAME], name, strlen(name));
+    log->position = GAMELOG_HEADER;
+    return fwrite(header, GAMELOG_HEADER, 1, file) == 1;
+}
+
+/**********************************************************//**
+ * @brief Add the game about to be written to the index, if it
+ * starts a stride.
+ * @param log: The log being written.
+ * @return Whether the index had room.
+ **************************************************************/
+static bool gamelog_Index(GAMELOG *log) {
+    if (log->games % GAMELOG_STRIDE) {
+        return true;
+    }
+    uint64_t entry = log->games / GAMELOG_STRIDE;
+    if (entry == log->capacity) {
+        uint64_t capacity = log->capacity? 2*log->capacity: 1024;
+        uint64_t *offset = (capacity <= SIZE_MAX/sizeof(uint64_t))? realloc(log->offset, capacity*sizeof(uint64_t)): NULL;
+        if (!offset) {
+            fprintf(stderr, "Failed to grow the game log index.\n");
+            return false;
+        }
+        log->offset = offset;
+        log->capacity = capacity;
+    }
+    log->offset[entry] = log->position;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Append one game to the log.
+ * @param log: The log to write to.
+ * @param fleet: Where each ship started.
+ * @param turns: The number of turns in the game.
+ * @param move: The tile attacked on each turn, as
+ * field_GetIndex(x, y).
+ * @return Whether the game was written.
+ **************************************************************/
+bool gamelog_Write(GAMELOG *log, const PLACEMENT fleet[N_SHIPS_MAX], int turns, const unsigned char move[]) {
+    if (!gamelog_Index(log)) {
+        return false;
+    }
+    log->games++;
+
+    unsigned char record[2*(N_SHIPS_MAX + 1) + TURN_MAX];
+    int width = gamelog_GetWidth();
+    int ships = field_GetShipCount();
+    for (SHIP ship = 0; ship < ships; ship++) {
+        int tile = field_GetIndex(fleet[ship].x, fleet[ship].y);
+        int down = (fleet[ship].view == DOWN)? GAMELOG_DOWN << (8*(width-1)): 0;
+        binary_Put(&record[width*ship], (uint64_t)(tile | down), width);
+    }
+    binary_Put(&record[width*ships], (uint64_t)turns, width);
+    memcpy(&record[width*(ships + 1)], move, turns);
+    size_t size = width*(ships + 1) + turns;
+    log->position += size;
+    return fwrite(record, size, 1, log->file) == 1;
+}
+
+/**********************************************************//**
+ * @brief Continue writing a game log that an earlier run
+ * started. The index of the games already in the file is
+ * rebuilt by walking their records; anything after them is
+ * left to be written over.
+ * @param log: The log to set up.
+ * @param file: The file to write to, opened for update in
+ * binary mode.
+ * @param seed: The seed of the run.
+ * @param games: The number of games already in the file.
+ * @param position: The file offset where those games end.
+ * @return Whether the file holds those games of this run.
+ **************************************************************/
+bool gamelog_Resume(GAMELOG *log, FILE *file, uint64_t seed, uint64_t games, uint64_t position) {
+    log->file = file;
+    log->seed = seed;
+    log->size = field_GetSize();
+    log->games = 0;
+    log->offset = NULL;
+    log->capacity = 0;
+    log->index = 0;
+    strncpy(log->fleet, FieldRules.fleet->name, GAMELOG_NAME_MAX-1);
+    log->fleet[GAMELOG_NAME_MAX-1] = '\0';
+
+    unsigned char header[GAMELOG_HEADER];
+    if (fseek(file, 0, SEEK_SET) || fread(header, GAMELOG_HEADER, 1, file) != 1
+    || memcmp(header, "BSLG", 4) || header[4] != GAMELOG_VERSION || header[5] != field_GetSize()
+    || header[6] != field_GetShipCount() || binary_Get(&header[8], 8) != seed
+    || strncmp((const char *)&header[GAMELOG_NAME], log->fleet, GAMELOG_NAME_MAX)) {
+        fprintf(stderr, "The game log is for another run.\n");
+        return false;
+    }
+    // Walk the records: each is a fleet, a turn count and moves
+    unsigned char record[2*(N_SHIPS_MAX + 1) + TURN_MAX];
+    PLACEMENT fleet[N_SHIPS_MAX];
+    size_t head = gamelog_GetWidth()*(field_GetShipCount() + 1);
+    log->position = GAMELOG_HEADER;
+    while (log->games < games) {
+        if (fread(record, head, 1, file) != 1) {
+            break;
+        }
+        int turns = gamelog_Decode(record, fleet);
+        if (turns > TURN_MAX || fread(&record[head], 1, turns, file) != (size_t)turns) {
+            break;
+        }
+        if (!gamelog_Index(log)) {
+            return false;
+        }
+        log->games++;
+        log->position += head + turns;
+    }
+    if (log->games != games || log->position != position || fseeko(file, (off_t)position, SEEK_SET)) {
+        fprintf(stderr, "The game log doesn't hold the games of the checkpoint.\n");
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Finish writing a game log by writing the index. The
+ * file itself is left open.
+ * @param log: The log to finish.
+ * @return Whether the index was written.
+ **************************************************************/
+bool gamelog_Finish(GAMELOG *log) {
+    bool success = true;
+    unsigned char entry[8];
+    for (uint64_t i = 0; success && i < gamelog_GetEntries(log->games); i++) {
+        binary_Put(entry, log->offset[i], 8);
+        success = (fwrite(entry, 8, 1, log->file) == 1);
+    }
+    unsigned char trailer[GAMELOG_TRAILER];
+    binary_Put(&trailer[0], log->position, 8);
+    binary_Put(&trailer[8], log->games, 8);
+    memcpy(&trailer[16], "BSIX", 4);
+    success = success && (fwrite(trailer, GAMELOG_TRAILER, 1, log->file) == 1);
+
+    free(log->offset);
+    log->offset = NULL;
+    log->capacity = 0;
+    return success;
+}
+
+/**********************************************************//**
+ * @brief Open a finished game log for reading.
+ * @param log: The log to set up.
+ * @param file: The file to read from, opened in binary mode.
+ * @return Whether the file is a complete game log. Its field
+ * size and fleet are read from the header; the rules must be
+ * configured to match before reading any games.
+ **************************************************************/
+bool gamelog_Open(GAMELOG *log, FILE *file) {
+    log->file = file;
+    log->offset = NULL;
+    log->capacity = 0;
+    log->position = 0;
+
+    unsigned char header[GAMELOG_HEADER];
+    if (fseek(file, 0, SEEK_SET) || fread(header, GAMELOG_HEADER, 1, file) != 1) {
+        fprintf(stderr, "Failed to read the game log header.\n");
+        return false;
+    }
+    if (memcmp(header, "BSLG", 4) || header[4] != GAMELOG_VERSION
+    || header[6] > N_SHIPS_MAX || header[GAMELOG_NAME + GAMELOG_NAME_MAX - 1] != '\0') {
+        fprintf(stderr, "Not a game log.\n");
+        return false;
+    }
+    log->size = header[5];
+    log->seed = binary_Get(&header[8], 8);
+    memcpy(log->fleet, &header[GAMELOG_NAME], GAMELOG_NAME_MAX);
+
+    unsigned char trailer[GAMELOG_TRAILER];
+    if (fseek(file, -GAMELOG_TRAILER, SEEK_END) || fread(trailer, GAMELOG_TRAILER, 1, file) != 1
+    || memcmp(&trailer[16], "BSIX", 4)) {
+        fprintf(stderr, "The game log has no index; it was not finished.\n");
+        return false;
+    }
+    log->index = binary_Get(&trailer[0], 8);
+    log->games = binary_Get(&trailer[8], 8);
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Read one game from the log.
+ * @param log: The log to read from.
+ * @param game: The index of the game, starting at 0.
+ * @param fleet: Output parameter for where each ship started.
+ * @param move: Output parameter for the tile attacked on each
+ * turn, as field_GetIndex(x, y).
+ * @return The number of turns in the game, or -1 on failure.
+ **************************************************************/
+int gamelog_Read(GAMELOG *log, uint64_t game, PLACEMENT fleet[N_SHIPS_MAX], unsigned char move[TURN_MAX]) {
+    if (log->size != field_GetSize() || strcmp(log->fleet, FieldRules.fleet->name)) {
+        fprintf(stderr, "The game log was played by other rules.\n");
+        return -1;
+    }
+    if (game >= log->games) {
+        fprintf(stderr, "Game %llu is not in the log.\n", (unsigned long long)game+1);
+        return -1;
+    }
+
+    // Find the nearest game before it in the index
+    unsigned char entry[8];
+    if (fseeko(log->file, (off_t)(log->index + 8*(game/GAMELOG_STRIDE)), SEEK_SET)
+    || fread(entry, 8, 1, log->file) != 1) {
+        fprintf(stderr, "Failed to read the game log index.\n");
+        return -1;
+    }
+
+    // Skip the games in between, then read the fleet and the
+    // turn count, then the moves
+    unsigned char record[2*(N_SHIPS_MAX + 1)];
+    size_t head = gamelog_GetWidth()*(field_GetShipCount() + 1);
+    bool found = !fseeko(log->file, (off_t)binary_Get(entry, 8), SEEK_SET);
+    for (uint64_t skip = game % GAMELOG_STRIDE; found && skip > 0; skip--) {
+        found = (fread(record, head, 1, log->file) == 1)
+            && !fseeko(log->file, (off_t)gamelog_GetTurns(record), SEEK_CUR);
+    }
+    if (!found || fread(record, head, 1, log->file) != 1) {
+        fprintf(stderr, "Failed to read game %llu.\n", (unsigned long long)game+1);
+        return -1;
+    }
+    int turns = gamelog_Decode(record, fleet);
+    if (turns > TURN_MAX || fread(move, 1, turns, log->file) != (size_t)turns) {
+        fprintf(stderr, "Failed to read the moves of game %llu.\n", (unsigned long long)game+1);
+        return -1;
+    }
+    return turns;
+}
+
+/**********************************************************//**
+ * @brief Map a finished game log into memory.
+ * @param map: Output parameter for the mapped log.
+ * @param filename: The file to map.
+ * @return Whether the file is a complete game log. Its field
+ * size and fleet are read from the header; the rules must be
+ * configured to match before getting any games.
+ **************************************************************/
+bool gamelog_Map(GAMELOG_MAP *map, const char *filename) {
+    memset(map, 0, sizeof(GAMELOG_MAP));
+    map->base = binary_MapFile(filename, &map->size);
+    if (!map->base) {
+        fprintf(stderr, "Failed to map \"%s\".\n", filename);
+        return false;
+    }
+
+    const unsigned char *header = map->base;
+    if (map->size < GAMELOG_HEADER + GAMELOG_TRAILER || memcmp(header, "BSLG", 4)
+    || header[4] != GAMELOG_VERSION || header[6] > N_SHIPS_MAX
+    || header[GAMELOG_NAME + GAMELOG_NAME_MAX - 1] != '\0') {
+        fprintf(stderr, "Not a game log.\n");
+        gamelog_Unmap(map);
+        return false;
+    }
+    map->fieldSize = header[5];
+    map->seed = binary_Get(&header[8], 8);
+    memcpy(map->fleet, &header[GAMELOG_NAME], GAMELOG_NAME_MAX);
+
+    const unsigned char *trailer = header + map->size - GAMELOG_TRAILER;
+    uint64_t index = binary_Get(&trailer[0], 8);
+    map->games = binary_Get(&trailer[8], 8);
+    uint64_t indexSize = map->size - GAMELOG_TRAILER - index;
+    if (memcmp(&trailer[16], "BSIX", 4) || index > map->size - GAMELOG_TRAILER
+    || indexSize % 8 || indexSize / 8 != gamelog_GetEntries(map->games)) {
+        fprintf(stderr, "The game log has no index; it was not finished.\n");
+        gamelog_Unmap(map);
+        return false;
+    }
+    map->index = header + index;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Get one game from a mapped log.
+ * @param map: The mapped log.
+ * @param game: The index of the game, starting at 0.
+ * @param fleet: Output parameter for where each ship started.
+ * @param move: Output parameter for the tile attacked on each
+ * turn, as field_GetIndex(x, y), pointing into the mapping.
+ * @return The number of turns in the game, or -1 on failure.
+ **************************************************************/
+int gamelog_GetGame(const GAMELOG_MAP *map, uint64_t game, PLACEMENT fleet[N_SHIPS_MAX], const unsigned char **move) {
+    if (map->fieldSize != field_GetSize() || strcmp(map->fleet, FieldRules.fleet->name)) {
+        fprintf(stderr, "The game log was played by other rules.\n");
+        return -1;
+    }
+    if (game >= map->games) {
+        fprintf(stderr, "Game %llu is not in the log.\n", (unsigned long long)game+1);
+        return -1;
+    }
+    // The games end where the index starts. Skip from the
+    // nearest game before it in the index.
+    const unsigned char *base = map->base;
+    uint64_t end = (uint64_t)(map->index - base);
+    uint64_t offset = binary_Get(&map->index[8*(game/GAMELOG_STRIDE)], 8);
+    size_t head = gamelog_GetWidth()*(field_GetShipCount() + 1);
+    for (uint64_t skip = game % GAMELOG_STRIDE; skip > 0 && offset >= GAMELOG_HEADER && offset + head <= end; skip--) {
+        offset += head + gamelog_GetTurns(base + offset);
+    }
+    if (offset < GAMELOG_HEADER || offset + head > end) {
+        fprintf(stderr, "Failed to read game %llu.\n", (unsigned long long)game+1);
+        return -1;
+    }
+    int turns = gamelog_Decode(base + offset, fleet);
+    if (turns > TURN_MAX || offset + head + turns > end) {
+        fprintf(stderr, "Failed to read the moves of game %llu.\n", (unsigned long long)game+1);
+        return -1;
+    }
+    *move = base + offset + head;
+    return turns;
+}
+
+/**********************************************************//**
+ * @brief Unmap a game log.
+ * @param map: The mapped log.
+ **************************************************************/
+void gamelog_Unmap(GAMELOG_MAP *map) {
+    binary_UnmapFile(map->base, map->size);
+    map->base = NULL;
+    map->size = 0;
+}
+
+/**************************************************************/
@@ -0,0 +1,85 @@
+/**********************************************************//**
+ * @file gamelog.h
+ * @brief Compact binary game log. Each game is stored as its
+ * starting fleet and its moves, a few dozen bytes. A trailing
+ * index of every 64th game finds any game by skipping at most
+ * 63 records. Boards are rebuilt by replaying the moves with
+ * field_Attack.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _GAMELOG_H_
+#define _GAMELOG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "field.h"
+
+/**************************************************************/
+/// The longest fleet name a log header has room for.
+#define GAMELOG_NAME_MAX 16
+
+/**********************************************************//**
+ * @struct GAMELOG
+ * @brief An open binary game log, either being written or
+ * being read.
+ **************************************************************/
+typedef struct {
+    /// The log file.
+    FILE *file;
+    /// The seed of the run that was logged.
+    uint64_t seed;
+    /// The size of the field the games were played on.
+    int size;
+    /// The name of the fleet the games were played with.
+    char fleet[GAMELOG_NAME_MAX];
+    /// The number of games in the log.
+    uint64_t games;
+    /// Writing: the file offset of each indexed game so far.
+    uint64_t *offset;
+    /// Writing: the room in the offset array, in entries.
+    uint64_t capacity;
+    /// Writing: the current file offset.
+    uint64_t position;
+    /// Reading: the file offset of the index.
+    uint64_t index;
+} GAMELOG;
+
+/**********************************************************//**
+ * @struct GAMELOG_MAP
+ * @brief A finished binary game log mapped into memory, so
+ * games can be read from any thread.
+ **************************************************************/
+typedef struct {
+    /// The seed of the run that was logged.
+    uint64_t seed;
+    /// The size of the field the games were played on.
+    int fieldSize;
+    /// The name of the fleet the games were played with.
+    char fleet[GAMELOG_NAME_MAX];
+    /// The number of games in the log.
+    uint64_t games;
+    /// The file offset of each indexed game.
+    const unsigned char *index;
+    /// The start of the mapping.
+    void *base;
+    /// The size of the mapping in bytes.
+    size_t size;
+} GAMELOG_MAP;
+
+/**************************************************************/
+extern bool gamelog_Create(GAMELOG *log, FILE *file, uint64_t seed);
+extern bool gamelog_Write(GAMELOG *log, const PLACEMENT fleet[N_SHIPS_MAX], int turns, const unsigned char move[]);
+extern bool gamelog_Resume(GAMELOG *log, FILE *file, uint64_t seed, uint64_t games, uint64_t position);
+extern bool gamelog_Finish(GAMELOG *log);
+extern bool gamelog_Open(GAMELOG *log, FILE *file);
+extern int gamelog_Read(GAMELOG *log, uint64_t game, PLACEMENT fleet[N_SHIPS_MAX], unsigned char move[TURN_MAX]);
+extern bool gamelog_Map(GAMELOG_MAP *map, const char *filename);
+extern int gamelog_GetGame(const GAMELOG_MAP *map, uint64_t game, PLACEMENT fleet[N_SHIPS_MAX], const unsigned char **move);
+extern void gamelog_Unmap(GAMELOG_MAP *map);
+
+/**************************************************************/
+#endif // _GAMELOG_H_
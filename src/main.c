@@ -7,27 +7,123 @@
  * @date April 21, 2016
  **************************************************************/
 
+#include <errno.h>
 #include <stdbool.h> 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h> 
 
 #include "ai.h"
+#include "batch.h"
+#include "book.h"
+#include "checkpoint.h"
+#include "columns.h"
+#include "corpus.h"
 #include "debug.h"
-#include "field.h"
+#include "endgame.h"
+#include "gamelog.h"
+#include "memo.h"
+#include "montecarlo.h"
+#include "server.h"
+#include "simulate.h"
+#include "stats.h"
+#include "strategy.h"
+#include "summary.h"
 
 /**************************************************************/
 /// The number of games to play.
-static int NumberOfGames = 1;
+static uint64_t NumberOfGames = 1;
+
+/// The number of worker threads to play games on.
+static int NumberOfThreads = 1;
+
+/// The seed of the run.
+static uint64_t Seed = 0;
+
+/// The AI that plays the games.
+static const STRATEGY *Strategy = NULL;
+
+/// The games each thread plays in lockstep, or 0 for one by one.
+static int NumberOfLanes = 0;
+
+/// The sampling budget of the Monte Carlo AI.
+static MONTECARLO MonteCarlo = {
+    .samples = MONTECARLO_SAMPLES,
+    .micros = 0,
+    .threads = 1,
+};
+
+/// The search budget of the endgame AI.
+static ENDGAME Endgame = {
+    .layouts = ENDGAME_LAYOUTS,
+    .nodes = ENDGAME_NODES,
+    .micros = ENDGAME_MICROS,
+};
+
+/// The size and eviction policy of the memo cache.
+static MEMO Memo = {
+    .capacity = 0,
+    .eviction = MEMO_REPLACE,
+};
+
+/// The opening book of the book AI.
+static BOOK Book;
+
+/// The fixed layouts to play, if Corpus.count > 0.
+static CORPUS Corpus;
 
 /// The output log file or NULL.
 static FILE *OutputLog = NULL;
 
+/// Whether the output file is binary columns instead of CSV.
+static bool BinaryOutput = false;
+
+/// The binary columnar output file.
+static COLUMNS Columns;
+
 /// The game data log file, or NULL.
 static FILE *GameLog = NULL;
 
+/// The binary game log file, or NULL.
+static FILE *BinaryLogFile = NULL;
+
+/// The binary game log.
+static GAMELOG BinaryLog;
+
+/// The summary report file, or NULL.
+static FILE *ReportFile = NULL;
+
+/// The games between summary snapshots, or 0 for none.
+static int SnapshotInterval = 0;
+
+/// The file to save checkpoints of the run to, or NULL.
+static const char *CheckpointFilename = NULL;
+
+/// The least seconds between checkpoints.
+static int CheckpointInterval = CHECKPOINT_INTERVAL;
+
+/// Whether the run resumes from a checkpoint.
+static bool Resume = false;
+
+/// The checkpoint the run resumes from.
+static CHECKPOINT Checkpoint;
+
+/// Whether to print the runtime counters at exit.
+static bool PrintStats = false;
+
+/// Whether to serve moves for live games instead of playing.
+static bool Serve = false;
+
+/// The move server's configuration.
+static SERVER Server = {
+    .sessions = SERVER_SESSIONS,
+    .strategy = NULL,
+    .socket = NULL,
+};
+
 /**********************************************************//**
  * @brief Print the help information to the terminal.
  * @param argc: Number of command-line arguments in argv.
@@ -38,8 +134,87 @@ static inline void help(int argc, char **argv) {
     printf("%s usage:\n", argv[0]);
     printf("-h:        Print the help screen.\n");
     printf("-o <name>: Write CSV data to the filename.\n");
+    printf("-f <fmt>:  Write the -o data as csv or bin (default: csv).\n");
     printf("-n <int>:  Play this number of games.\n");
     printf("-g <name>: Write game data to the filename.\n");
+    printf("-l <name>: Write a binary game log to the filename.\n");
+    printf("-r <name>: Write a summary report to the filename.\n");
+    printf("-p <int>:  Print a summary snapshot every this many games.\n");
+    printf("-j <int>:  Play games on this number of threads.\n");
+    printf("-s <int>:  Seed the random boards (default: the time, printed to stderr).\n");
+    printf("--serve:   Serve moves for live games on stdin and stdout instead of playing.\n");
+    printf("--socket <name>: Serve moves on this Unix domain socket instead.\n");
+    printf("-S <int>:  Server: games open at once at most (default: %d).\n", SERVER_SESSIONS);
+    printf("--checkpoint <name>: Save a checkpoint of the run to this file every so often.\n");
+    printf("--checkpoint-every <int>: Seconds between checkpoints at least (default: %d).\n", CHECKPOINT_INTERVAL);
+    printf("--resume <name>: Resume the run this checkpoint was saved from, with the same options.\n");
+    printf("--stats:   Print runtime counters and latency histograms to stderr at exit.\n");
+    printf("-i <name>: Play the layouts of this corpus in rank order, each once unless -n.\n");
+    printf("-W <int>:  Play on a field of this size, %d to %d (default: %d).\n",
+        FIELD_SIZE_MIN, FIELD_SIZE_MAX, FIELD_SIZE_DEFAULT);
+    printf("-F <name>: Play with this fleet:");
+    for (int i = 0; field_GetFleet(i); i++) {
+        printf(" %s", field_GetFleet(i)->name);
+    }
+    printf(" (default: %s).\n", field_GetFleet(0)->name);
+    printf("-a <name>: Play with this AI:");
+    for (int i = 0; strategy_Get(i); i++) {
+        printf(" %s", strategy_Get(i)->name);
+    }
+    printf(" (default: %s).\n", strategy_Get(0)->name);
+    printf("-m <int>:  Monte Carlo layouts to draw per turn.\n");
+    printf("-t <int>:  Monte Carlo microseconds to sample per turn.\n");
+    printf("-k <int>:  Monte Carlo threads to sample on per turn.\n");
+    printf("-e <int>:  Endgame: search once this many layouts are left (default: %d, max: %d).\n", ENDGAME_LAYOUTS, ENDGAME_LAYOUTS_MAX);
+    printf("-E <int>:  Endgame: positions to search per turn at most (default: %d).\n", ENDGAME_NODES);
+    printf("-u <int>:  Endgame: microseconds to search per turn at most, 0 for no limit (default: %d).\n", ENDGAME_MICROS);
+    printf("-B <name>: Book AI: read the opening book from this file.\n");
+    printf("-x <name>: Heuristic: score with auto, avx2 or scalar code (default: auto).\n");
+    printf("-K <int>:  Heuristic: play this many games in lockstep per thread, up to %d.\n", BATCH_LANES_MAX);
+    printf("-c <int>:  Heuristic: cache this many positions' moves (default: 0, off).\n");
+    printf("-C <name>: Heuristic: when the cache is full, replace or keep (default: replace).\n");
+}
+
+/**********************************************************//**
+ * @brief Read a number of games from the command line.
+ * @param text: The argument, in decimal.
+ * @param games: Output parameter for the number of games.
+ * @return Whether the argument is a whole number of games, at
+ * most SIMULATE_GAMES_MAX.
+ **************************************************************/
+static bool parseGames(const char *text, uint64_t *games) {
+    if (!text || *text < '0' || *text > '9') {
+        return false;
+    }
+    char *end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (errno || *end || value > SIMULATE_GAMES_MAX) {
+        return false;
+    }
+    *games = value;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Open an output file: a new one, or when resuming, the
+ * run's own file cut back to the end the checkpoint saved.
+ * @param filename: The name of the file.
+ * @param binary: Whether the file is binary.
+ * @param offset: Where the checkpoint says the file ends, or
+ * -1 to keep all of it.
+ * @return The file, or NULL on failure.
+ **************************************************************/
+static FILE *openOutput(const char *filename, bool binary, int64_t offset) {
+    if (!Resume) {
+        return fopen(filename, binary? "wb": "w");
+    }
+    FILE *file = fopen(filename, binary? "r+b": "r+");
+    if (file && offset >= 0 && !checkpoint_Truncate(file, offset)) {
+        fclose(file);
+        return NULL;
+    }
+    return file;
 }
 
 /**********************************************************//**
@@ -56,6 +231,18 @@ static inline void help(int argc, char **argv) {
 static inline bool parse(int argc, char *argv[]) {
     const char *outputFilename = NULL;
     const char *gameFilename = NULL;
+    const char *binaryFilename = NULL;
+    const char *reportFilename = NULL;
+    const char *bookFilename = NULL;
+    const char *corpusFilename = NULL;
+    const char *resumeFilename = NULL;
+    bool gamesGiven = false;
+    bool seedGiven = false;
+    KERNEL kernel = KERNEL_AUTO;
+    int fieldSize = FIELD_SIZE_DEFAULT;
+    const FLEET *fleet = field_GetFleet(0);
+    Seed = (uint64_t)time(NULL);
+    Strategy = strategy_Get(0);
     
     // Parse arguments
     int i = 1;
@@ -63,11 +250,108 @@ static inline bool parse(int argc, char *argv[]) {
         // Get the current keyword symbol
         const char *keyword = argv[i++];
         if (!strcmp(keyword, "-n")) {
-            NumberOfGames = atoi(argv[i++]);
+            const char *games = argv[i++];
+            if (!parseGames(games, &NumberOfGames)) {
+                fprintf(stderr, "Play 0 to %llu games, not \"%s\"\n",
+                    (unsigned long long)SIMULATE_GAMES_MAX, games? games: "");
+                return false;
+            }
+            gamesGiven = true;
         } else if (!strcmp(keyword, "-o")) {
             outputFilename = argv[i++];
+        } else if (!strcmp(keyword, "-f")) {
+            const char *format = argv[i++];
+            if (!strcmp(format, "bin")) {
+                BinaryOutput = true;
+            } else if (strcmp(format, "csv")) {
+                fprintf(stderr, "Unknown format \"%s\"\n", format);
+                return false;
+            }
         } else if (!strcmp(keyword, "-g")) {
             gameFilename = argv[i++];
+        } else if (!strcmp(keyword, "-l")) {
+            binaryFilename = argv[i++];
+        } else if (!strcmp(keyword, "-r")) {
+            reportFilename = argv[i++];
+        } else if (!strcmp(keyword, "-p")) {
+            SnapshotInterval = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-j")) {
+            NumberOfThreads = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-s")) {
+            Seed = strtoull(argv[i++], NULL, 0);
+            seedGiven = true;
+        } else if (!strcmp(keyword, "--serve")) {
+            Serve = true;
+        } else if (!strcmp(keyword, "--socket")) {
+            Serve = true;
+            Server.socket = argv[i++];
+        } else if (!strcmp(keyword, "-S")) {
+            Server.sessions = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "--checkpoint")) {
+            CheckpointFilename = argv[i++];
+        } else if (!strcmp(keyword, "--checkpoint-every")) {
+            CheckpointInterval = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "--resume")) {
+            resumeFilename = argv[i++];
+            Resume = true;
+        } else if (!strcmp(keyword, "--stats")) {
+            PrintStats = true;
+        } else if (!strcmp(keyword, "-i")) {
+            corpusFilename = argv[i++];
+        } else if (!strcmp(keyword, "-W")) {
+            fieldSize = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-F")) {
+            const char *name = argv[i++];
+            fleet = field_FindFleet(name);
+            if (!fleet) {
+                fprintf(stderr, "Unknown fleet \"%s\"\n", name);
+                return false;
+            }
+        } else if (!strcmp(keyword, "-a")) {
+            const char *name = argv[i++];
+            Strategy = strategy_Find(name);
+            if (!Strategy) {
+                fprintf(stderr, "Unknown AI \"%s\"\n", name);
+                return false;
+            }
+        } else if (!strcmp(keyword, "-m")) {
+            MonteCarlo.samples = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-t")) {
+            MonteCarlo.micros = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-k")) {
+            MonteCarlo.threads = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-e")) {
+            Endgame.layouts = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-E")) {
+            Endgame.nodes = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-u")) {
+            Endgame.micros = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-B")) {
+            bookFilename = argv[i++];
+        } else if (!strcmp(keyword, "-x")) {
+            const char *name = argv[i++];
+            if (!strcmp(name, "avx2")) {
+                kernel = KERNEL_AVX2;
+            } else if (!strcmp(name, "scalar")) {
+                kernel = KERNEL_SCALAR;
+            } else if (strcmp(name, "auto")) {
+                fprintf(stderr, "Unknown kernel \"%s\"\n", name);
+                return false;
+            }
+        } else if (!strcmp(keyword, "-K")) {
+            NumberOfLanes = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-c")) {
+            Memo.capacity = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-C")) {
+            const char *eviction = argv[i++];
+            if (!strcmp(eviction, "keep")) {
+                Memo.eviction = MEMO_KEEP;
+            } else if (!strcmp(eviction, "replace")) {
+                Memo.eviction = MEMO_REPLACE;
+            } else {
+                fprintf(stderr, "Unknown eviction \"%s\"\n", eviction);
+                return false;
+            }
         } else {
             // If -h is found, returns false so we print help
             // (this is a shortcut).
@@ -75,27 +359,169 @@ static inline bool parse(int argc, char *argv[]) {
         }
     }
 
-    // Open the output file, or configure stdout.
+    // The rules are fixed before anything records them.
+    if (!field_Configure(fieldSize, fleet)) {
+        fprintf(stderr, "The %s fleet can't play on a field of size %d.\n", fleet->name, fieldSize);
+        return false;
+    }
+    if (!ai_Configure(kernel)) {
+        fprintf(stderr, "This processor has no AVX2.\n");
+        return false;
+    }
+    if (NumberOfLanes < 0 || NumberOfLanes > BATCH_LANES_MAX) {
+        fprintf(stderr, "Play 1 to %d games in lockstep.\n", BATCH_LANES_MAX);
+        return false;
+    }
+    if (NumberOfLanes > 0 && strcmp(Strategy->name, "heuristic")) {
+        fprintf(stderr, "Only the heuristic AI plays games in lockstep.\n");
+        return false;
+    }
+    if (!endgame_Configure(&Endgame)) {
+        fprintf(stderr, "The endgame searches once 0 to %d layouts are left, with budgets of 0 or more.\n", ENDGAME_LAYOUTS_MAX);
+        return false;
+    }
+
+    if (PrintStats && !stats_Enable()) {
+        fprintf(stderr, "This build has no counters; build it with STATS.\n");
+        return false;
+    }
+
+    // Read the layouts to play instead of random fleets.
+    if (corpusFilename != NULL) {
+        FILE *file = fopen(corpusFilename, "rb");
+        bool read = file && corpus_Read(&Corpus, file);
+        if (file) {
+            fclose(file);
+        }
+        if (!read) {
+            fprintf(stderr, "Failed to read the corpus \"%s\"\n", corpusFilename);
+            return false;
+        }
+        if (!gamesGiven) {
+            NumberOfGames = (uint64_t)Corpus.count;
+        }
+    }
+
+    // Read the opening book, or work it out for these rules.
+    if (bookFilename != NULL) {
+        FILE *file = fopen(bookFilename, "rb");
+        bool read = file && book_Read(&Book, file);
+        if (file) {
+            fclose(file);
+        }
+        if (!read) {
+            fprintf(stderr, "Failed to read the book \"%s\"\n", bookFilename);
+            return false;
+        }
+    } else {
+        book_Create(&Book);
+    }
+
+    // The server only needs the AI. A live opponent only says
+    // which ship a hit belongs to once it sinks, which the AIs
+    // that track each ship's health can't work with. The
+    // heuristic still serves, but every ship looks whole until
+    // it sinks, so it hunts for longer ships than are left and
+    // plays a weaker game than it does against itself.
+    if (Serve) {
+        if (strcmp(Strategy->name, "heuristic") && strcmp(Strategy->name, "book")) {
+            fprintf(stderr, "Only the heuristic and book AIs serve moves.\n");
+            return false;
+        }
+        Server.strategy = Strategy;
+        return true;
+    }
+
+    // Pick the run up where its checkpoint left it. The options
+    // must describe the same run, but the seed and the number
+    // of games can be left to the checkpoint.
+    if (Resume) {
+        if (!checkpoint_Load(&Checkpoint, resumeFilename)) {
+            return false;
+        }
+        Seed = seedGiven? Seed: Checkpoint.seed;
+        NumberOfGames = gamesGiven? NumberOfGames: Checkpoint.games;
+        bool same = Checkpoint.seed == Seed && Checkpoint.games == NumberOfGames
+            && Checkpoint.size == fieldSize && !strcmp(Checkpoint.fleet, fleet->name)
+            && !strcmp(Checkpoint.strategy, Strategy->name) && Checkpoint.columns == BinaryOutput
+            && Checkpoint.corpus == corpus_GetDigest((Corpus.count > 0)? &Corpus: NULL)
+            && Checkpoint.samples == MonteCarlo.samples && Checkpoint.sampleMicros == MonteCarlo.micros
+            && Checkpoint.endgameLayouts == Endgame.layouts && Checkpoint.endgameNodes == Endgame.nodes
+            && Checkpoint.endgameMicros == Endgame.micros
+            && Checkpoint.summarized == (reportFilename != NULL || SnapshotInterval > 0)
+            && (Checkpoint.output >= 0) == (outputFilename != NULL && !BinaryOutput)
+            && (Checkpoint.gameLog >= 0) == (gameFilename != NULL)
+            && (Checkpoint.binaryLog >= 0) == (binaryFilename != NULL);
+        if (!same) {
+            fprintf(stderr, "The checkpoint \"%s\" is for another run.\n", resumeFilename);
+            return false;
+        }
+        if (CheckpointFilename == NULL) {
+            CheckpointFilename = resumeFilename;
+        }
+    }
+
+    // What went to the terminal can't be taken back on resume.
+    bool terminal = (outputFilename == NULL && !BinaryOutput && reportFilename == NULL)
+        || (gameFilename == NULL && binaryFilename == NULL && reportFilename == NULL);
+    if (CheckpointFilename != NULL && terminal) {
+        fprintf(stderr, "Checkpoints need every output in a file.\n");
+        return false;
+    }
+    if (CheckpointInterval < 0) {
+        fprintf(stderr, "Checkpoints can't be less than 0 seconds apart.\n");
+        return false;
+    }
+
+    // Open the output file, or configure stdout. The summary
+    // report replaces the CSV unless both are asked for.
+    // Binary columns are written in place, so they need a file.
     if (outputFilename != NULL) {
-        OutputLog = fopen(outputFilename, "w");
+        OutputLog = openOutput(outputFilename, BinaryOutput, Checkpoint.output);
         if (!OutputLog) {
             fprintf(stderr, "Failed to open \"%s\"\n", outputFilename);
             return false;
         }
-    } else {
+    } else if (BinaryOutput) {
+        fprintf(stderr, "Binary output needs an -o file.\n");
+        return false;
+    } else if (reportFilename == NULL) {
         OutputLog = stdout;
     }
     
-    // Open the game log, or configure stdout.
+    // Open the game log, or configure stdout. The binary game
+    // log and the summary report replace the markdown log
+    // unless it is asked for too.
     if (gameFilename != NULL) {
-        GameLog = fopen(gameFilename, "w");
+        GameLog = openOutput(gameFilename, false, Checkpoint.gameLog);
         if (!GameLog) {
             fprintf(stderr, "Failed to open \"%s\"\n", gameFilename);
             return false;
         }
-    } else {
+    } else if (binaryFilename == NULL && reportFilename == NULL) {
         GameLog = stdout;
     }
+
+    // Open the summary report.
+    if (reportFilename != NULL) {
+        ReportFile = fopen(reportFilename, "w");
+        if (!ReportFile) {
+            fprintf(stderr, "Failed to open \"%s\"\n", reportFilename);
+            return false;
+        }
+    }
+
+    // Open the binary game log.
+    if (binaryFilename != NULL) {
+        BinaryLogFile = openOutput(binaryFilename, true, Checkpoint.binaryLog);
+        bool opened = BinaryLogFile && (Resume
+            ? gamelog_Resume(&BinaryLog, BinaryLogFile, Seed, Checkpoint.played, (uint64_t)Checkpoint.binaryLog)
+            : gamelog_Create(&BinaryLog, BinaryLogFile, Seed));
+        if (!opened) {
+            fprintf(stderr, "Failed to open \"%s\"\n", binaryFilename);
+            return false;
+        }
+    }
     return true;
 }
 
@@ -113,47 +539,99 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
 
-    // Set stuff up before we start logging games.,..
-    srand(time(NULL));
-    fprintf(OutputLog, "Turn,Carrier,Battleship,Submarine,Cruiser,Destroyer\n");
-    for (int i=0; i<NumberOfGames; i++) {
-        // Initialize the field
-        FIELD field;
-        field_Clear(&field);
-        field_CreateRandom(&field);
-        
-        // Write each game to the game log.
-        fprintf(GameLog, "# Game %d\n", i+1);
-
-        // Have the AI take turns until the field is won.
-        while (!field_IsWon(&field)) {
-            if (!ai_PlayTurn(&field)) {
-                eprintf("Failed to play the game.\n");
-                return EXIT_FAILURE;
-            }
-            
-            // Write each turn to the game log.
-            fprintf(GameLog, "## Turn %d\n", field.turns);
-            field_Print(&field, GameLog);
-            fprintf(GameLog, "\n");
+    // Play all the games; the simulation writes the logs.
+    montecarlo_Configure(&MonteCarlo);
+    book_Configure(&Book);
+    if (!memo_Configure(&Memo)) {
+        fprintf(stderr, "Failed to allocate the cache.\n");
+        return EXIT_FAILURE;
+    }
+    if (Serve) {
+        bool served = server_Run(&Server);
+        if (Memo.capacity > 0) {
+            memo_WriteCounters(stderr);
         }
+        memo_Free();
+        montecarlo_Free();
+        return served? EXIT_SUCCESS: EXIT_FAILURE;
+    }
+
+    // The default seed is the time, so say what it was for the
+    // run to be played again with -s
+    fprintf(stderr, "seed %llu\n", (unsigned long long)Seed);
+    bool columns = !BinaryOutput || (Resume
+        ? columns_Resume(&Columns, OutputLog, Seed, NumberOfGames, Checkpoint.played)
+        : columns_Create(&Columns, OutputLog, Seed, NumberOfGames));
+    if (!columns) {
+        fprintf(stderr, "Failed to write the output file.\n");
+        return EXIT_FAILURE;
+    }
+    SUMMARY summary;
+    summary_Clear(&summary);
+    if (Resume) {
+        summary = Checkpoint.summary;
+    }
+    SIMULATION sim = {
+        .games = NumberOfGames,
+        .first = Resume? Checkpoint.played: 0,
+        .threads = NumberOfThreads,
+        .strategy = Strategy,
+        .lanes = NumberOfLanes,
+        .seed = Seed,
+        .corpus = (Corpus.count > 0)? &Corpus: NULL,
+        .monteCarlo = &MonteCarlo,
+        .endgame = &Endgame,
+        .output = BinaryOutput? NULL: OutputLog,
+        .columns = BinaryOutput? &Columns: NULL,
+        .gameLog = GameLog,
+        .binaryLog = BinaryLogFile? &BinaryLog: NULL,
+        .summary = (ReportFile || SnapshotInterval > 0)? &summary: NULL,
+        .snapshot = SnapshotInterval,
+        .checkpoint = CheckpointFilename,
+        .checkpointInterval = CheckpointInterval,
+    };
+    if (!simulate_Run(&sim)) {
+        eprintf("Failed to play the games.\n");
+        return EXIT_FAILURE;
+    }
 
-        // Log each game as csv output
-        fprintf(OutputLog, "%d,%d,%d,%d,%d,%d\n",
-            field.turns,
-            field.sinkTurn[CARRIER],
-            field.sinkTurn[BATTLESHIP],
-            field.sinkTurn[SUBMARINE],
-            field.sinkTurn[CRUISER],
-            field.sinkTurn[DESTROYER]
-        );
+    // Report how much the cache saved, and where the time went
+    if (Memo.capacity > 0) {
+        memo_WriteCounters(stderr);
+    }
+    if (PrintStats) {
+        stats_Flush();
+        stats_Write(stderr);
     }
+    memo_Free();
+    montecarlo_Free();
+    corpus_Free(&Corpus);
 
     // Clean up file
-    fflush(OutputLog);
-    fclose(OutputLog);
-    fflush(GameLog);
-    fclose(GameLog);
+    if (ReportFile) {
+        fprintf(ReportFile, "seed %llu\n", (unsigned long long)Seed);
+        summary_Write(&summary, ReportFile);
+        fclose(ReportFile);
+    }
+    if (BinaryOutput && !columns_Finish(&Columns)) {
+        fprintf(stderr, "Failed to write the output file.\n");
+        return EXIT_FAILURE;
+    }
+    if (OutputLog) {
+        fflush(OutputLog);
+        fclose(OutputLog);
+    }
+    if (GameLog) {
+        fflush(GameLog);
+        fclose(GameLog);
+    }
+    if (BinaryLogFile) {
+        bool finished = gamelog_Finish(&BinaryLog);
+        if (fclose(BinaryLogFile) || !finished) {
+            fprintf(stderr, "Failed to write the binary game log.\n");
+            return EXIT_FAILURE;
+        }
+    }
     return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,205 @@
+/**********************************************************//**
+ * @file mask.h
+ * @brief Fixed-size bit sets with one bit per field tile,
+ * used as bitboards by the field and the AI.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _MASK_H_
+#define _MASK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**************************************************************/
+/// The number of 64-bit words in a mask.
+#define MASK_WORDS 4
+
+/// The number of bits in a mask.
+#define MASK_BITS (64*MASK_WORDS)
+
+/**********************************************************//**
+ * @struct MASK
+ * @brief A set of tile indices.
+ **************************************************************/
+typedef struct {
+    uint64_t word[MASK_WORDS];
+} MASK;
+
+/**********************************************************//**
+ * @brief Get a mask with no bits set.
+ * @return The empty mask.
+ **************************************************************/
+static inline MASK mask_Empty(void) {
+    MASK mask = {{0}};
+    return mask;
+}
+
+/**********************************************************//**
+ * @brief Get a mask with the bits [0, count) set.
+ * @param count: The number of bits to set.
+ * @return The mask.
+ **************************************************************/
+static inline MASK mask_Fill(int count) {
+    MASK mask;
+    for (int i = 0; i < MASK_WORDS; i++) {
+        int bits = count - 64*i;
+        if (bits >= 64) {
+            mask.word[i] = ~UINT64_C(0);
+        } else if (bits > 0) {
+            mask.word[i] = (UINT64_C(1) << bits) - 1;
+        } else {
+            mask.word[i] = 0;
+        }
+    }
+    return mask;
+}
+
+/**********************************************************//**
+ * @brief Check if a bit is set.
+ * @param mask: The mask to check.
+ * @param index: The bit to check.
+ * @return Whether the bit is set.
+ **************************************************************/
+static inline bool mask_Test(const MASK *mask, int index) {
+    return (mask->word[index >> 6] >> (index & 63)) & 1;
+}
+
+/**********************************************************//**
+ * @brief Set a bit.
+ * @param mask: The mask to modify.
+ * @param index: The bit to set.
+ **************************************************************/
+static inline void mask_Set(MASK *mask, int index) {
+    mask->word[index >> 6] |= UINT64_C(1) << (index & 63);
+}
+
+/**********************************************************//**
+ * @brief Clear a bit.
+ * @param mask: The mask to modify.
+ * @param index: The bit to clear.
+ **************************************************************/
+static inline void mask_Reset(MASK *mask, int index) {
+    mask->word[index >> 6] &= ~(UINT64_C(1) << (index & 63));
+}
+
+/**********************************************************//**
+ * @brief Get the intersection of two masks.
+ * @param a: The first mask.
+ * @param b: The second mask.
+ * @return a & b.
+ **************************************************************/
+static inline MASK mask_And(MASK a, MASK b) {
+    for (int i = 0; i < MASK_WORDS; i++) {
+        a.word[i] &= b.word[i];
+    }
+    return a;
+}
+
+/**********************************************************//**
+ * @brief Get the union of two masks.
+ * @param a: The first mask.
+ * @param b: The second mask.
+ * @return a | b.
+ **************************************************************/
+static inline MASK mask_Or(MASK a, MASK b) {
+    for (int i = 0; i < MASK_WORDS; i++) {
+        a.word[i] |= b.word[i];
+    }
+    return a;
+}
+
+/**********************************************************//**
+ * @brief Get the bits of one mask that are not in another.
+ * @param a: The first mask.
+ * @param b: The mask of bits to remove.
+ * @return a & ~b.
+ **************************************************************/
+static inline MASK mask_AndNot(MASK a, MASK b) {
+    for (int i = 0; i < MASK_WORDS; i++) {
+        a.word[i] &= ~b.word[i];
+    }
+    return a;
+}
+
+/**********************************************************//**
+ * @brief Check if a mask has no bits set.
+ * @param mask: The mask to check.
+ * @return Whether the mask is empty.
+ **************************************************************/
+static inline bool mask_IsEmpty(MASK mask) {
+    uint64_t any = 0;
+    for (int i = 0; i < MASK_WORDS; i++) {
+        any |= mask.word[i];
+    }
+    return !any;
+}
+
+/**********************************************************//**
+ * @brief Check if two masks have no bits in common, looking
+ * only at their first words. With a constant word count the
+ * check unrolls to just the words a field uses.
+ * @param a: The first mask.
+ * @param b: The second mask.
+ * @param words: The number of words that can have bits set.
+ * @return Whether the masks are disjoint.
+ **************************************************************/
+static inline bool mask_IsDisjoint(const MASK *a, const MASK *b, int words) {
+    uint64_t any = 0;
+    for (int i = 0; i < words; i++) {
+        any |= a->word[i] & b->word[i];
+    }
+    return !any;
+}
+
+/**********************************************************//**
+ * @brief Count the bits set in a mask.
+ * @param mask: The mask to check.
+ * @return The number of bits set.
+ **************************************************************/
+static inline int mask_Count(MASK mask) {
+    int count = 0;
+    for (int i = 0; i < MASK_WORDS; i++) {
+        count += __builtin_popcountll(mask.word[i]);
+    }
+    return count;
+}
+
+/**********************************************************//**
+ * @brief Remove the lowest set bit from a mask. Repeated calls
+ * visit the bits in increasing order.
+ * @param mask: The mask to modify.
+ * @return The index of the bit, or -1 if the mask is empty.
+ **************************************************************/
+static inline int mask_Pop(MASK *mask) {
+    for (int i = 0; i < MASK_WORDS; i++) {
+        if (mask->word[i]) {
+            int bit = __builtin_ctzll(mask->word[i]);
+            mask->word[i] &= mask->word[i] - 1;
+            return 64*i + bit;
+        }
+    }
+    return -1;
+}
+
+/**********************************************************//**
+ * @brief Get a run of up to 32 bits from a mask. The run may
+ * straddle two words.
+ * @param mask: The mask to read.
+ * @param start: The index of the first bit.
+ * @param count: The number of bits (at most 32).
+ * @return The bits, with bit start in the lowest position.
+ **************************************************************/
+static inline uint32_t mask_GetBits(const MASK *mask, int start, int count) {
+    int i = start >> 6;
+    int shift = start & 63;
+    uint64_t bits = mask->word[i] >> shift;
+    if (shift + count > 64) {
+        bits |= mask->word[i+1] << (64 - shift);
+    }
+    return (uint32_t)(bits & ((UINT64_C(1) << count) - 1));
+}
+
+/**************************************************************/
+#endif // _MASK_H_
@@ -0,0 +1,231 @@
+/**********************************************************//**
+ * @file memo.c
+ * @brief Implementation of the memo cache.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail The table is split into buckets of MEMO_WAYS
+ * entries, and a position may only be stored in the bucket its
+ * hash picks. Every word of an entry is loaded and stored
+ * atomically, so a torn read is only ever a wrong key, and the
+ * sequence count catches it:
+ * - A reader loads the sequence, the entry, then the sequence
+ *   again, and only trusts the entry if the sequence was even
+ *   and didn't change.
+ * - A writer claims the entry by moving its sequence from even
+ *   to odd, and gives up if another writer got there first.
+ * Positions are compared in full, so a hit always gives the
+ * same tile the heuristic would choose, whatever the threads
+ * do.
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ai.h"
+#include "debug.h"
+#include "field.h"
+#include "mask.h"
+#include "memo.h"
+
+/**************************************************************/
+/// The entries, or NULL when the cache is off.
+static MEMO_ENTRY *Table = NULL;
+
+/// The number of buckets minus 1.
+static uint64_t BucketMask = 0;
+
+/// What to do when a position's entries are all taken.
+static EVICTION Eviction = MEMO_REPLACE;
+
+/// How the cache was used (accessed atomically).
+static MEMO_COUNTERS Counters;
+
+/**********************************************************//**
+ * @brief Set the size and eviction policy of the memo cache,
+ * emptying it. This must be done before any games start.
+ * @param config: The size and policy.
+ * @return Whether the table could be allocated.
+ **************************************************************/
+bool memo_Configure(const MEMO *config) {
+    memo_Free();
+    Eviction = config->eviction;
+    if (config->capacity < MEMO_WAYS) {
+        return true;
+    }
+    uint64_t buckets = 1;
+    while (buckets*2*MEMO_WAYS <= (uint64_t)config->capacity) {
+        buckets *= 2;
+    }
+    Table = calloc(buckets*MEMO_WAYS, sizeof(MEMO_ENTRY));
+    if (!Table) {
+        eprintf("Failed to allocate the memo cache.\n");
+        return false;
+    }
+    BucketMask = buckets - 1;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Turn the memo cache off and free its table.
+ **************************************************************/
+void memo_Free(void) {
+    free(Table);
+    Table = NULL;
+    BucketMask = 0;
+    Counters = (MEMO_COUNTERS){0};
+}
+
+/**********************************************************//**
+ * @brief Get the key of the visible position on a field.
+ * @param field: The field in question.
+ * @param key: Output parameter for the masks.
+ * @param health: Output parameter for the packed ship healths.
+ * @return The hash of the position.
+ **************************************************************/
+static inline uint64_t memo_GetKey(const FIELD *field, uint64_t key[MEMO_KEY_WORDS], uint64_t *health) {
+    static const STATUS visible[] = {UNTRIED, HIT, SUNK};
+    uint64_t hash = UINT64_C(0xCBF29CE484222325);
+    for (int i = 0; i < 3; i++) {
+        MASK mask = field_GetMask(field, visible[i]);
+        for (int w = 0; w < MASK_WORDS; w++) {
+            key[i*MASK_WORDS + w] = mask.word[w];
+            hash = (hash ^ mask.word[w]) * UINT64_C(0x100000001B3);
+            hash ^= hash >> 29;
+        }
+    }
+    *health = 0;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        *health |= (uint64_t)field_GetShipHealth(field, ship) << (4*ship);
+    }
+    hash = (hash ^ *health) * UINT64_C(0x100000001B3);
+    return hash ^ (hash >> 29);
+}
+
+/**********************************************************//**
+ * @brief Look a position up in its bucket.
+ * @param bucket: The entries of the bucket.
+ * @param key: The masks of the position.
+ * @param health: The packed ship healths of the position.
+ * @return The tile stored for the position, or -1 if it isn't
+ * stored (or was being written).
+ **************************************************************/
+static int memo_Find(MEMO_ENTRY *bucket, const uint64_t key[MEMO_KEY_WORDS], uint64_t health) {
+    for (int way = 0; way < MEMO_WAYS; way++) {
+        MEMO_ENTRY *entry = &bucket[way];
+        uint32_t sequence = __atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE);
+        if (sequence & 1) {
+            continue;
+        }
+        uint32_t move = __atomic_load_n(&entry->move, __ATOMIC_RELAXED);
+        bool match = (move != 0) && (__atomic_load_n(&entry->health, __ATOMIC_RELAXED) == health);
+        for (int w = 0; match && w < MEMO_KEY_WORDS; w++) {
+            match = (__atomic_load_n(&entry->key[w], __ATOMIC_RELAXED) == key[w]);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (match && __atomic_load_n(&entry->sequence, __ATOMIC_RELAXED) == sequence) {
+            return (int)move - 1;
+        }
+    }
+    return -1;
+}
+
+/**********************************************************//**
+ * @brief Store a position in its bucket: in an empty entry if
+ * there is one, else as the eviction policy says.
+ * @param bucket: The entries of the bucket.
+ * @param hash: The hash of the position.
+ * @param key: The masks of the position.
+ * @param health: The packed ship healths of the position.
+ * @param tile: The tile chosen for the position.
+ **************************************************************/
+static void memo_Store(MEMO_ENTRY *bucket, uint64_t hash, const uint64_t key[MEMO_KEY_WORDS], uint64_t health, int tile) {
+    int way = 0;
+    while (way < MEMO_WAYS && __atomic_load_n(&bucket[way].move, __ATOMIC_RELAXED) != 0) {
+        way++;
+    }
+    bool evict = (way == MEMO_WAYS);
+    if (evict) {
+        if (Eviction == MEMO_KEEP) {
+            return;
+        }
+        way = (int)((hash >> 32) % MEMO_WAYS);
+    }
+
+    // Claim the entry, unless another thread is writing it
+    MEMO_ENTRY *entry = &bucket[way];
+    uint32_t sequence = __atomic_load_n(&entry->sequence, __ATOMIC_RELAXED);
+    if ((sequence & 1) || !__atomic_compare_exchange_n(&entry->sequence, &sequence, sequence+1,
+    false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    evict = evict && (__atomic_load_n(&entry->move, __ATOMIC_RELAXED) != 0);
+    __atomic_store_n(&entry->move, (uint32_t)tile + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->health, health, __ATOMIC_RELAXED);
+    for (int w = 0; w < MEMO_KEY_WORDS; w++) {
+        __atomic_store_n(&entry->key[w], key[w], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&entry->sequence, sequence+2, __ATOMIC_RELEASE);
+    if (evict) {
+        __atomic_fetch_add(&Counters.evictions, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**********************************************************//**
+ * @brief Choose the tile the heuristic would, looking it up in
+ * the memo cache first. A position that isn't stored is worked
+ * out by the heuristic and then stored.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+bool memo_ChooseTile(const FIELD *field, int *x, int *y) {
+    if (!Table) {
+        return ai_ChooseTile(field, x, y);
+    }
+    uint64_t key[MEMO_KEY_WORDS];
+    uint64_t health;
+    uint64_t hash = memo_GetKey(field, key, &health);
+    MEMO_ENTRY *bucket = &Table[(hash & BucketMask) * MEMO_WAYS];
+    int tile = memo_Find(bucket, key, health);
+    if (tile >= 0) {
+        __atomic_fetch_add(&Counters.hits, 1, __ATOMIC_RELAXED);
+        *x = tile / field_GetSize();
+        *y = tile % field_GetSize();
+        return true;
+    }
+    __atomic_fetch_add(&Counters.misses, 1, __ATOMIC_RELAXED);
+    if (!ai_ChooseTile(field, x, y)) {
+        return false;
+    }
+    memo_Store(bucket, hash, key, health, field_GetIndex(*x, *y));
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Get how the memo cache was used so far.
+ * @param counters: Output parameter for the counters.
+ **************************************************************/
+void memo_GetCounters(MEMO_COUNTERS *counters) {
+    counters->hits = __atomic_load_n(&Counters.hits, __ATOMIC_RELAXED);
+    counters->misses = __atomic_load_n(&Counters.misses, __ATOMIC_RELAXED);
+    counters->evictions = __atomic_load_n(&Counters.evictions, __ATOMIC_RELAXED);
+}
+
+/**********************************************************//**
+ * @brief Write the counters of the memo cache as one line.
+ * @param file: The file to write to.
+ **************************************************************/
+void memo_WriteCounters(FILE *file) {
+    MEMO_COUNTERS counters;
+    memo_GetCounters(&counters);
+    uint64_t lookups = counters.hits + counters.misses;
+    fprintf(file, "memo hits %llu misses %llu evictions %llu hit_rate %.4f\n",
+        (unsigned long long)counters.hits, (unsigned long long)counters.misses,
+        (unsigned long long)counters.evictions, lookups? (double)counters.hits/lookups: 0.0);
+}
+
+/**************************************************************/
@@ -0,0 +1,91 @@
+/**********************************************************//**
+ * @file memo.h
+ * @brief Definition of the memo cache. The heuristic's move
+ * only depends on what is visible on the field, and the same
+ * positions come up again and again across games, so the
+ * chosen tiles can be kept in a fixed size hash table shared
+ * by every thread. Readers never take a lock: each entry has
+ * a sequence count that is odd while it is written, and a read
+ * that overlaps a write counts as a miss.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _MEMO_H_
+#define _MEMO_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "field.h"
+
+/**************************************************************/
+/// The number of entries a position may be stored in.
+#define MEMO_WAYS 4
+
+/// @brief The number of key words of an entry: the untried,
+/// hit and sunk masks.
+#define MEMO_KEY_WORDS (3*MASK_WORDS)
+
+/**********************************************************//**
+ * @enum EVICTION
+ * @brief What to do with a new position whose entries are all
+ * taken.
+ **************************************************************/
+typedef enum {
+    /// Replace one of the entries, picked by the position's hash.
+    MEMO_REPLACE,
+    /// Keep the entries; the new position isn't stored.
+    MEMO_KEEP,
+} EVICTION;
+
+/**********************************************************//**
+ * @struct MEMO
+ * @brief The size and eviction policy of the memo cache.
+ **************************************************************/
+typedef struct {
+    /// @brief The number of entries, rounded down to a power
+    /// of two (0 turns the cache off).
+    int capacity;
+    /// What to do when a position's entries are all taken.
+    EVICTION eviction;
+} MEMO;
+
+/**********************************************************//**
+ * @struct MEMO_ENTRY
+ * @brief One stored position and its move.
+ **************************************************************/
+typedef struct {
+    /// Odd while the entry is being written.
+    uint32_t sequence;
+    /// The tile chosen, plus 1 (0 for an empty entry).
+    uint32_t move;
+    /// The health of each ship, 4 bits each.
+    uint64_t health;
+    /// The untried, hit and sunk masks.
+    uint64_t key[MEMO_KEY_WORDS];
+} MEMO_ENTRY;
+
+/**********************************************************//**
+ * @struct MEMO_COUNTERS
+ * @brief How the memo cache was used.
+ **************************************************************/
+typedef struct {
+    /// Positions found in the cache.
+    uint64_t hits;
+    /// Positions that had to be worked out.
+    uint64_t misses;
+    /// Stored positions replaced by new ones.
+    uint64_t evictions;
+} MEMO_COUNTERS;
+
+/**************************************************************/
+extern bool memo_Configure(const MEMO *config);
+extern void memo_Free(void);
+extern bool memo_ChooseTile(const FIELD *field, int *x, int *y);
+extern void memo_GetCounters(MEMO_COUNTERS *counters);
+extern void memo_WriteCounters(FILE *file);
+
+/**************************************************************/
+#endif // _MEMO_H_
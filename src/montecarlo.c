@@ -0,0 +1,383 @@
+/**********************************************************//**
+ * @file montecarlo.c
+ * @brief Implementation of the Monte Carlo AI.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "debug.h"
+#include "density.h"
+#include "field.h"
+#include "mask.h"
+#include "montecarlo.h"
+#include "placement.h"
+#include "rng.h"
+
+/**************************************************************/
+/// The number of layouts drawn from one random stream.
+#define MONTECARLO_BLOCK 64
+
+/// The most threads to sample on within one turn.
+#define MONTECARLO_THREADS_MAX 64
+
+/// The current sampling budget.
+static MONTECARLO Config = {
+    .samples = MONTECARLO_SAMPLES,
+    .micros = 0,
+    .threads = 1,
+};
+
+/**********************************************************//**
+ * @struct JOB
+ * @brief The sampling of one turn. The thread taking the turn
+ * and any idle threads of the pool claim its blocks of draws.
+ **************************************************************/
+typedef struct JOB {
+    /// The consistent slots of each afloat ship, in drawing order.
+    const SLOT *const *slot[N_SHIPS_MAX];
+    /// The number of consistent slots of each afloat ship.
+    int count[N_SHIPS_MAX];
+    /// The number of afloat ships.
+    int ships;
+    /// The untried tiles.
+    MASK untried;
+    /// The random stream key of the turn.
+    uint64_t key;
+    /// The number of blocks to draw, or -1 to draw until the deadline.
+    int blocks;
+    /// The time to stop sampling when there is a time budget.
+    struct timespec deadline;
+    /// The next block to claim (accessed atomically).
+    int next;
+    /// The pool threads working on the job (guarded by the pool).
+    int helpers;
+    /// How many sampled layouts occupy each tile (guarded by the pool).
+    uint32_t occupied[TURN_MAX];
+    /// How many layouts were sampled (guarded by the pool).
+    uint32_t layouts;
+    /// The next job waiting for help.
+    struct JOB *queued;
+} JOB;
+
+/**********************************************************//**
+ * @struct POOL
+ * @brief The threads that help sample the turns of every game,
+ * started once by montecarlo_Configure.
+ **************************************************************/
+typedef struct {
+    /// Guards the queue and the merged counts of the jobs.
+    pthread_mutex_t lock;
+    /// Signalled when a job is queued, or the pool stops.
+    pthread_cond_t work;
+    /// Signalled when the last helper leaves a job.
+    pthread_cond_t done;
+    /// The jobs that still have blocks to claim.
+    JOB *queue;
+    /// Whether the threads should exit.
+    bool stop;
+    /// The number of threads started.
+    int threads;
+    /// The threads.
+    pthread_t thread[MONTECARLO_THREADS_MAX];
+} POOL;
+
+/// The sampling threads.
+static POOL Pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+    .queue = NULL,
+    .stop = false,
+    .threads = 0,
+};
+
+/**********************************************************//**
+ * @brief Get a key for the random streams of a turn, from what
+ * is visible on the field.
+ * @param field: The field in question.
+ * @param seed: The seed of the game.
+ * @return The key.
+ **************************************************************/
+static uint64_t montecarlo_GetKey(const FIELD *field, uint64_t seed) {
+    static const STATUS visible[] = {UNTRIED, HIT, SUNK};
+    uint64_t key = seed;
+    for (size_t i = 0; i < sizeof(visible)/sizeof(visible[0]); i++) {
+        MASK mask = field_GetMask(field, visible[i]);
+        for (int w = 0; w < MASK_WORDS; w++) {
+            key = (key ^ mask.word[w]) * UINT64_C(0x100000001B3);
+            key ^= key >> 29;
+        }
+    }
+    return key;
+}
+
+/**********************************************************//**
+ * @brief Check if a time has passed.
+ * @param deadline: The time to check.
+ * @return Whether the time is now or in the past.
+ **************************************************************/
+static inline bool montecarlo_IsPast(const struct timespec *deadline) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec > deadline->tv_sec)
+        || (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+/**********************************************************//**
+ * @brief Claim blocks of a job until none are left, and draw
+ * them. Each draw puts every ship in one of its consistent
+ * slots, uniformly and independently, and the layouts where
+ * two ships overlap are thrown away. Every consistent layout is
+ * then equally likely, as density.c counts them. Block k draws
+ * from random stream k of the turn's key, so the layouts don't
+ * depend on which thread draws them.
+ * @param job: The job to work on.
+ **************************************************************/
+static void montecarlo_Work(JOB *job) {
+    uint32_t occupied[TURN_MAX] = {0};
+    uint32_t layouts = 0;
+    for (;;) {
+        int block = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (job->blocks >= 0? block >= job->blocks: montecarlo_IsPast(&job->deadline)) {
+            break;
+        }
+        RNG rng;
+        rng_Seed(&rng, job->key, (uint64_t)block);
+        for (int n = 0; n < MONTECARLO_BLOCK; n++) {
+            // The ships with the fewest slots go first, so most
+            // overlaps are found after a draw or two.
+            MASK layout = mask_Empty();
+            int s = 0;
+            while (s < job->ships) {
+                MASK mask = job->slot[s][rng_Range(&rng, job->count[s])]->mask;
+                if (!mask_IsEmpty(mask_And(mask, layout))) {
+                    break;
+                }
+                layout = mask_Or(layout, mask);
+                s++;
+            }
+            if (s < job->ships) {
+                continue;
+            }
+
+            // Count the untried tiles of the layout
+            layouts++;
+            MASK mask = mask_And(layout, job->untried);
+            for (int index = mask_Pop(&mask); index >= 0; index = mask_Pop(&mask)) {
+                occupied[index]++;
+            }
+        }
+    }
+
+    // Add this thread's counts to the job's
+    pthread_mutex_lock(&Pool.lock);
+    job->layouts += layouts;
+    for (int i = 0; i < field_GetTileCount(); i++) {
+        job->occupied[i] += occupied[i];
+    }
+    pthread_mutex_unlock(&Pool.lock);
+}
+
+/**********************************************************//**
+ * @brief Pool thread: help with the queued jobs until the pool
+ * stops.
+ * @param arg: Unused.
+ * @return NULL.
+ **************************************************************/
+static void *montecarlo_Helper(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&Pool.lock);
+    while (!Pool.stop) {
+        JOB *job = Pool.queue;
+        if (!job) {
+            pthread_cond_wait(&Pool.work, &Pool.lock);
+            continue;
+        }
+        // Move the job to the back, so the helpers spread out
+        // over the games sampling at once.
+        if (job->queued) {
+            Pool.queue = job->queued;
+            JOB *last = Pool.queue;
+            while (last->queued) {
+                last = last->queued;
+            }
+            last->queued = job;
+            job->queued = NULL;
+        }
+        job->helpers++;
+        pthread_mutex_unlock(&Pool.lock);
+        montecarlo_Work(job);
+        pthread_mutex_lock(&Pool.lock);
+        if (--job->helpers == 0) {
+            pthread_cond_broadcast(&Pool.done);
+        }
+
+        // Nothing is left to claim, so stop offering the job
+        JOB **link = &Pool.queue;
+        while (*link && *link != job) {
+            link = &(*link)->queued;
+        }
+        if (*link) {
+            *link = job->queued;
+        }
+    }
+    pthread_mutex_unlock(&Pool.lock);
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Set the sampling budget of the Monte Carlo AI, and
+ * start the threads that help sample each turn. This must be
+ * done before any games start.
+ * @param config: The budget.
+ **************************************************************/
+void montecarlo_Configure(const MONTECARLO *config) {
+    montecarlo_Free();
+    Config = *config;
+    if (Config.threads < 1) {
+        Config.threads = 1;
+    } else if (Config.threads > MONTECARLO_THREADS_MAX) {
+        Config.threads = MONTECARLO_THREADS_MAX;
+    }
+
+    // The thread taking a turn samples too
+    Pool.stop = false;
+    while (Pool.threads < Config.threads-1) {
+        if (pthread_create(&Pool.thread[Pool.threads], NULL, montecarlo_Helper, NULL)) {
+            eprintf("Failed to start a sampling thread.\n");
+            break;
+        }
+        Pool.threads++;
+    }
+}
+
+/**********************************************************//**
+ * @brief Stop the threads that help sample. No games may be
+ * playing.
+ **************************************************************/
+void montecarlo_Free(void) {
+    pthread_mutex_lock(&Pool.lock);
+    Pool.stop = true;
+    pthread_cond_broadcast(&Pool.work);
+    pthread_mutex_unlock(&Pool.lock);
+    for (int t = 0; t < Pool.threads; t++) {
+        pthread_join(Pool.thread[t], NULL);
+    }
+    Pool.threads = 0;
+}
+
+/**********************************************************//**
+ * @brief Choose the untried tile occupied in the most sampled
+ * layouts. Ties go to the first tile in x-major order. If no
+ * layout could be sampled, the density AI's scores are used
+ * instead.
+ * @param field: The field to take a turn on.
+ * @param seed: The seed of the game; each turn draws from
+ * streams keyed by the seed and what is on the field.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+bool montecarlo_ChooseTile(const FIELD *field, uint64_t seed, int *x, int *y) {
+    // Find the slots each afloat ship could be in. Ships we have
+    // hit go first, and within each group the ships with the
+    // fewest slots, since they overlap the others most.
+    const SLOT *slot[N_SHIPS_MAX][SLOTS_MAX];
+    int count[N_SHIPS_MAX];
+    JOB job = {
+        .ships = 0,
+        .untried = field_GetMask(field, UNTRIED),
+        .key = montecarlo_GetKey(field, seed),
+        .blocks = (Config.micros > 0)? -1: (Config.samples + MONTECARLO_BLOCK - 1) / MONTECARLO_BLOCK,
+        .next = 0,
+        .helpers = 0,
+        .layouts = 0,
+        .queued = NULL,
+    };
+    bool possible = true;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        if (field_GetShipHealth(field, ship) > 0) {
+            count[ship] = placement_GetConsistent(field, ship, slot[ship]);
+            possible = possible && count[ship] > 0;
+        }
+    }
+    SHIP order[N_SHIPS_MAX];
+    job.ships = placement_SortShips(field, count, order);
+    for (int j = 0; j < job.ships; j++) {
+        job.slot[j] = slot[order[j]];
+        job.count[j] = count[order[j]];
+    }
+    for (int i = 0; i < field_GetTileCount(); i++) {
+        job.occupied[i] = 0;
+    }
+
+    // Sample on this thread, with the help of any idle threads
+    // of the pool. The job can only go once no helper is left.
+    if (possible) {
+        clock_gettime(CLOCK_MONOTONIC, &job.deadline);
+        job.deadline.tv_sec += Config.micros / 1000000;
+        job.deadline.tv_nsec += (long)(Config.micros % 1000000) * 1000;
+        if (job.deadline.tv_nsec >= 1000000000) {
+            job.deadline.tv_sec++;
+            job.deadline.tv_nsec -= 1000000000;
+        }
+        if (Pool.threads > 0) {
+            pthread_mutex_lock(&Pool.lock);
+            job.queued = Pool.queue;
+            Pool.queue = &job;
+            pthread_cond_broadcast(&Pool.work);
+            pthread_mutex_unlock(&Pool.lock);
+        }
+        montecarlo_Work(&job);
+        if (Pool.threads > 0) {
+            pthread_mutex_lock(&Pool.lock);
+            JOB **link = &Pool.queue;
+            while (*link && *link != &job) {
+                link = &(*link)->queued;
+            }
+            if (*link) {
+                *link = job.queued;
+            }
+            while (job.helpers > 0) {
+                pthread_cond_wait(&Pool.done, &Pool.lock);
+            }
+            pthread_mutex_unlock(&Pool.lock);
+        }
+    }
+
+    // Score the tiles by the layouts that occupy them
+    double score[TURN_MAX];
+    if (job.layouts > 0) {
+        for (int i = 0; i < field_GetTileCount(); i++) {
+            score[i] = job.occupied[i];
+        }
+    } else {
+        density_GetScores(field, score);
+    }
+
+    // Pick the best untried tile
+    double scoreMax = -1;
+    int tile = -1;
+    MASK untried = field_GetMask(field, UNTRIED);
+    for (int index = mask_Pop(&untried); index >= 0; index = mask_Pop(&untried)) {
+        if (score[index] > scoreMax) {
+            scoreMax = score[index];
+            tile = index;
+        }
+    }
+    if (tile == -1) {
+        eprintf("No tile left to attack.\n");
+        return false;
+    }
+    *x = tile / field_GetSize();
+    *y = tile % field_GetSize();
+    return true;
+}
+
+/**************************************************************/
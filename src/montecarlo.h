@@ -0,0 +1,43 @@
+/**********************************************************//**
+ * @file montecarlo.h
+ * @brief Definition of the Monte Carlo AI, which samples whole
+ * fleet layouts consistent with the field, each equally
+ * likely, and fires at the tile occupied most often.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _MONTECARLO_H_
+#define _MONTECARLO_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "field.h"
+
+/**************************************************************/
+/// The default number of layouts to draw per turn.
+#define MONTECARLO_SAMPLES 2000
+
+/**********************************************************//**
+ * @struct MONTECARLO
+ * @brief The sampling budget of the Monte Carlo AI.
+ **************************************************************/
+typedef struct {
+    /// The number of layouts to draw per turn, overlapping or not.
+    int samples;
+    /// @brief If positive, sample for this many microseconds per
+    /// turn instead of a fixed number of layouts.
+    int micros;
+    /// @brief The number of threads to sample on within one
+    /// turn; the extra ones are a pool shared by all the games.
+    int threads;
+} MONTECARLO;
+
+/**************************************************************/
+extern void montecarlo_Configure(const MONTECARLO *config);
+extern void montecarlo_Free(void);
+extern bool montecarlo_ChooseTile(const FIELD *field, uint64_t seed, int *x, int *y);
+
+/**************************************************************/
+#endif // _MONTECARLO_H_
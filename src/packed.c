@@ -0,0 +1,159 @@
+/**********************************************************//**
+ * @file packed.c
+ * @brief Implementation of the packed field.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail Each tile is one byte: its STATUS in the low three
+ * bits and its ship plus one in the high four, so a tile with
+ * no ship has 0 there. Every ship has a byte of health and a
+ * byte for its sink turn, stored less one so that the last
+ * turn of a 16x16 field still fits. On the standard 10x10
+ * field a game is 112 bytes.
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "debug.h"
+#include "field.h"
+#include "mask.h"
+#include "packed.h"
+
+#if N_SHIPS_MAX >= (1 << (8 - PACKED_SHIP_SHIFT))
+#error "Ships don't fit in a tile byte."
+#endif
+
+#if N_STATUS > PACKED_STATUS_MASK+1
+#error "Statuses don't fit in a tile byte."
+#endif
+
+/**********************************************************//**
+ * @brief Get the number of bytes of a packed field under the
+ * configured rules.
+ * @return The size, rounded up to keep the turns aligned.
+ **************************************************************/
+size_t packed_GetSize(void) {
+    size_t size = offsetof(PACKED, data) + 2*field_GetShipCount() + field_GetTileCount();
+    return (size + sizeof(uint16_t)-1) / sizeof(uint16_t) * sizeof(uint16_t);
+}
+
+/**********************************************************//**
+ * @brief Pack a field.
+ * @param packed: Output parameter for the packed field, with
+ * room for packed_GetSize() bytes.
+ * @param field: The field to pack. Where the last attack was
+ * isn't kept.
+ **************************************************************/
+void packed_Store(PACKED *packed, const FIELD *field) {
+    int ships = field_GetShipCount();
+    uint8_t *sinkTurn = packed->data + ships;
+    uint8_t *tile = packed->data + 2*ships;
+    packed->turns = (uint16_t)field->turns;
+    for (SHIP ship = 0; ship < ships; ship++) {
+        packed->data[ship] = (uint8_t)field->health[ship];
+        sinkTurn[ship] = (uint8_t)(field->sinkTurn[ship] - 1);
+    }
+    for (int index = 0; index < field_GetTileCount(); index++) {
+        int x = index / field_GetSize();
+        int y = index % field_GetSize();
+        SHIP ship = 0;
+        while (ship < ships && !mask_Test(&field->ship[ship], index)) {
+            ship++;
+        }
+        int owner = (ship < ships)? ship+1: 0;
+        tile[index] = (uint8_t)(field_GetStatus(field, x, y) | (owner << PACKED_SHIP_SHIFT));
+    }
+}
+
+/**********************************************************//**
+ * @brief Find where a ship lies on a packed field. Its first
+ * tile in index order is its upper left corner.
+ * @param packed: The packed field.
+ * @param ship: The ship.
+ * @param placement: Output parameter for where the ship lies.
+ * @return Whether the ship is on the field.
+ **************************************************************/
+bool packed_GetPlacement(const PACKED *packed, SHIP ship, PLACEMENT *placement) {
+    const uint8_t *tile = packed->data + 2*field_GetShipCount();
+    int size = field_GetSize();
+    int index = 0;
+    while (index < field_GetTileCount() && (tile[index] >> PACKED_SHIP_SHIFT) != ship+1) {
+        index++;
+    }
+    if (index == field_GetTileCount()) {
+        return false;
+    }
+    placement->x = index / size;
+    placement->y = index % size;
+    placement->length = field_GetShipLength(ship);
+    bool down = placement->y+1 < size && (tile[index+1] >> PACKED_SHIP_SHIFT) == ship+1;
+    placement->view = down? DOWN: RIGHT;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Make an attack on a packed field, like field_Attack.
+ * @param packed: The packed field to attack.
+ * @param x: The x-coordinate to attack.
+ * @param y: The y-coordinate to attack.
+ * @return The result of the attack or ERROR on failure.
+ **************************************************************/
+STATUS packed_Attack(PACKED *packed, int x, int y) {
+    int ships = field_GetShipCount();
+    uint8_t *tile = packed->data + 2*ships;
+    if (!field_IsInBounds(x, y)) {
+        eprintf("Attack out of bounds.\n");
+        return ERROR;
+    }
+    int index = field_GetIndex(x, y);
+    if ((tile[index] & PACKED_STATUS_MASK) != UNTRIED) {
+        eprintf("Already attacked that location.\n");
+        return ERROR;
+    }
+
+    // Register the turn and attack
+    packed->turns++;
+    int owner = tile[index] >> PACKED_SHIP_SHIFT;
+    if (!owner) {
+        tile[index] = MISS;
+        return MISS;
+    }
+    tile[index] = (uint8_t)(HIT | (owner << PACKED_SHIP_SHIFT));
+    SHIP ship = owner-1;
+    if (--packed->data[ship] > 0) {
+        return HIT;
+    }
+
+    // The ship sank: mark all its tiles, which lie in one line
+    // from its first tile.
+    PLACEMENT placement = {0};
+    bool placed = packed_GetPlacement(packed, ship, &placement);
+    assert(placed);
+    (void)placed;
+    int step = (placement.view == DOWN)? 1: field_GetSize();
+    int first = field_GetIndex(placement.x, placement.y);
+    for (int i = 0; i < placement.length; i++) {
+        tile[first + i*step] = (uint8_t)(SUNK | (owner << PACKED_SHIP_SHIFT));
+    }
+    packed->data[ships + ship] = (uint8_t)(packed->turns - 1);
+    return SUNK;
+}
+
+/**********************************************************//**
+ * @brief Check if a packed field has been won, like
+ * field_IsWon: every ship's health is 0, which is when all its
+ * tiles are SUNK.
+ * @param packed: The packed field to check.
+ * @return Whether the field is complete or not.
+ **************************************************************/
+bool packed_IsWon(const PACKED *packed) {
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        if (packed->data[ship] > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**************************************************************/
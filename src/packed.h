@@ -0,0 +1,97 @@
+/**********************************************************//**
+ * @file packed.h
+ * @brief Definition of the packed field: a FIELD's tiles,
+ * health and turns in about a byte per tile, for keeping many
+ * games resident at once. A packed field can be attacked and
+ * checked for a win like a FIELD, but it keeps no bitboards or
+ * run tables for an AI to look at.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _PACKED_H_
+#define _PACKED_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "field.h"
+
+/**************************************************************/
+/// The bits of a tile byte that hold its STATUS.
+#define PACKED_STATUS_MASK 0x07
+
+/// The shift of a tile byte's ship, stored plus one (0 if none).
+#define PACKED_SHIP_SHIFT 4
+
+/**********************************************************//**
+ * @struct PACKED
+ * @brief A field packed into a few bytes per ship and one byte
+ * per tile. Its size depends on the rules, so packed fields are
+ * laid out packed_GetSize() bytes apart.
+ **************************************************************/
+typedef struct {
+    /// Turns taken on the field.
+    uint16_t turns;
+    /// @brief The health of each ship of the fleet, then the
+    /// turn each ship sank less one (only meaningful once its
+    /// health is 0), then each tile's status and ship, indexed
+    /// by field_GetIndex(x, y).
+    uint8_t data[];
+} PACKED;
+
+/**********************************************************//**
+ * @brief Get the public tile status at the given coordinates,
+ * like field_GetStatus.
+ * @param packed: The packed field.
+ * @param x: The x-coordinate to check.
+ * @param y: The y-coordinate to check.
+ * @return The tile status.
+ **************************************************************/
+static inline STATUS packed_GetStatus(const PACKED *packed, int x, int y) {
+    const uint8_t *tile = packed->data + 2*field_GetShipCount();
+    return (STATUS)(tile[field_GetIndex(x, y)] & PACKED_STATUS_MASK);
+}
+
+/**********************************************************//**
+ * @brief Get the ship at the given coordinates.
+ * @param packed: The packed field.
+ * @param x: The x-coordinate to check.
+ * @param y: The y-coordinate to check.
+ * @return The ship, or EMPTY if there's none.
+ **************************************************************/
+static inline SHIP packed_GetShip(const PACKED *packed, int x, int y) {
+    const uint8_t *tile = packed->data + 2*field_GetShipCount();
+    return (SHIP)((tile[field_GetIndex(x, y)] >> PACKED_SHIP_SHIFT) - 1);
+}
+
+/**********************************************************//**
+ * @brief Get the number of turns taken on a packed field.
+ * @param packed: The packed field.
+ * @return The turns taken.
+ **************************************************************/
+static inline int packed_GetTurns(const PACKED *packed) {
+    return packed->turns;
+}
+
+/**********************************************************//**
+ * @brief Get the turn a ship sank on a packed field.
+ * @param packed: The packed field.
+ * @param ship: The ship.
+ * @return The turn, or TURN_INVALID if it didn't sink yet.
+ **************************************************************/
+static inline int packed_GetSinkTurn(const PACKED *packed, SHIP ship) {
+    const uint8_t *sinkTurn = packed->data + field_GetShipCount();
+    return (packed->data[ship] == 0)? sinkTurn[ship]+1: TURN_INVALID;
+}
+
+/**************************************************************/
+extern size_t packed_GetSize(void);
+extern void packed_Store(PACKED *packed, const FIELD *field);
+extern bool packed_GetPlacement(const PACKED *packed, SHIP ship, PLACEMENT *placement);
+extern STATUS packed_Attack(PACKED *packed, int x, int y);
+extern bool packed_IsWon(const PACKED *packed);
+
+/**************************************************************/
+#endif // _PACKED_H_
@@ -0,0 +1,215 @@
+/**********************************************************//**
+ * @file placement.c
+ * @brief Implementation of the placement tables.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "debug.h"
+#include "field.h"
+#include "mask.h"
+#include "placement.h"
+
+/**********************************************************//**
+ * @struct TABLES
+ * @brief The placement tables of one field size.
+ **************************************************************/
+typedef struct {
+    /// Slots of each ship length.
+    SLOT slot[FIELD_SIZE_MAX+1][SLOTS_MAX];
+    /// The number of slots of each ship length.
+    int count[FIELD_SIZE_MAX+1];
+    /// The slots of each ship length that cover each tile.
+    SLOT_SET covering[FIELD_SIZE_MAX+1][TURN_MAX];
+} TABLES;
+
+/**************************************************************/
+/// The tables of each field size, or NULL until it is used.
+static TABLES *Tables[FIELD_SIZE_MAX+1];
+
+/// Makes sure each size's tables are only built once.
+static pthread_mutex_t TablesLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**********************************************************//**
+ * @brief Build the slot tables of a field size for every ship
+ * length. Slots are listed horizontal ones first, each in
+ * x-major order. A ship of length 1 is the same either way, so
+ * it only gets the horizontal slots. Each slot is also added
+ * to the sets of the tiles it covers.
+ * @param tables: Output parameter for the tables, zeroed.
+ * @param size: The field size.
+ **************************************************************/
+static void placement_Build(TABLES *tables, int size) {
+    static const VIEW views[2] = {RIGHT, DOWN};
+    for (int length = 1; length <= size; length++) {
+        int count = 0;
+        for (int v = 0; v < ((length > 1)? 2: 1); v++) {
+            // The anchor can't be so far along that the ship
+            // extends off of the board.
+            int anchorX = (views[v] == RIGHT)? size-length+1: size;
+            int anchorY = (views[v] == DOWN)? size-length+1: size;
+            for (int x = 0; x < anchorX; x++) {
+                for (int y = 0; y < anchorY; y++) {
+                    SLOT *slot = &tables->slot[length][count];
+                    slot->mask = mask_Empty();
+                    for (int i = 0; i < length; i++) {
+                        int tileX = x + ((views[v] == RIGHT)? i: 0);
+                        int tileY = y + ((views[v] == DOWN)? i: 0);
+                        int tile = tileX*size + tileY;
+                        mask_Set(&slot->mask, tile);
+                        tables->covering[length][tile].word[count/64] |= UINT64_C(1) << (count%64);
+                    }
+                    slot->placement.x = x;
+                    slot->placement.y = y;
+                    slot->placement.view = views[v];
+                    slot->placement.length = length;
+                    count++;
+                }
+            }
+        }
+        tables->count[length] = count;
+    }
+}
+
+/**********************************************************//**
+ * @brief Build the tables of a field size if they aren't yet.
+ * Each size keeps its own tables for the life of the program,
+ * so reconfiguring the field never changes the tables a game
+ * already playing on another size is reading.
+ * @param size: The field size.
+ * @return The tables, or NULL if they couldn't be allocated.
+ **************************************************************/
+static const TABLES *placement_Prepare(int size) {
+    TABLES *tables = __atomic_load_n(&Tables[size], __ATOMIC_ACQUIRE);
+    if (tables) {
+        return tables;
+    }
+    pthread_mutex_lock(&TablesLock);
+    tables = Tables[size];
+    if (!tables) {
+        tables = calloc(1, sizeof(TABLES));
+        if (tables) {
+            placement_Build(tables, size);
+            __atomic_store_n(&Tables[size], tables, __ATOMIC_RELEASE);
+        } else {
+            eprintf("Out of memory for the placement tables.\n");
+        }
+    }
+    pthread_mutex_unlock(&TablesLock);
+    return tables;
+}
+
+/**********************************************************//**
+ * @brief Build the tables for a field size ahead of its first
+ * use. field_Configure calls this for the size it sets.
+ * @param size: The field size.
+ * @return Whether the tables are ready.
+ **************************************************************/
+bool placement_Configure(int size) {
+    return placement_Prepare(size) != NULL;
+}
+
+/**********************************************************//**
+ * @brief Get every legal placement of a ship on an empty
+ * field of the configured size.
+ * @param length: The length of the ship.
+ * @param count: Output parameter for the number of slots.
+ * @return The slots, or NULL if the ship can't fit at all.
+ **************************************************************/
+const SLOT *placement_GetSlots(int length, int *count) {
+    int size = field_GetSize();
+    const TABLES *tables = (length < 1 || length > size)? NULL: placement_Prepare(size);
+    if (!tables) {
+        eprintf("No ship of length %d fits on the field.\n", length);
+        *count = 0;
+        return NULL;
+    }
+    *count = tables->count[length];
+    return tables->slot[length];
+}
+
+/**********************************************************//**
+ * @brief Get the slots of a ship length that cover each tile,
+ * as sets of the indices placement_GetSlots gives them.
+ * @param length: The length of the ship.
+ * @return The sets, indexed by tile, or NULL if the ship can't
+ * fit at all.
+ **************************************************************/
+const SLOT_SET *placement_GetCovering(int length) {
+    int size = field_GetSize();
+    const TABLES *tables = (length < 1 || length > size)? NULL: placement_Prepare(size);
+    if (!tables) {
+        eprintf("No ship of length %d fits on the field.\n", length);
+        return NULL;
+    }
+    return tables->covering[length];
+}
+
+/**********************************************************//**
+ * @brief Get the slots where a ship could still be, given only
+ * what an agent can see on the field: the ship can't cover a
+ * MISS or SUNK tile, and it must cover exactly as many HIT
+ * tiles as it has lost health (a HIT tile belongs to one ship).
+ * @param field: The field to check.
+ * @param ship: The ship to look for. It must be afloat.
+ * @param slot: Output parameter for the consistent slots.
+ * @return The number of consistent slots.
+ **************************************************************/
+int placement_GetConsistent(const FIELD *field, SHIP ship, const SLOT *slot[SLOTS_MAX]) {
+    int length = field_GetShipLength(ship);
+    int hits = length - field_GetShipHealth(field, ship);
+    MASK blocked = mask_Or(field_GetMask(field, MISS), field_GetMask(field, SUNK));
+    MASK hit = field_GetMask(field, HIT);
+
+    int count;
+    const SLOT *slots = placement_GetSlots(length, &count);
+    int consistent = 0;
+    for (int i = 0; i < count; i++) {
+        if (mask_IsEmpty(mask_And(slots[i].mask, blocked))
+        &&  mask_Count(mask_And(slots[i].mask, hit)) == hits) {
+            slot[consistent++] = &slots[i];
+        }
+    }
+    return consistent;
+}
+
+/**********************************************************//**
+ * @brief Order the afloat ships for an enumeration: the ships
+ * that were hit come first, then the others, and within each
+ * group the ships with the fewest consistent slots come first,
+ * ties in ship order. A hit ship goes before every ship that
+ * wasn't hit, however many slots it has.
+ * @param field: The field in question.
+ * @param count: The number of consistent slots of each ship.
+ * Sunk ships are skipped, so theirs aren't read.
+ * @param order: Output parameter for the afloat ships, in
+ * order.
+ * @return The number of afloat ships.
+ **************************************************************/
+int placement_SortShips(const FIELD *field, const int count[N_SHIPS_MAX], SHIP order[N_SHIPS_MAX]) {
+    int ships = 0;
+    int hitShips = 0;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        int health = field_GetShipHealth(field, ship);
+        if (health <= 0) {
+            continue;
+        }
+        bool hit = (health < field_GetShipLength(ship));
+        int first = hit? 0: hitShips;
+        int j = ships++;
+        while (j > first && ((hit && j > hitShips) || count[order[j-1]] > count[ship])) {
+            order[j] = order[j-1];
+            j--;
+        }
+        order[j] = ship;
+        hitShips += hit;
+    }
+    return ships;
+}
+
+/**************************************************************/
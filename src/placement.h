@@ -0,0 +1,58 @@
+/**********************************************************//**
+ * @file placement.h
+ * @brief Precomputed tables of every legal way to lay a ship
+ * of each length on an empty field, as bitboards. Checking if
+ * a ship fits among others is then a single AND, and the slots
+ * covering each tile are listed too. Each field size has its
+ * own tables, built when it is configured, and the lookups use
+ * the configured size.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _PLACEMENT_H_
+#define _PLACEMENT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "field.h"
+#include "mask.h"
+
+/**************************************************************/
+/// @brief The most slots a ship of any length can have on the
+/// largest field (a ship fits in at most two slots per tile).
+#define SLOTS_MAX (2*FIELD_SIZE_MAX*FIELD_SIZE_MAX)
+
+/// The number of 64-bit words in a SLOT_SET.
+#define SLOT_WORDS (SLOTS_MAX/64)
+
+/**********************************************************//**
+ * @struct SLOT
+ * @brief One legal placement of a ship on an empty field.
+ **************************************************************/
+typedef struct {
+    /// The tiles the ship covers.
+    MASK mask;
+    /// Where the ship lies.
+    PLACEMENT placement;
+} SLOT;
+
+/**********************************************************//**
+ * @struct SLOT_SET
+ * @brief A set of the slots of one ship length, one bit per
+ * slot in the order placement_GetSlots lists them.
+ **************************************************************/
+typedef struct {
+    uint64_t word[SLOT_WORDS];
+} SLOT_SET;
+
+/**************************************************************/
+extern bool placement_Configure(int size);
+extern const SLOT *placement_GetSlots(int length, int *count);
+extern const SLOT_SET *placement_GetCovering(int length);
+extern int placement_GetConsistent(const FIELD *field, SHIP ship, const SLOT *slot[SLOTS_MAX]);
+extern int placement_SortShips(const FIELD *field, const int count[N_SHIPS_MAX], SHIP order[N_SHIPS_MAX]);
+
+/**************************************************************/
+#endif // _PLACEMENT_H_
@@ -0,0 +1,52 @@
+/**********************************************************//**
+ * @file rng.c
+ * @brief Implementation of seedable random number streams.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdint.h>
+
+#include "rng.h"
+
+/**********************************************************//**
+ * @brief Get the next 64 bits of a splitmix64 sequence, which
+ * spreads nearby seeds far apart to set up the streams.
+ * @param state: The state of the sequence.
+ * @return The bits.
+ **************************************************************/
+static inline uint64_t rng_Mix(uint64_t *state) {
+    uint64_t z = (*state += UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+/**********************************************************//**
+ * @brief Set up a random number stream. Streams with the same
+ * seed but a different stream number start at unrelated points
+ * of the sequence, set by splitmix64, so the stream number can
+ * simply be the game index and any stream can be set up without
+ * the ones before it. They are not guaranteed to be disjoint,
+ * but with 2^256 states an overlap is vanishingly unlikely.
+ * @param rng: The stream to initialize.
+ * @param seed: The seed of the whole run.
+ * @param stream: The stream number within the run.
+ **************************************************************/
+void rng_Seed(RNG *rng, uint64_t seed, uint64_t stream) {
+    // Scramble the seed and stream number together so nearby
+    // streams start far apart on the sequence.
+    // The state can't be all zero: splitmix64 never gives four
+    // zeros in a row.
+    // rng_Mix advances mix, so it's called on a line of its own:
+    // the order of evaluation in "mix ^= rng_Mix(&mix)" is left to
+    // the compiler.
+    uint64_t mix = seed;
+    uint64_t first = rng_Mix(&mix);
+    mix ^= first + stream;
+    for (int i = 0; i < 4; i++) {
+        rng->state[i] = rng_Mix(&mix);
+    }
+}
+
+/**************************************************************/
@@ -0,0 +1,79 @@
+/**********************************************************//**
+ * @file rng.h
+ * @brief Seedable pseudo-random number streams. Every game
+ * draws from its own stream, so games can be played on any
+ * thread in any order and still see the same boards. The
+ * streams only use fixed-width integer arithmetic, so a seed
+ * gives the same boards on every platform and compiler.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _RNG_H_
+#define _RNG_H_
+
+#include <stdint.h>
+
+/**********************************************************//**
+ * @struct RNG
+ * @brief State of one random number stream.
+ **************************************************************/
+typedef struct {
+    uint64_t state[4];
+} RNG;
+
+/**********************************************************//**
+ * @brief Rotate a word left.
+ * @param x: The word.
+ * @param k: The number of bits, 1 to 63.
+ * @return The rotated word.
+ **************************************************************/
+static inline uint64_t rng_Rotate(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**********************************************************//**
+ * @brief Get the next 64 random bits from the stream. This is
+ * the xoshiro256** generator.
+ * @param rng: The stream to advance.
+ * @return The random bits.
+ **************************************************************/
+static inline uint64_t rng_Next(RNG *rng) {
+    uint64_t *s = rng->state;
+    uint64_t result = rng_Rotate(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_Rotate(s[3], 45);
+    return result;
+}
+
+/**********************************************************//**
+ * @brief Get a random integer in [0, range), without the bias
+ * of a plain modulo. This is Lemire's multiply-and-shift, which
+ * only divides when a draw lands in the few values that have
+ * to be rejected.
+ * @param rng: The stream to advance.
+ * @param range: The number of possible outcomes (positive).
+ * @return The random integer.
+ **************************************************************/
+static inline int rng_Range(RNG *rng, int range) {
+    uint32_t bound = (uint32_t)range;
+    uint64_t product = (rng_Next(rng) >> 32) * bound;
+    if ((uint32_t)product < bound) {
+        uint32_t threshold = -bound % bound;
+        while ((uint32_t)product < threshold) {
+            product = (rng_Next(rng) >> 32) * bound;
+        }
+    }
+    return (int)(product >> 32);
+}
+
+/**************************************************************/
+extern void rng_Seed(RNG *rng, uint64_t seed, uint64_t stream);
+
+/**************************************************************/
+#endif // _RNG_H_
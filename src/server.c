@@ -0,0 +1,550 @@
+/**********************************************************//**
+ * @file server.c
+ * @brief Implementation of the move server.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail Every game lives in a session of an arena that is
+ * allocated once at startup, with room for the AI's state, so
+ * requests never allocate. Free sessions are kept on a stack.
+ * A session's id holds its index in the arena and a count of
+ * the times the session was opened, so a stale id is refused.
+ * The server handles requests in batches: it reads all the
+ * input waiting on a connection, answers every whole line of
+ * it, and writes the answers back at once. A request's latency
+ * is from its batch being read to its answer being written.
+ **************************************************************/
+
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "field.h"
+#include "server.h"
+#include "strategy.h"
+
+/**************************************************************/
+/// The bits of a session id that hold its index in the arena.
+#define SERVER_INDEX_BITS 20
+
+/// The room for each connection's input and output.
+#define SERVER_BUFFER 65536
+
+/// The longest answer to any request.
+#define SERVER_LINE 128
+
+/// The most words of a request that are read.
+#define SERVER_WORDS 9
+
+/// @brief Latency buckets: 16 per power of two, so percentiles
+/// are within 1/16 of the true value.
+#define SERVER_BUCKETS (64*16)
+
+#if SERVER_SESSIONS_MAX > (1 << SERVER_INDEX_BITS)
+#error "Session indices don't fit in the ids."
+#endif
+
+/**********************************************************//**
+ * @struct SESSION
+ * @brief One live game.
+ **************************************************************/
+typedef struct {
+    /// The times the session was opened.
+    uint32_t generation;
+    /// Whether a game is open in the session.
+    bool open;
+    /// What the AI knows of the opponent's field.
+    FIELD field;
+    /// The AI's state for the game, in the arena.
+    void *state;
+} SESSION;
+
+/**********************************************************//**
+ * @struct CLIENT
+ * @brief One connection and its buffers.
+ **************************************************************/
+typedef struct {
+    /// The descriptor to read requests from, or -1 if unused.
+    int in;
+    /// The descriptor to write answers to.
+    int out;
+    /// Whether the descriptors are a socket.
+    bool socket;
+    /// The bytes of input not yet handled.
+    size_t length;
+    /// The input.
+    char input[SERVER_BUFFER];
+    /// The bytes of output not yet written.
+    size_t pending;
+    /// The output.
+    char output[SERVER_BUFFER];
+} CLIENT;
+
+/**********************************************************//**
+ * @struct ARENA
+ * @brief Everything the server needs, allocated at startup.
+ **************************************************************/
+typedef struct {
+    /// The configuration.
+    const SERVER *config;
+    /// The sessions.
+    SESSION *session;
+    /// The space for every session's AI state.
+    unsigned char *state;
+    /// The free sessions, as a stack of indices.
+    int *free;
+    /// The number of free sessions.
+    int frees;
+    /// The connections.
+    CLIENT *client;
+    /// The latency histogram of the requests.
+    uint64_t latency[SERVER_BUCKETS];
+    /// The number of requests handled.
+    uint64_t requests;
+    /// The number of batches handled.
+    uint64_t batches;
+    /// Whether a client asked the server to stop.
+    bool shutdown;
+} ARENA;
+
+/**********************************************************//**
+ * @brief Read the clock.
+ * @return The time in nanoseconds.
+ **************************************************************/
+static inline uint64_t server_Now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec*1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**********************************************************//**
+ * @brief Get the latency bucket of a time.
+ * @param time: The time in nanoseconds.
+ * @return The bucket.
+ **************************************************************/
+static inline int server_GetBucket(uint64_t time) {
+    if (time < 16) {
+        return (int)time;
+    }
+    int exponent = 63 - __builtin_clzll(time);
+    return (exponent-3)*16 + (int)((time >> (exponent-4)) & 15);
+}
+
+/**********************************************************//**
+ * @brief Get the least time of a latency bucket.
+ * @param bucket: The bucket.
+ * @return The time in nanoseconds.
+ **************************************************************/
+static inline uint64_t server_GetBucketTime(int bucket) {
+    if (bucket < 16) {
+        return (uint64_t)bucket;
+    }
+    int exponent = bucket/16 + 3;
+    return (uint64_t)(16 + bucket%16) << (exponent-4);
+}
+
+/**********************************************************//**
+ * @brief Get a percentile of the request latency.
+ * @param arena: The server.
+ * @param fraction: The fraction of requests at most as slow.
+ * @return The latency in microseconds.
+ **************************************************************/
+static double server_GetPercentile(const ARENA *arena, double fraction) {
+    if (arena->requests == 0) {
+        return 0.0;
+    }
+    uint64_t rank = (uint64_t)(fraction*arena->requests);
+    if (rank >= arena->requests) {
+        rank = arena->requests-1;
+    }
+    uint64_t seen = 0;
+    int bucket = 0;
+    while (bucket < SERVER_BUCKETS-1 && (seen += arena->latency[bucket]) <= rank) {
+        bucket++;
+    }
+    return server_GetBucketTime(bucket) * 1e-3;
+}
+
+/**********************************************************//**
+ * @brief Write the request latency percentiles as one line.
+ * @param arena: The server.
+ * @param buffer: The buffer to write to.
+ * @param size: The size of the buffer.
+ * @return The length of the line.
+ **************************************************************/
+static int server_PrintStats(const ARENA *arena, char *buffer, size_t size) {
+    return snprintf(buffer, size, "stats requests %llu batches %llu p50_us %.1f p99_us %.1f max_us %.1f\n",
+        (unsigned long long)arena->requests, (unsigned long long)arena->batches,
+        server_GetPercentile(arena, 0.5), server_GetPercentile(arena, 0.99),
+        server_GetPercentile(arena, 1.0));
+}
+
+/**********************************************************//**
+ * @brief Find the open session of an id.
+ * @param arena: The server.
+ * @param text: The id, as text.
+ * @return The session, or NULL if the id isn't open.
+ **************************************************************/
+static SESSION *server_GetSession(ARENA *arena, const char *text) {
+    char *end;
+    unsigned long long id = strtoull(text, &end, 10);
+    if (end == text) {
+        return NULL;
+    }
+    uint64_t index = id & ((1u << SERVER_INDEX_BITS) - 1);
+    if (index >= (uint64_t)arena->config->sessions) {
+        return NULL;
+    }
+    SESSION *session = &arena->session[index];
+    if (!session->open || (id >> SERVER_INDEX_BITS) != session->generation) {
+        return NULL;
+    }
+    return session;
+}
+
+/**********************************************************//**
+ * @brief Find a ship by name or by its index in the fleet.
+ * @param text: The name or index.
+ * @return The ship, or EMPTY if there's none.
+ **************************************************************/
+static SHIP server_GetShip(const char *text) {
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        if (!strcmp(text, field_GetShipName(ship))) {
+            return ship;
+        }
+    }
+    char *end;
+    long ship = strtol(text, &end, 10);
+    if (end == text || *end || ship < 0 || ship >= field_GetShipCount()) {
+        return EMPTY;
+    }
+    return (SHIP)ship;
+}
+
+/**********************************************************//**
+ * @brief Answer one request.
+ * @param arena: The server.
+ * @param line: The request, without its newline. It is split
+ * up in place.
+ * @param answer: Output parameter for the answer, with room
+ * for SERVER_LINE bytes.
+ * @return The length of the answer.
+ **************************************************************/
+static int server_Handle(ARENA *arena, char *line, char *answer) {
+    const STRATEGY *strategy = arena->config->strategy;
+    char *save = NULL;
+    char *word[SERVER_WORDS] = {NULL};
+    int words = 0;
+    for (char *token = strtok_r(line, " \t\r", &save); token && words < SERVER_WORDS; token = strtok_r(NULL, " \t\r", &save)) {
+        word[words++] = token;
+    }
+    if (words == 0) {
+        return snprintf(answer, SERVER_LINE, "error empty request\n");
+    }
+
+    if (!strcmp(word[0], "open")) {
+        if (arena->frees == 0) {
+            return snprintf(answer, SERVER_LINE, "error no free sessions\n");
+        }
+        int index = arena->free[--arena->frees];
+        SESSION *session = &arena->session[index];
+        session->open = true;
+        session->generation++;
+        field_Clear(&session->field);
+        field_CreateHidden(&session->field);
+        if (strategy->init) {
+            strategy->init(session->state, &session->field, session->generation);
+        }
+        unsigned long long id = ((unsigned long long)session->generation << SERVER_INDEX_BITS) | (unsigned)index;
+        return snprintf(answer, SERVER_LINE, "ok %llu\n", id);
+    } else if (!strcmp(word[0], "stats")) {
+        return server_PrintStats(arena, answer, SERVER_LINE);
+    } else if (!strcmp(word[0], "shutdown")) {
+        arena->shutdown = true;
+        return snprintf(answer, SERVER_LINE, "ok\n");
+    }
+
+    // The rest are about one game
+    if (strcmp(word[0], "move") && strcmp(word[0], "report") && strcmp(word[0], "close")) {
+        return snprintf(answer, SERVER_LINE, "error unknown request\n");
+    }
+    SESSION *session = (words > 1)? server_GetSession(arena, word[1]): NULL;
+    if (!session) {
+        return snprintf(answer, SERVER_LINE, "error no such game\n");
+    }
+    if (!strcmp(word[0], "move")) {
+        int x, y;
+        if (!strategy->choose(session->state, &session->field, &x, &y)) {
+            return snprintf(answer, SERVER_LINE, "error no tile left\n");
+        }
+        return snprintf(answer, SERVER_LINE, "move %d %d\n", x, y);
+    } else if (!strcmp(word[0], "report")) {
+        if (words < 5) {
+            return snprintf(answer, SERVER_LINE, "error report <id> <x> <y> miss|hit|sunk [<ship> [<x> <y> right|down]]\n");
+        }
+        STATUS result = ERROR;
+        SHIP ship = EMPTY;
+        PLACEMENT placement = {0};
+        if (!strcmp(word[4], "miss")) {
+            result = MISS;
+        } else if (!strcmp(word[4], "hit")) {
+            result = HIT;
+        } else if (!strcmp(word[4], "sunk") && words > 5) {
+            result = SUNK;
+            ship = server_GetShip(word[5]);
+        }
+        if (result == SUNK && words > 6) {
+            if (words < 9 || (strcmp(word[8], "right") && strcmp(word[8], "down"))) {
+                result = ERROR;
+            } else {
+                placement.x = atoi(word[6]);
+                placement.y = atoi(word[7]);
+                placement.view = strcmp(word[8], "down")? RIGHT: DOWN;
+            }
+        }
+        if (result == ERROR || !field_Report(&session->field, atoi(word[2]), atoi(word[3]), result, ship,
+            (words > 6)? &placement: NULL)) {
+            return snprintf(answer, SERVER_LINE, "error invalid report\n");
+        }
+        return snprintf(answer, SERVER_LINE, "ok\n");
+    } else if (!strcmp(word[0], "close")) {
+        if (strategy->reset) {
+            strategy->reset(session->state);
+        }
+        session->open = false;
+        arena->free[arena->frees++] = (int)(session - arena->session);
+    }
+    return snprintf(answer, SERVER_LINE, "ok\n");
+}
+
+/**********************************************************//**
+ * @brief Write out a connection's pending answers.
+ * @param client: The connection.
+ * @return Whether they were all written.
+ **************************************************************/
+static bool server_Flush(CLIENT *client) {
+    size_t written = 0;
+    while (written < client->pending) {
+        ssize_t n = client->socket
+            ? send(client->out, client->output + written, client->pending - written, MSG_NOSIGNAL)
+            : write(client->out, client->output + written, client->pending - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            client->pending = 0;
+            return false;
+        }
+        written += (size_t)n;
+    }
+    client->pending = 0;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Read what is waiting on a connection and answer every
+ * whole request in it, as one batch.
+ * @param arena: The server.
+ * @param client: The connection, which is ready to read.
+ * @return Whether the connection is still open.
+ **************************************************************/
+static bool server_Serve(ARENA *arena, CLIENT *client) {
+    ssize_t n = read(client->in, client->input + client->length, SERVER_BUFFER - client->length);
+    if (n < 0 && errno == EINTR) {
+        return true;
+    }
+    if (n <= 0) {
+        return false;
+    }
+    uint64_t start = server_Now();
+    client->length += (size_t)n;
+
+    // Answer each whole line, writing out early only if the
+    // answers fill the buffer.
+    int requests = 0;
+    size_t first = 0;
+    char *newline;
+    while ((newline = memchr(client->input + first, '\n', client->length - first))) {
+        *newline = '\0';
+        if (client->pending + SERVER_LINE > SERVER_BUFFER && !server_Flush(client)) {
+            return false;
+        }
+        client->pending += server_Handle(arena, client->input + first, client->output + client->pending);
+        first = (size_t)(newline - client->input) + 1;
+        requests++;
+    }
+    bool open = server_Flush(client);
+    if (requests > 0) {
+        arena->latency[server_GetBucket(server_Now() - start)] += requests;
+        arena->requests += requests;
+        arena->batches++;
+    }
+
+    // Keep the start of an unfinished line for the next read
+    memmove(client->input, client->input + first, client->length - first);
+    client->length -= first;
+    if (client->length == SERVER_BUFFER) {
+        eprintf("A request is too long.\n");
+        return false;
+    }
+    return open;
+}
+
+/**********************************************************//**
+ * @brief Serve stdin and stdout until the input ends.
+ * @param arena: The server.
+ * @return Whether the server ran.
+ **************************************************************/
+static bool server_RunStdio(ARENA *arena) {
+    CLIENT *client = &arena->client[0];
+    client->in = STDIN_FILENO;
+    client->out = STDOUT_FILENO;
+    client->socket = false;
+    while (!arena->shutdown && server_Serve(arena, client)) {
+        continue;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Serve the clients of a Unix domain socket until one
+ * asks the server to stop.
+ * @param arena: The server.
+ * @return Whether the socket could be listened on.
+ **************************************************************/
+static bool server_RunSocket(ARENA *arena) {
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    if (strlen(arena->config->socket) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "The socket path is too long.\n");
+        return false;
+    }
+    strcpy(address.sun_path, arena->config->socket);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(address.sun_path);
+    if (listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address))
+    || listen(listener, SERVER_CLIENTS)) {
+        fprintf(stderr, "Failed to listen on \"%s\"\n", address.sun_path);
+        if (listener >= 0) {
+            close(listener);
+        }
+        return false;
+    }
+
+    // Poll the listener and every connection; each client's
+    // waiting requests are answered as one batch.
+    struct pollfd poller[SERVER_CLIENTS+1];
+    while (!arena->shutdown) {
+        int polled = 0;
+        poller[polled++] = (struct pollfd){.fd = listener, .events = POLLIN};
+        for (int i = 0; i < SERVER_CLIENTS; i++) {
+            poller[polled++] = (struct pollfd){.fd = arena->client[i].in, .events = POLLIN};
+        }
+        if (poll(poller, polled, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < SERVER_CLIENTS && !arena->shutdown; i++) {
+            CLIENT *client = &arena->client[i];
+            if (client->in >= 0 && (poller[i+1].revents & (POLLIN | POLLHUP | POLLERR))
+            && !server_Serve(arena, client)) {
+                close(client->in);
+                client->in = -1;
+            }
+        }
+        if (poller[0].revents & POLLIN) {
+            int connection = accept(listener, NULL, NULL);
+            int i = 0;
+            while (i < SERVER_CLIENTS && arena->client[i].in >= 0) {
+                i++;
+            }
+            if (connection >= 0 && i == SERVER_CLIENTS) {
+                close(connection);
+            } else if (connection >= 0) {
+                CLIENT *client = &arena->client[i];
+                client->in = connection;
+                client->out = connection;
+                client->socket = true;
+                client->length = 0;
+                client->pending = 0;
+            }
+        }
+    }
+    for (int i = 0; i < SERVER_CLIENTS; i++) {
+        if (arena->client[i].in >= 0) {
+            close(arena->client[i].in);
+        }
+    }
+    close(listener);
+    unlink(address.sun_path);
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Run the move server until its input ends or a client
+ * asks it to stop, then print the request latency to stderr.
+ * @param config: The configuration. The AI must be one that
+ * only needs what an opponent reports: a hit doesn't say which
+ * ship it hit.
+ * @return Whether the server ran.
+ **************************************************************/
+bool server_Run(const SERVER *config) {
+    if (config->sessions < 1 || config->sessions > SERVER_SESSIONS_MAX) {
+        fprintf(stderr, "Serve 1 to %d games at once.\n", SERVER_SESSIONS_MAX);
+        return false;
+    }
+
+    // Allocate everything up front
+    size_t stateSize = (config->strategy->stateSize + 15) / 16 * 16;
+    ARENA *arena = calloc(1, sizeof(ARENA));
+    if (arena) {
+        arena->config = config;
+        arena->session = calloc(config->sessions, sizeof(SESSION));
+        arena->state = calloc(config->sessions, stateSize? stateSize: 1);
+        arena->free = malloc(config->sessions*sizeof(int));
+        arena->client = malloc(SERVER_CLIENTS*sizeof(CLIENT));
+    }
+    if (!arena || !arena->session || !arena->state || !arena->free || !arena->client) {
+        fprintf(stderr, "Failed to allocate the sessions.\n");
+        if (arena) {
+            free(arena->session);
+            free(arena->state);
+            free(arena->free);
+            free(arena->client);
+            free(arena);
+        }
+        return false;
+    }
+    for (int i = 0; i < config->sessions; i++) {
+        arena->session[i].state = arena->state + i*stateSize;
+        arena->free[i] = config->sessions-1 - i;
+    }
+    arena->frees = config->sessions;
+    for (int i = 0; i < SERVER_CLIENTS; i++) {
+        arena->client[i].in = -1;
+    }
+
+    bool success = config->socket? server_RunSocket(arena): server_RunStdio(arena);
+    if (success) {
+        char line[SERVER_LINE];
+        server_PrintStats(arena, line, sizeof(line));
+        fprintf(stderr, "server %s", line + strlen("stats "));
+    }
+    free(arena->session);
+    free(arena->state);
+    free(arena->free);
+    free(arena->client);
+    free(arena);
+    return success;
+}
+
+/**************************************************************/
@@ -0,0 +1,56 @@
+/**********************************************************//**
+ * @file server.h
+ * @brief Definition of the move server. It serves moves for
+ * many live games at once, over stdin and stdout or a Unix
+ * domain socket, with a line protocol:
+ * - "open": start a game; replies "ok <id>".
+ * - "move <id>": replies "move <x> <y>", the AI's next shot.
+ * - "report <id> <x> <y> miss|hit|sunk [<ship> [<x> <y>
+ *   right|down]]": the result of a shot, naming the ship for
+ *   sunk, and where it lay if the opponent reveals it; replies
+ *   "ok". Without where it lay, touching ships can make the
+ *   server guess wrong and refuse a later sink.
+ * - "close <id>": end a game; replies "ok".
+ * - "stats": replies with the request latency percentiles.
+ * - "shutdown": stop the server; replies "ok".
+ * Requests that fail reply "error <reason>".
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _SERVER_H_
+#define _SERVER_H_
+
+#include <stdbool.h>
+
+#include "strategy.h"
+
+/**************************************************************/
+/// The default number of games that can be open at once.
+#define SERVER_SESSIONS 1024
+
+/// The most games that can be open at once.
+#define SERVER_SESSIONS_MAX (1 << 20)
+
+/// The most clients connected to the socket at once.
+#define SERVER_CLIENTS 64
+
+/**********************************************************//**
+ * @struct SERVER
+ * @brief Configuration of the move server.
+ **************************************************************/
+typedef struct {
+    /// The number of games that can be open at once.
+    int sessions;
+    /// The AI that chooses the moves.
+    const STRATEGY *strategy;
+    /// @brief The path of the Unix domain socket to listen on,
+    /// or NULL to serve stdin and stdout.
+    const char *socket;
+} SERVER;
+
+/**************************************************************/
+extern bool server_Run(const SERVER *config);
+
+/**************************************************************/
+#endif // _SERVER_H_
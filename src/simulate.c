@@ -0,0 +1,620 @@
+/**********************************************************//**
+ * @file simulate.c
+ * @brief Implementation of the multi-threaded game driver.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "batch.h"
+#include "checkpoint.h"
+#include "columns.h"
+#include "corpus.h"
+#include "debug.h"
+#include "field.h"
+#include "gamelog.h"
+#include "rng.h"
+#include "simulate.h"
+#include "stats.h"
+#include "strategy.h"
+#include "summary.h"
+
+/**************************************************************/
+/// The number of games a worker claims at a time.
+#define SIMULATE_CHUNK 64
+
+/// The number of games per thread played between log writes.
+#define SIMULATE_WINDOW 4096
+
+/**********************************************************//**
+ * @struct RESULT
+ * @brief Everything needed to log one finished game.
+ **************************************************************/
+typedef struct {
+    /// Turns taken to win the game.
+    int turns;
+    /// The turn each ship sank.
+    int sinkTurn[N_SHIPS_MAX];
+    /// Where each ship started.
+    PLACEMENT fleet[N_SHIPS_MAX];
+    /// Tile attacked on each turn, as field_GetIndex(x, y).
+    unsigned char move[TURN_MAX];
+} RESULT;
+
+/**********************************************************//**
+ * @struct WINDOW
+ * @brief A consecutive range of games shared by the workers.
+ **************************************************************/
+typedef struct {
+    /// The run configuration.
+    const SIMULATION *sim;
+    /// Results of each game in the window, in game order.
+    RESULT *result;
+    /// Index of the first game in the window.
+    uint64_t first;
+    /// The number of games in the window.
+    int count;
+    /// The next game to claim (accessed atomically).
+    int next;
+    /// Set if any game failed (accessed atomically).
+    bool failed;
+    /// The number of workers done with the window.
+    int left;
+} WINDOW;
+
+/**********************************************************//**
+ * @struct POOL
+ * @brief The worker threads of a run, started once. Windows are
+ * posted to two buffers in turn, so the workers can play one
+ * window while the results of the one before are logged.
+ **************************************************************/
+typedef struct {
+    /// The run configuration.
+    const SIMULATION *sim;
+    /// Window k is in buffer k % 2.
+    WINDOW window[2];
+    /// The number of worker threads.
+    int workers;
+    /// The number of windows posted so far.
+    uint64_t posted;
+    /// Set once no more windows will be posted.
+    bool stop;
+    /// Guards the fields above and each window's left count.
+    pthread_mutex_t lock;
+    /// Signaled when a window is posted, or on stopping.
+    pthread_cond_t post;
+    /// Signaled when every worker is done with a window.
+    pthread_cond_t done;
+} POOL;
+
+/**********************************************************//**
+ * @brief Set up the board of a game. The board only depends
+ * on the seed and the game index, or on the corpus.
+ * @param sim: The run configuration.
+ * @param game: The index of the game.
+ * @param field: Output parameter for the board.
+ * @return The seed for the AI's state in this game.
+ **************************************************************/
+static inline uint64_t simulate_Setup(const SIMULATION *sim, uint64_t game, FIELD *field) {
+    RNG rng;
+    rng_Seed(&rng, sim->seed, game);
+    field_Clear(field);
+    if (sim->corpus) {
+        // The corpus was checked when it was read
+        bool created = field_CreateFleet(field, sim->corpus->layout[game % (uint64_t)sim->corpus->count].fleet);
+        assert(created);
+        (void)created;
+    } else {
+        field_CreateRandom(field, &rng);
+    }
+    return rng_Next(&rng);
+}
+
+/**********************************************************//**
+ * @brief Play one whole game.
+ * @param sim: The run configuration.
+ * @param game: The index of the game.
+ * @param state: Space for the AI's state.
+ * @param result: Output parameter for the game result.
+ * @return Whether the gameplay succeeded.
+ **************************************************************/
+static bool simulate_Play(const SIMULATION *sim, uint64_t game, void *state, RESULT *result) {
+    FIELD field;
+    uint64_t gameStart = stats_Start();
+    uint64_t seed = simulate_Setup(sim, game, &field);
+    const STRATEGY *strategy = sim->strategy;
+    if (strategy->init) {
+        strategy->init(state, &field, seed);
+    }
+
+    // Have the AI take turns until the field is won.
+    bool success = true;
+    while (success && !field_IsWon(&field)) {
+        uint64_t turnStart = stats_StartSample();
+        if (!strategy_PlayTurn(strategy, state, &field)) {
+            eprintf("Failed to play game %llu.\n", (unsigned long long)game+1);
+            success = false;
+            break;
+        }
+        stats_AddTime(StatsLocal.turnTime, turnStart, 1);
+        int move = field_GetIndex(field.lastAttackX, field.lastAttackY);
+        result->move[field.turns-1] = (unsigned char)move;
+    }
+    if (strategy->reset) {
+        strategy->reset(state);
+    }
+
+    // Keep the statistics
+    STATS_ADD(turns[field.turns], 1);
+    stats_AddTime(StatsLocal.gameTime, gameStart, 1);
+    result->turns = field.turns;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        result->sinkTurn[ship] = field.sinkTurn[ship];
+        result->fleet[ship] = *field_GetPlacement(&field, ship);
+    }
+    return success;
+}
+
+/**********************************************************//**
+ * @brief Play games from the window until none are left to
+ * claim.
+ * @param window: The window to work on.
+ * @param state: Space for the AI's state.
+ **************************************************************/
+static void simulate_PlayWindow(WINDOW *window, void *state) {
+    while (!__atomic_load_n(&window->failed, __ATOMIC_RELAXED)) {
+        int start = __atomic_fetch_add(&window->next, SIMULATE_CHUNK, __ATOMIC_RELAXED);
+        if (start >= window->count) {
+            break;
+        }
+        int end = start + SIMULATE_CHUNK;
+        if (end > window->count) {
+            end = window->count;
+        }
+        for (int i = start; i < end; i++) {
+            if (!simulate_Play(window->sim, window->first+i, state, &window->result[i])) {
+                __atomic_store_n(&window->failed, true, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+    }
+}
+
+/**********************************************************//**
+ * @brief Play the games of the window in lockstep on a batch,
+ * refilling each lane with the next game claimed as soon as
+ * its game is won. The batch is left empty.
+ * @param window: The window to work on.
+ * @param batch: The batch to play on, with no games in it.
+ **************************************************************/
+static void simulate_PlayBatchWindow(WINDOW *window, BATCH *batch) {
+    const SIMULATION *sim = window->sim;
+
+    // The game each lane is playing, and the claimed games
+    // that are waiting for a lane.
+    int game[BATCH_LANES_MAX];
+    uint64_t gameStart[BATCH_LANES_MAX];
+    int move[BATCH_LANES_MAX];
+    int next = 0;
+    int end = 0;
+    bool claimed = true;
+    for (;;) {
+        int playing = 0;
+        for (int lane = 0; lane < batch->lanes; lane++) {
+            if (!batch->active[lane] && claimed) {
+                if (next >= end) {
+                    next = __atomic_fetch_add(&window->next, SIMULATE_CHUNK, __ATOMIC_RELAXED);
+                    end = (next+SIMULATE_CHUNK < window->count)? next+SIMULATE_CHUNK: window->count;
+                }
+                if (next < end) {
+                    FIELD field;
+                    gameStart[lane] = stats_Start();
+                    simulate_Setup(sim, window->first+next, &field);
+                    batch_Load(batch, lane, &field);
+                    game[lane] = next++;
+                } else {
+                    claimed = false;
+                }
+            }
+            playing += batch->active[lane];
+        }
+        if (!playing || __atomic_load_n(&window->failed, __ATOMIC_RELAXED)) {
+            break;
+        }
+        // The games of a step share its time equally
+        uint64_t turnStart = stats_StartSample();
+        if (!batch_Step(batch, move)) {
+            eprintf("Failed to play the batch.\n");
+            __atomic_store_n(&window->failed, true, __ATOMIC_RELAXED);
+            break;
+        }
+        stats_AddTime(StatsLocal.turnTime, turnStart, playing);
+
+        // Record the moves, and let the won games go
+        for (int lane = 0; lane < batch->lanes; lane++) {
+            if (!batch->active[lane]) {
+                continue;
+            }
+            RESULT *result = &window->result[game[lane]];
+            result->move[batch->turns[lane]-1] = (unsigned char)move[lane];
+            if (batch->remaining[lane] == 0) {
+                result->turns = batch->turns[lane];
+                for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+                    result->sinkTurn[ship] = batch->sinkTurn[lane][ship];
+                    result->fleet[ship] = batch->placement[lane][ship];
+                }
+                STATS_ADD(turns[result->turns], 1);
+                stats_AddTime(StatsLocal.gameTime, gameStart[lane], 1);
+                batch->active[lane] = false;
+            }
+        }
+    }
+
+    // Games cut short by a failure are dropped
+    for (int lane = 0; lane < batch->lanes; lane++) {
+        batch->active[lane] = false;
+    }
+}
+
+/**********************************************************//**
+ * @brief Set up what a thread needs to play games: the AI's
+ * state, or a batch with -K.
+ * @param sim: The run configuration.
+ * @param state: Output parameter for the AI's state, or NULL.
+ * @param batch: Output parameter for the batch, or NULL.
+ * @return Whether it could be allocated.
+ **************************************************************/
+static bool simulate_CreatePlayer(const SIMULATION *sim, void **state, BATCH **batch) {
+    *state = NULL;
+    *batch = NULL;
+    if (sim->lanes > 0) {
+        *batch = malloc(sizeof(BATCH));
+        if (!*batch || !batch_Create(*batch, sim->lanes)) {
+            eprintf("Failed to allocate the batch.\n");
+            free(*batch);
+            *batch = NULL;
+            return false;
+        }
+        return true;
+    }
+    *state = calloc(1, sim->strategy->stateSize + 1);
+    if (!*state) {
+        eprintf("Failed to allocate the AI state.\n");
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Free what simulate_CreatePlayer set up.
+ * @param state: The AI's state, or NULL.
+ * @param batch: The batch, or NULL.
+ **************************************************************/
+static void simulate_FreePlayer(void *state, BATCH *batch) {
+    free(state);
+    if (batch) {
+        batch_Free(batch);
+        free(batch);
+    }
+}
+
+/**********************************************************//**
+ * @brief Play a window on this thread.
+ * @param window: The window to work on.
+ * @param state: The AI's state, or NULL to play on the batch.
+ * @param batch: The batch, or NULL to play one game at a time.
+ **************************************************************/
+static void simulate_Work(WINDOW *window, void *state, BATCH *batch) {
+    if (batch) {
+        simulate_PlayBatchWindow(window, batch);
+    } else if (state) {
+        simulate_PlayWindow(window, state);
+    } else {
+        __atomic_store_n(&window->failed, true, __ATOMIC_RELAXED);
+    }
+}
+
+/**********************************************************//**
+ * @brief Worker thread: play each window as it is posted, until
+ * the pool stops. Every worker passes through every window, so
+ * a window is done once all of them have left it.
+ * @param arg: The POOL to work for.
+ * @return NULL.
+ **************************************************************/
+static void *simulate_Worker(void *arg) {
+    POOL *pool = arg;
+    void *state;
+    BATCH *batch;
+    simulate_CreatePlayer(pool->sim, &state, &batch);
+    for (uint64_t k = 0;; k++) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->posted <= k && !pool->stop) {
+            pthread_cond_wait(&pool->post, &pool->lock);
+        }
+        if (pool->posted <= k) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        WINDOW *window = &pool->window[k % 2];
+        pthread_mutex_unlock(&pool->lock);
+
+        simulate_Work(window, state, batch);
+
+        pthread_mutex_lock(&pool->lock);
+        if (++window->left == pool->workers) {
+            pthread_cond_broadcast(&pool->done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+    simulate_FreePlayer(state, batch);
+    stats_Flush();
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Write one finished game to the logs. The game log is
+ * rebuilt by replaying the recorded moves on the same board.
+ * @param sim: The run configuration.
+ * @param game: The index of the game.
+ * @param result: The result of the game.
+ * @return Whether the binary logs could be written.
+ **************************************************************/
+static bool simulate_Log(const SIMULATION *sim, uint64_t game, const RESULT *result) {
+    if (sim->gameLog) {
+        // The replay isn't play, so it isn't counted
+#ifdef STATS
+        STATS_COUNTERS played = StatsLocal;
+#endif
+        FIELD field;
+        simulate_Setup(sim, game, &field);
+
+        // Write each turn to the game log.
+        fprintf(sim->gameLog, "# Game %llu\n", (unsigned long long)game+1);
+        for (int turn = 0; turn < result->turns; turn++) {
+            int move = result->move[turn];
+            field_Attack(&field, move/field_GetSize(), move%field_GetSize());
+            fprintf(sim->gameLog, "## Turn %d\n", field.turns);
+            field_Print(&field, sim->gameLog);
+            fprintf(sim->gameLog, "\n");
+        }
+#ifdef STATS
+        StatsLocal = played;
+#endif
+    }
+
+    // Log each game as csv output
+    if (sim->output) {
+        fprintf(sim->output, "%d", result->turns);
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            fprintf(sim->output, ",%d", result->sinkTurn[ship]);
+        }
+        fprintf(sim->output, "\n");
+    }
+
+    // Log each game to the binary columns
+    if (sim->columns && !columns_Add(sim->columns, result->turns, result->sinkTurn)) {
+        eprintf("Failed to write game %llu to the columns.\n", (unsigned long long)game+1);
+        return false;
+    }
+
+    // Aggregate the statistics
+    if (sim->summary) {
+        summary_Add(sim->summary, result->turns, result->sinkTurn);
+        if (sim->snapshot > 0 && (game+1) % (uint64_t)sim->snapshot == 0) {
+            summary_WriteSnapshot(sim->summary, stderr);
+        }
+    }
+
+    // Log the fleet and moves to the binary game log
+    if (sim->binaryLog && !gamelog_Write(sim->binaryLog, result->fleet, result->turns, result->move)) {
+        eprintf("Failed to write game %llu to the binary log.\n", (unsigned long long)game+1);
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Save a checkpoint after the games logged so far. The
+ * outputs are written through to the disk first, so that they
+ * hold at least what the checkpoint says they do.
+ * @param sim: The run configuration.
+ * @param played: The number of games played and logged.
+ * @return Whether the checkpoint was saved.
+ **************************************************************/
+static bool simulate_Checkpoint(const SIMULATION *sim, uint64_t played) {
+    CHECKPOINT *checkpoint = malloc(sizeof(CHECKPOINT));
+    if (!checkpoint) {
+        eprintf("Failed to allocate the checkpoint.\n");
+        return false;
+    }
+    int64_t columns = -1;
+    bool synced = (!sim->columns || columns_Sync(sim->columns))
+        && checkpoint_Sync(sim->columns? sim->columns->file: NULL, &columns)
+        && checkpoint_Sync(sim->output, &checkpoint->output)
+        && checkpoint_Sync(sim->gameLog, &checkpoint->gameLog)
+        && checkpoint_Sync(sim->binaryLog? sim->binaryLog->file: NULL, &checkpoint->binaryLog);
+    if (!synced) {
+        eprintf("Failed to write the outputs for a checkpoint.\n");
+        free(checkpoint);
+        return false;
+    }
+    checkpoint->seed = sim->seed;
+    checkpoint->games = sim->games;
+    checkpoint->played = played;
+    checkpoint->size = field_GetSize();
+    snprintf(checkpoint->fleet, CHECKPOINT_NAME_MAX, "%s", FieldRules.fleet->name);
+    snprintf(checkpoint->strategy, CHECKPOINT_NAME_MAX, "%s", sim->strategy->name);
+    checkpoint->corpus = corpus_GetDigest(sim->corpus);
+    checkpoint->samples = sim->monteCarlo->samples;
+    checkpoint->sampleMicros = sim->monteCarlo->micros;
+    checkpoint->endgameLayouts = sim->endgame->layouts;
+    checkpoint->endgameNodes = sim->endgame->nodes;
+    checkpoint->endgameMicros = sim->endgame->micros;
+    checkpoint->columns = (sim->columns != NULL);
+    checkpoint->summarized = (sim->summary != NULL);
+    if (sim->summary) {
+        checkpoint->summary = *sim->summary;
+    } else {
+        summary_Clear(&checkpoint->summary);
+    }
+    bool saved = checkpoint_Save(checkpoint, sim->checkpoint);
+    free(checkpoint);
+    return saved;
+}
+
+/**********************************************************//**
+ * @brief Post the next window of a run to its buffer. Every
+ * worker must be done with the window that was in it.
+ * @param pool: The pool.
+ * @param result: The results of the buffer's games.
+ **************************************************************/
+static void simulate_Post(POOL *pool, RESULT *result) {
+    const SIMULATION *sim = pool->sim;
+    uint64_t capacity = (uint64_t)((sim->threads > 1)? sim->threads: 1)*SIMULATE_WINDOW;
+    WINDOW *window = &pool->window[pool->posted % 2];
+    window->sim = sim;
+    window->result = result;
+    window->first = sim->first + pool->posted*capacity;
+    window->count = (sim->games-window->first < capacity)? (int)(sim->games-window->first): (int)capacity;
+    window->next = 0;
+    window->failed = false;
+    window->left = 0;
+    pthread_mutex_lock(&pool->lock);
+    pool->posted++;
+    pthread_cond_broadcast(&pool->post);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**********************************************************//**
+ * @brief Play all the games of a run. Games are played in
+ * windows by a pool of workers started once. While the workers
+ * play a window, the results of the window before are logged
+ * in game order, so the logs are the same for any number of
+ * threads. With a checkpoint file, a checkpoint is saved
+ * between windows once enough time passed.
+ * @param sim: The run configuration.
+ * @return Whether all the games succeeded.
+ **************************************************************/
+bool simulate_Run(const SIMULATION *sim) {
+    int threads = (sim->threads > 1)? sim->threads: 1;
+    uint64_t capacity = (uint64_t)threads*SIMULATE_WINDOW;
+    uint64_t windows = (sim->first < sim->games)? (sim->games-sim->first + capacity-1) / capacity: 0;
+    RESULT *result[2] = {
+        malloc(capacity*sizeof(RESULT)),
+        malloc(capacity*sizeof(RESULT)),
+    };
+    pthread_t *worker = malloc(threads*sizeof(pthread_t));
+    if (!result[0] || !result[1] || !worker) {
+        eprintf("Failed to allocate the simulation.\n");
+        free(result[0]);
+        free(result[1]);
+        free(worker);
+        return false;
+    }
+
+    if (sim->output && sim->first == 0) {
+        fprintf(sim->output, "Turn");
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            fprintf(sim->output, ",%s", field_GetShipName(ship));
+        }
+        fprintf(sim->output, "\n");
+    }
+
+    // Start the workers, which wait for the first window
+    POOL pool = {
+        .sim = sim,
+        .workers = 0,
+        .posted = 0,
+        .stop = false,
+    };
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.post, NULL);
+    pthread_cond_init(&pool.done, NULL);
+    int started = 0;
+    pthread_mutex_lock(&pool.lock);
+    while (started < threads) {
+        if (pthread_create(&worker[started], NULL, simulate_Worker, &pool)) {
+            eprintf("Failed to start a worker thread.\n");
+            break;
+        }
+        started++;
+    }
+    pool.workers = started;
+    pthread_mutex_unlock(&pool.lock);
+
+    // If no workers could be started, the calling thread plays
+    // each window before logging it.
+    void *state = NULL;
+    BATCH *batch = NULL;
+    bool success = (started > 0 || simulate_CreatePlayer(sim, &state, &batch));
+    for (int k = 0; success && k < 2 && (uint64_t)k < windows; k++) {
+        simulate_Post(&pool, result[k]);
+    }
+
+    time_t saved = time(NULL);
+    for (uint64_t k = 0; success && k < windows; k++) {
+        WINDOW *window = &pool.window[k % 2];
+        if (started > 0) {
+            pthread_mutex_lock(&pool.lock);
+            while (window->left < pool.workers) {
+                pthread_cond_wait(&pool.done, &pool.lock);
+            }
+            pthread_mutex_unlock(&pool.lock);
+        } else {
+            simulate_Work(window, state, batch);
+        }
+
+        // Merge the results in game order
+        if (window->failed) {
+            success = false;
+            break;
+        }
+        for (int i = 0; success && i < window->count; i++) {
+            success = simulate_Log(sim, window->first+i, &window->result[i]);
+        }
+
+        // Checkpoint the games logged, unless they're all done
+        uint64_t played = window->first + (uint64_t)window->count;
+        if (success && sim->checkpoint && played < sim->games
+        && difftime(time(NULL), saved) >= sim->checkpointInterval) {
+            success = simulate_Checkpoint(sim, played);
+            saved = time(NULL);
+        }
+
+        // The buffer is free for the window after next
+        if (success && k+2 < windows) {
+            simulate_Post(&pool, window->result);
+        }
+    }
+
+    // Stop the workers, cutting short any window still in play
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = true;
+    pthread_cond_broadcast(&pool.post);
+    pthread_mutex_unlock(&pool.lock);
+    __atomic_store_n(&pool.window[0].failed, true, __ATOMIC_RELAXED);
+    __atomic_store_n(&pool.window[1].failed, true, __ATOMIC_RELAXED);
+    for (int i = 0; i < started; i++) {
+        pthread_join(worker[i], NULL);
+    }
+    if (started == 0) {
+        simulate_FreePlayer(state, batch);
+        stats_Flush();
+    }
+    pthread_mutex_destroy(&pool.lock);
+    pthread_cond_destroy(&pool.post);
+    pthread_cond_destroy(&pool.done);
+
+    free(result[0]);
+    free(result[1]);
+    free(worker);
+    return success;
+}
+
+/**************************************************************/
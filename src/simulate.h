@@ -0,0 +1,79 @@
+/**********************************************************//**
+ * @file simulate.h
+ * @brief Plays batches of AI games, optionally split across a
+ * pool of worker threads, and logs the results in game order.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _SIMULATE_H_
+#define _SIMULATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "columns.h"
+#include "corpus.h"
+#include "endgame.h"
+#include "gamelog.h"
+#include "montecarlo.h"
+#include "strategy.h"
+#include "summary.h"
+
+/**************************************************************/
+/// @brief The most games a run can have, so that the game
+/// indices and the file offsets they lead to never overflow.
+#define SIMULATE_GAMES_MAX ((uint64_t)INT64_MAX)
+
+/**********************************************************//**
+ * @struct SIMULATION
+ * @brief Configuration of one simulation run.
+ **************************************************************/
+typedef struct {
+    /// The number of games to play.
+    uint64_t games;
+    /// @brief The first game to play, when resuming a run that
+    /// already played and logged the games before it.
+    uint64_t first;
+    /// The number of worker threads to play games on.
+    int threads;
+    /// The AI that plays the games.
+    const STRATEGY *strategy;
+    /// @brief If positive, play this many games at once per
+    /// thread on a batch. The AI must be the heuristic.
+    int lanes;
+    /// @brief The seed of the run. Game i always uses random
+    /// stream i of this seed, whatever thread plays it.
+    uint64_t seed;
+    /// @brief The fixed layouts to play, or NULL for random
+    /// fleets. Game i plays layout i, wrapping around.
+    const CORPUS *corpus;
+    /// The budget of the Monte Carlo AI, kept in checkpoints.
+    const MONTECARLO *monteCarlo;
+    /// The budget of the endgame AI, kept in checkpoints.
+    const ENDGAME *endgame;
+    /// The CSV output file, or NULL.
+    FILE *output;
+    /// The binary columnar output file, or NULL.
+    COLUMNS *columns;
+    /// The markdown game log file, or NULL.
+    FILE *gameLog;
+    /// The binary game log, or NULL.
+    GAMELOG *binaryLog;
+    /// The statistics of the games played, or NULL.
+    SUMMARY *summary;
+    /// @brief The number of games between progress snapshots of
+    /// the summary on stderr, or 0 for none.
+    int snapshot;
+    /// The file to save checkpoints of the run to, or NULL.
+    const char *checkpoint;
+    /// The least seconds between checkpoints.
+    int checkpointInterval;
+} SIMULATION;
+
+/**************************************************************/
+extern bool simulate_Run(const SIMULATION *sim);
+
+/**************************************************************/
+#endif // _SIMULATE_H_
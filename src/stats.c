@@ -0,0 +1,151 @@
+/**********************************************************//**
+ * @file stats.c
+ * @brief Implementation of the runtime counters.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "field.h"
+#include "stats.h"
+
+/**************************************************************/
+__thread STATS_COUNTERS StatsLocal;
+bool StatsTiming = false;
+__thread int StatsCountdown = 0;
+
+/// The counters of the threads that are done.
+static STATS_COUNTERS Totals;
+
+#ifdef STATS
+/// Guards the totals.
+static pthread_mutex_t TotalsLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/**********************************************************//**
+ * @brief Start timing the turns and games. This must be done
+ * before any games start.
+ * @return Whether this build has the counters.
+ **************************************************************/
+bool stats_Enable(void) {
+#ifdef STATS
+    StatsTiming = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**********************************************************//**
+ * @brief Add the counters of this thread to the totals, and
+ * clear them. Each thread does this once it is done.
+ **************************************************************/
+void stats_Flush(void) {
+#ifdef STATS
+    const uint64_t *local = (const uint64_t *)&StatsLocal;
+    uint64_t *total = (uint64_t *)&Totals;
+    pthread_mutex_lock(&TotalsLock);
+    for (size_t i = 0; i < sizeof(STATS_COUNTERS)/sizeof(uint64_t); i++) {
+        total[i] += local[i];
+    }
+    pthread_mutex_unlock(&TotalsLock);
+    memset(&StatsLocal, 0, sizeof(STATS_COUNTERS));
+#endif
+}
+
+/**********************************************************//**
+ * @brief Get the bucket below which a fraction of a histogram
+ * falls.
+ * @param histogram: The histogram.
+ * @param buckets: The number of buckets.
+ * @param count: The total count of the histogram.
+ * @param fraction: The fraction.
+ * @return The bucket.
+ **************************************************************/
+static int stats_GetPercentile(const uint64_t *histogram, int buckets, uint64_t count, double fraction) {
+    uint64_t rank = (uint64_t)(fraction*count);
+    if (rank >= count) {
+        rank = count-1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < buckets; i++) {
+        seen += histogram[i];
+        if (seen > rank) {
+            return i;
+        }
+    }
+    return buckets-1;
+}
+
+/**********************************************************//**
+ * @brief Write one latency histogram: its percentiles as the
+ * upper end of their bucket, then each bucket that isn't empty.
+ * @param file: The file to write to.
+ * @param name: The name of the histogram.
+ * @param histogram: The histogram.
+ * @param every: One in this many events was timed.
+ **************************************************************/
+static void stats_WriteTime(FILE *file, const char *name, const uint64_t histogram[STATS_BUCKETS], int every) {
+    uint64_t count = 0;
+    for (int i = 0; i < STATS_BUCKETS; i++) {
+        count += histogram[i];
+    }
+    fprintf(file, "stats %s count %llu", name, (unsigned long long)count);
+    if (every > 1) {
+        fprintf(file, " every %d", every);
+    }
+    if (count) {
+        static const double fraction[] = {0.5, 0.9, 0.99, 1.0};
+        static const char *label[] = {"p50", "p90", "p99", "max"};
+        for (int i = 0; i < 4; i++) {
+            int bucket = stats_GetPercentile(histogram, STATS_BUCKETS, count, fraction[i]);
+            fprintf(file, " %s<%llu", label[i], 1ull << bucket);
+        }
+    }
+    fprintf(file, "\n");
+    for (int i = 0; i < STATS_BUCKETS; i++) {
+        if (histogram[i]) {
+            fprintf(file, "hist %s <%llu %llu\n", name, 1ull << i, (unsigned long long)histogram[i]);
+        }
+    }
+}
+
+/**********************************************************//**
+ * @brief Write the totals of the counters. The threads that
+ * counted must have flushed them first.
+ * @param file: The file to write to.
+ **************************************************************/
+void stats_Write(FILE *file) {
+    const STATS_COUNTERS *total = &Totals;
+    fprintf(file, "stats extents %llu\n", (unsigned long long)total->extents);
+    fprintf(file, "stats retries %llu\n", (unsigned long long)total->retries);
+    fprintf(file, "stats attacks miss %llu hit %llu sunk %llu\n",
+        (unsigned long long)total->attacks[MISS], (unsigned long long)total->attacks[HIT],
+        (unsigned long long)total->attacks[SUNK]);
+
+    // Turns per game, exactly
+    uint64_t games = 0;
+    uint64_t turns = 0;
+    for (int i = 0; i <= TURN_MAX; i++) {
+        games += total->turns[i];
+        turns += total->turns[i]*i;
+    }
+    fprintf(file, "stats games %llu turns %llu", (unsigned long long)games, (unsigned long long)turns);
+    if (games) {
+        fprintf(file, " p50 %d p90 %d p99 %d max %d",
+            stats_GetPercentile(total->turns, TURN_MAX+1, games, 0.5),
+            stats_GetPercentile(total->turns, TURN_MAX+1, games, 0.9),
+            stats_GetPercentile(total->turns, TURN_MAX+1, games, 0.99),
+            stats_GetPercentile(total->turns, TURN_MAX+1, games, 1.0));
+    }
+    fprintf(file, "\n");
+    stats_WriteTime(file, "turn_ns", total->turnTime, STATS_SAMPLE);
+    stats_WriteTime(file, "game_ns", total->gameTime, 1);
+}
+
+/**************************************************************/
@@ -0,0 +1,134 @@
+/**********************************************************//**
+ * @file stats.h
+ * @brief Runtime counters and latency histograms. Each thread
+ * counts into its own block, which it adds to the totals once
+ * when it is done, so counting never contends between threads.
+ * Building without the STATS macro removes the counting.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+// field.h includes this file for the counter in
+// field_GetExtentSized, once it has defined the sizes the
+// counters need; so field.h must come first either way.
+#include "field.h"
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/**************************************************************/
+/// @brief The number of latency buckets; bucket k counts times
+/// of 2^(k-1) to 2^k - 1 nanoseconds.
+#define STATS_BUCKETS 48
+
+/// @brief Only one in this many turns is timed, so reading the
+/// clock costs next to nothing next to turns of under a
+/// microsecond. Whole games are all timed.
+#define STATS_SAMPLE 64
+
+/**********************************************************//**
+ * @struct STATS_COUNTERS
+ * @brief The counters of one thread, or the totals.
+ **************************************************************/
+typedef struct {
+    /// @brief Run extents computed: field_GetExtentSized calls,
+    /// plus the extents the vector kernels compute per lane.
+    uint64_t extents;
+    /// Times field_CreateRandom ran out of room and started over.
+    uint64_t retries;
+    /// Attacks by their result.
+    uint64_t attacks[N_STATUS];
+    /// Games finished, by the number of turns they took.
+    uint64_t turns[TURN_MAX+1];
+    /// Time taken by every STATS_SAMPLE-th AI turn.
+    uint64_t turnTime[STATS_BUCKETS];
+    /// Time taken by each whole game.
+    uint64_t gameTime[STATS_BUCKETS];
+} STATS_COUNTERS;
+
+/// The counters of this thread.
+extern __thread STATS_COUNTERS StatsLocal;
+
+/// Whether the turns and games are being timed.
+extern bool StatsTiming;
+
+/// The turns of this thread left until one is timed.
+extern __thread int StatsCountdown;
+
+/**********************************************************//**
+ * @def STATS_ADD
+ * @brief Add to a counter of this thread.
+ * @param counter: The member of STATS_COUNTERS.
+ * @param n: The amount to add.
+ **************************************************************/
+#ifdef STATS
+#define STATS_ADD(counter, n) (StatsLocal.counter += (n))
+#else
+#define STATS_ADD(counter, n) (void)0
+#endif
+
+/**********************************************************//**
+ * @brief Read the clock for timing, if timing is on.
+ * @return The time in nanoseconds, or 0.
+ **************************************************************/
+static inline uint64_t stats_Start(void) {
+#ifdef STATS
+    if (StatsTiming) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t)now.tv_sec*1000000000u + (uint64_t)now.tv_nsec;
+    }
+#endif
+    return 0;
+}
+
+/**********************************************************//**
+ * @brief Read the clock for timing a turn, if timing is on and
+ * it is this thread's turn to be sampled.
+ * @return The time in nanoseconds, or 0 if the turn isn't
+ * timed.
+ **************************************************************/
+static inline uint64_t stats_StartSample(void) {
+#ifdef STATS
+    if (StatsTiming && --StatsCountdown <= 0) {
+        StatsCountdown = STATS_SAMPLE;
+        return stats_Start();
+    }
+#endif
+    return 0;
+}
+
+/**********************************************************//**
+ * @brief Count a time in a latency histogram.
+ * @param histogram: The histogram, of STATS_BUCKETS buckets.
+ * @param start: The time the interval started, from
+ * stats_Start or stats_StartSample; 0 counts nothing.
+ * @param count: The number of events the interval holds. Each
+ * is counted as taking an equal share of the time.
+ **************************************************************/
+static inline void stats_AddTime(uint64_t histogram[STATS_BUCKETS], uint64_t start, int count) {
+#ifdef STATS
+    if (start && count > 0) {
+        uint64_t time = (stats_Start() - start) / (uint64_t)count;
+        int bucket = time? 64 - __builtin_clzll(time): 0;
+        histogram[(bucket < STATS_BUCKETS)? bucket: STATS_BUCKETS-1] += (uint64_t)count;
+    }
+#else
+    (void)histogram;
+    (void)start;
+    (void)count;
+#endif
+}
+
+/**************************************************************/
+extern bool stats_Enable(void);
+extern void stats_Flush(void);
+extern void stats_Write(FILE *file);
+
+/**************************************************************/
+#endif // _STATS_H_
@@ -0,0 +1,203 @@
+/**********************************************************//**
+ * @file strategy.c
+ * @brief The registry of AIs.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ai.h"
+#include "book.h"
+#include "debug.h"
+#include "density.h"
+#include "endgame.h"
+#include "memo.h"
+#include "field.h"
+#include "montecarlo.h"
+#include "strategy.h"
+
+/**********************************************************//**
+ * @brief The heuristic AI's choose hook.
+ * @param state: Unused.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+static bool heuristic_Choose(void *state, const FIELD *field, int *x, int *y) {
+    (void)state;
+    return memo_ChooseTile(field, x, y);
+}
+
+/**********************************************************//**
+ * @brief The density AI's choose hook.
+ * @param state: Unused.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+static bool density_Choose(void *state, const FIELD *field, int *x, int *y) {
+    (void)state;
+    return density_ChooseTile(field, x, y);
+}
+
+/**********************************************************//**
+ * @brief The opening book AI's choose hook.
+ * @param state: Unused.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+static bool book_Choose(void *state, const FIELD *field, int *x, int *y) {
+    (void)state;
+    return book_ChooseTile(field, x, y);
+}
+
+/**********************************************************//**
+ * @brief The Monte Carlo AI's init hook: keep the game seed.
+ * @param state: The seed of the game.
+ * @param field: Unused.
+ * @param seed: The seed of the game.
+ **************************************************************/
+static void montecarlo_Init(void *state, const FIELD *field, uint64_t seed) {
+    (void)field;
+    *(uint64_t *)state = seed;
+}
+
+/**********************************************************//**
+ * @brief The Monte Carlo AI's choose hook.
+ * @param state: The seed of the game.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+static bool montecarlo_Choose(void *state, const FIELD *field, int *x, int *y) {
+    return montecarlo_ChooseTile(field, *(uint64_t *)state, x, y);
+}
+
+/**********************************************************//**
+ * @brief The endgame AI's init hook.
+ * @param state: The endgame state.
+ * @param field: Unused.
+ * @param seed: Unused.
+ **************************************************************/
+static void endgame_InitState(void *state, const FIELD *field, uint64_t seed) {
+    (void)field;
+    (void)seed;
+    endgame_Init(state);
+}
+
+/**********************************************************//**
+ * @brief The endgame AI's choose hook.
+ * @param state: The endgame state.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+static bool endgame_Choose(void *state, const FIELD *field, int *x, int *y) {
+    return endgame_ChooseTile(state, field, x, y);
+}
+
+/**************************************************************/
+/// All the AIs, the default first.
+static const STRATEGY Strategies[] = {
+    {
+        .name = "heuristic",
+        .stateSize = 0,
+        .init = NULL,
+        .choose = heuristic_Choose,
+        .reset = NULL,
+    },
+    {
+        .name = "density",
+        .stateSize = 0,
+        .init = NULL,
+        .choose = density_Choose,
+        .reset = NULL,
+    },
+    {
+        .name = "montecarlo",
+        .stateSize = sizeof(uint64_t),
+        .init = montecarlo_Init,
+        .choose = montecarlo_Choose,
+        .reset = NULL,
+    },
+    {
+        .name = "endgame",
+        .stateSize = sizeof(ENDGAME_STATE),
+        .init = endgame_InitState,
+        .choose = endgame_Choose,
+        .reset = NULL,
+    },
+    {
+        .name = "book",
+        .stateSize = 0,
+        .init = NULL,
+        .choose = book_Choose,
+        .reset = NULL,
+    },
+};
+
+/**********************************************************//**
+ * @brief Get an AI from the registry by position.
+ * @param i: The position of the AI (0 is the default).
+ * @return The AI, or NULL past the end of the registry.
+ **************************************************************/
+const STRATEGY *strategy_Get(int i) {
+    if (i < 0 || i >= (int)(sizeof(Strategies)/sizeof(Strategies[0]))) {
+        return NULL;
+    }
+    return &Strategies[i];
+}
+
+/**********************************************************//**
+ * @brief Get an AI from the registry by name.
+ * @param name: The name of the AI.
+ * @return The AI, or NULL if there is none by that name.
+ **************************************************************/
+const STRATEGY *strategy_Find(const char *name) {
+    for (int i = 0; strategy_Get(i); i++) {
+        if (!strcmp(strategy_Get(i)->name, name)) {
+            return strategy_Get(i);
+        }
+    }
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Play one turn of a game with an AI.
+ * @param strategy: The AI to play with.
+ * @param state: The AI's state for this game.
+ * @param field: The field to take a turn on.
+ * @return Whether the gameplay succeeded.
+ **************************************************************/
+bool strategy_PlayTurn(const STRATEGY *strategy, void *state, FIELD *field) {
+    int tileX;
+    int tileY;
+    if (!strategy->choose(state, field, &tileX, &tileY)) {
+        eprintf("The %s AI couldn't choose a tile.\n", strategy->name);
+        return false;
+    }
+
+    // Make attack
+    STATUS result = field_Attack(field, tileX, tileY);
+    if (result == ERROR) {
+        eprintf("Attack at (%d, %d) failed.\n", tileX, tileY);
+        return false;
+    }
+
+    // Sanity check after attacking
+    assert(field_GetStatus(field, tileX, tileY) != UNTRIED);
+    assert(field_GetStatus(field, tileX, tileY) == result);
+    return true;
+}
+
+/**************************************************************/
@@ -0,0 +1,46 @@
+/**********************************************************//**
+ * @file strategy.h
+ * @brief A common interface to every AI, and a registry of
+ * them by name, so the AI can be picked at runtime.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _STRATEGY_H_
+#define _STRATEGY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "field.h"
+
+/**********************************************************//**
+ * @struct STRATEGY
+ * @brief One AI. Each game an AI plays gets its own private
+ * state of stateSize bytes, which the hooks work on. The state
+ * is zeroed when it is allocated, then reused from one game to
+ * the next on the same thread.
+ **************************************************************/
+typedef struct {
+    /// The name of the AI on the command line.
+    const char *name;
+    /// The size of the per-game state in bytes (may be 0).
+    size_t stateSize;
+    /// @brief Set up the state for a new game (may be NULL).
+    /// The seed is different for every game of a run.
+    void (*init)(void *state, const FIELD *field, uint64_t seed);
+    /// @brief Choose the tile to attack next. Returns false if
+    /// there is no tile to attack.
+    bool (*choose)(void *state, const FIELD *field, int *x, int *y);
+    /// Clean up the state after a game (may be NULL).
+    void (*reset)(void *state);
+} STRATEGY;
+
+/**************************************************************/
+extern const STRATEGY *strategy_Get(int i);
+extern const STRATEGY *strategy_Find(const char *name);
+extern bool strategy_PlayTurn(const STRATEGY *strategy, void *state, FIELD *field);
+
+/**************************************************************/
+#endif // _STRATEGY_H_
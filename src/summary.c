@@ -0,0 +1,320 @@
+/**********************************************************//**
+ * @file summary.c
+ * @brief Implementation of the streaming statistics.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail The report is a text file of one record per line.
+ * The "stat" lines are derived for reading; only the "games"
+ * and "hist" lines are read back, so reports of separate runs
+ * merge exactly. The "field" and "fleet" lines must match the
+ * configured rules for a report to be read back.
+ **************************************************************/
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "field.h"
+#include "summary.h"
+
+/**************************************************************/
+/// The longest line in a report.
+#define SUMMARY_LINE_MAX (16 + 24*(TURN_MAX+1))
+
+/// The longest ship name in a report.
+#define SUMMARY_NAME_MAX 32
+
+/**********************************************************//**
+ * @brief Get the name of a ship in a report: its name in the
+ * fleet, in lower case.
+ * @param ship: The ship.
+ * @param name: Output parameter for the name.
+ **************************************************************/
+static void summary_GetShipName(SHIP ship, char name[SUMMARY_NAME_MAX]) {
+    const char *shipName = field_GetShipName(ship);
+    int i = 0;
+    for (; shipName[i] && i < SUMMARY_NAME_MAX-1; i++) {
+        name[i] = (char)tolower((unsigned char)shipName[i]);
+    }
+    name[i] = '\0';
+}
+
+/**********************************************************//**
+ * @brief Empty a summary.
+ * @param summary: The summary to clear.
+ **************************************************************/
+void summary_Clear(SUMMARY *summary) {
+    memset(summary, 0, sizeof(SUMMARY));
+}
+
+/**********************************************************//**
+ * @brief Add one finished game to a summary.
+ * @param summary: The summary to add to.
+ * @param turns: The number of turns the game took.
+ * @param sinkTurn: The turn each ship sank.
+ **************************************************************/
+void summary_Add(SUMMARY *summary, int turns, const int sinkTurn[N_SHIPS_MAX]) {
+    assert(0 <= turns && turns <= TURN_MAX);
+    summary->games++;
+    summary->turns[turns]++;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        assert(0 <= sinkTurn[ship] && sinkTurn[ship] <= TURN_MAX);
+        summary->sinkTurn[ship][sinkTurn[ship]]++;
+    }
+}
+
+/**********************************************************//**
+ * @brief Add all the games of one summary to another.
+ * @param summary: The summary to add to.
+ * @param other: The summary to add.
+ **************************************************************/
+void summary_Merge(SUMMARY *summary, const SUMMARY *other) {
+    summary->games += other->games;
+    for (int i = 0; i <= TURN_MAX; i++) {
+        summary->turns[i] += other->turns[i];
+        for (SHIP ship = 0; ship < N_SHIPS_MAX; ship++) {
+            summary->sinkTurn[ship][i] += other->sinkTurn[ship][i];
+        }
+    }
+}
+
+/**********************************************************//**
+ * @brief Get the statistics of one histogram. Percentile p is
+ * the smallest value at least p% of the games are under or at.
+ * @param histogram: How many games had each value.
+ * @param stats: Output parameter for the statistics; all zero
+ * if the histogram is empty.
+ **************************************************************/
+void summary_GetStatistics(const uint64_t histogram[TURN_MAX+1], STATISTICS *stats) {
+    memset(stats, 0, sizeof(STATISTICS));
+    uint64_t count = 0;
+    double sum = 0;
+    for (int i = 0; i <= TURN_MAX; i++) {
+        count += histogram[i];
+        sum += (double)histogram[i] * i;
+    }
+    if (count == 0) {
+        return;
+    }
+    stats->mean = sum / count;
+    for (int i = 0; i <= TURN_MAX; i++) {
+        double deviation = i - stats->mean;
+        stats->variance += (double)histogram[i] * deviation * deviation;
+    }
+    stats->variance /= count;
+
+    // Walk the cumulative counts for the order statistics
+    uint64_t target50 = (count*50 + 99) / 100;
+    uint64_t target90 = (count*90 + 99) / 100;
+    uint64_t target99 = (count*99 + 99) / 100;
+    uint64_t seen = 0;
+    stats->min = -1;
+    for (int i = 0; i <= TURN_MAX; i++) {
+        if (histogram[i] == 0) {
+            continue;
+        }
+        if (stats->min < 0) {
+            stats->min = i;
+        }
+        uint64_t before = seen;
+        seen += histogram[i];
+        stats->p50 = (before < target50)? i: stats->p50;
+        stats->p90 = (before < target90)? i: stats->p90;
+        stats->p99 = (before < target99)? i: stats->p99;
+        stats->max = i;
+    }
+}
+
+/**********************************************************//**
+ * @brief Get the fraction of all attacks that hit a ship.
+ * Every won game hits each ship tile exactly once.
+ * @param summary: The summary in question.
+ * @return The hit rate, or 0 if there are no games.
+ **************************************************************/
+double summary_GetHitRate(const SUMMARY *summary) {
+    int fleetTiles = 0;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        fleetTiles += field_GetShipLength(ship);
+    }
+    double attacks = 0;
+    for (int i = 0; i <= TURN_MAX; i++) {
+        attacks += (double)summary->turns[i] * i;
+    }
+    return (attacks > 0)? (double)summary->games * fleetTiles / attacks: 0;
+}
+
+/**********************************************************//**
+ * @brief Write the statistics line of one histogram.
+ * @param name: The name of the histogram.
+ * @param histogram: The histogram.
+ * @param file: The file to write to.
+ **************************************************************/
+static void summary_WriteStatistics(const char *name, const uint64_t histogram[TURN_MAX+1], FILE *file) {
+    STATISTICS stats;
+    summary_GetStatistics(histogram, &stats);
+    fprintf(file, "stat %s mean %.4f variance %.4f min %d p50 %d p90 %d p99 %d max %d\n",
+        name, stats.mean, stats.variance, stats.min, stats.p50, stats.p90, stats.p99, stats.max);
+}
+
+/**********************************************************//**
+ * @brief Write the histogram line of one histogram, listing
+ * only the values that occurred, as value:count.
+ * @param name: The name of the histogram.
+ * @param histogram: The histogram.
+ * @param file: The file to write to.
+ **************************************************************/
+static void summary_WriteHistogram(const char *name, const uint64_t histogram[TURN_MAX+1], FILE *file) {
+    fprintf(file, "hist %s", name);
+    for (int i = 0; i <= TURN_MAX; i++) {
+        if (histogram[i]) {
+            fprintf(file, " %d:%llu", i, (unsigned long long)histogram[i]);
+        }
+    }
+    fprintf(file, "\n");
+}
+
+/**********************************************************//**
+ * @brief Write a summary as a report that summary_Read can
+ * read back.
+ * @param summary: The summary to write.
+ * @param file: The file to write to.
+ **************************************************************/
+void summary_Write(const SUMMARY *summary, FILE *file) {
+    char name[SUMMARY_NAME_MAX];
+    fprintf(file, "field %d\n", field_GetSize());
+    fprintf(file, "fleet %s\n", FieldRules.fleet->name);
+    fprintf(file, "games %llu\n", (unsigned long long)summary->games);
+    fprintf(file, "hit_rate %.6f\n", summary_GetHitRate(summary));
+    summary_WriteStatistics("turns", summary->turns, file);
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        summary_GetShipName(ship, name);
+        summary_WriteStatistics(name, summary->sinkTurn[ship], file);
+    }
+    summary_WriteHistogram("turns", summary->turns, file);
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        summary_GetShipName(ship, name);
+        summary_WriteHistogram(name, summary->sinkTurn[ship], file);
+    }
+}
+
+/**********************************************************//**
+ * @brief Write a one-line progress snapshot of a summary.
+ * @param summary: The summary to write.
+ * @param file: The file to write to.
+ **************************************************************/
+void summary_WriteSnapshot(const SUMMARY *summary, FILE *file) {
+    STATISTICS stats;
+    summary_GetStatistics(summary->turns, &stats);
+    fprintf(file, "games %llu mean %.4f variance %.4f p50 %d p99 %d hit_rate %.6f\n",
+        (unsigned long long)summary->games, stats.mean, stats.variance,
+        stats.p50, stats.p99, summary_GetHitRate(summary));
+    fflush(file);
+}
+
+/**********************************************************//**
+ * @brief Read a report written by summary_Write. The report
+ * must name the game count and the field size and fleet, which
+ * must be the ones configured.
+ * @param summary: Output parameter for the summary.
+ * @param file: The file to read from.
+ * @return Whether the report was valid.
+ **************************************************************/
+bool summary_Read(SUMMARY *summary, FILE *file) {
+    summary_Clear(summary);
+    char *line = malloc(SUMMARY_LINE_MAX);
+    if (!line) {
+        fprintf(stderr, "Failed to allocate a line buffer.\n");
+        return false;
+    }
+    bool success = true;
+    bool hasGames = false;
+    bool hasField = false;
+    bool hasFleet = false;
+    while (success && fgets(line, SUMMARY_LINE_MAX, file)) {
+        char name[SUMMARY_NAME_MAX];
+        int length;
+        unsigned long long games;
+        int size;
+        if (sscanf(line, "games %llu", &games) == 1) {
+            summary->games = games;
+            hasGames = true;
+            continue;
+        }
+        if (sscanf(line, "field %d", &size) == 1) {
+            success = (size == field_GetSize());
+            if (!success) {
+                fprintf(stderr, "The report is for a %dx%d field, not %dx%d.\n",
+                    size, size, field_GetSize(), field_GetSize());
+            }
+            hasField = true;
+            continue;
+        }
+        if (sscanf(line, "fleet %31s", name) == 1) {
+            success = !strcmp(name, FieldRules.fleet->name);
+            if (!success) {
+                fprintf(stderr, "The report is for the %s fleet, not %s.\n", name, FieldRules.fleet->name);
+            }
+            hasFleet = true;
+            continue;
+        }
+        if (sscanf(line, "hist %31s%n", name, &length) != 1) {
+            continue;
+        }
+
+        // Find the histogram by name
+        uint64_t *histogram = NULL;
+        if (!strcmp(name, "turns")) {
+            histogram = summary->turns;
+        }
+        for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+            char shipName[SUMMARY_NAME_MAX];
+            summary_GetShipName(ship, shipName);
+            if (!strcmp(name, shipName)) {
+                histogram = summary->sinkTurn[ship];
+            }
+        }
+        if (!histogram) {
+            fprintf(stderr, "Unknown histogram \"%s\".\n", name);
+            success = false;
+            break;
+        }
+
+        // Read the value:count pairs
+        const char *cursor = line + length;
+        int value;
+        unsigned long long count;
+        int used;
+        while (sscanf(cursor, " %d:%llu%n", &value, &count, &used) == 2) {
+            if (value < 0 || value > TURN_MAX) {
+                fprintf(stderr, "Value %d out of range.\n", value);
+                success = false;
+                break;
+            }
+            histogram[value] += count;
+            cursor += used;
+        }
+    }
+    free(line);
+    if (success && (!hasGames || !hasField || !hasFleet)) {
+        fprintf(stderr, "The report doesn't name its game count, field size and fleet.\n");
+        success = false;
+    }
+
+    // The turn histogram must account for every game
+    uint64_t total = 0;
+    for (int i = 0; i <= TURN_MAX; i++) {
+        total += summary->turns[i];
+    }
+    if (success && total != summary->games) {
+        fprintf(stderr, "The report has %llu games but %llu turn counts.\n",
+            (unsigned long long)summary->games, (unsigned long long)total);
+        success = false;
+    }
+    return success;
+}
+
+/**************************************************************/
@@ -0,0 +1,65 @@
+/**********************************************************//**
+ * @file summary.h
+ * @brief Streaming statistics of a run, in constant memory.
+ * Exact histograms of the turn counts and of each ship's sink
+ * turn are kept, from which the mean, variance and percentiles
+ * follow. Summaries of several workers or runs can be merged.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#ifndef _SUMMARY_H_
+#define _SUMMARY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "field.h"
+
+/**********************************************************//**
+ * @struct SUMMARY
+ * @brief Aggregated results of any number of games.
+ **************************************************************/
+typedef struct {
+    /// The number of games.
+    uint64_t games;
+    /// How many games took each number of turns.
+    uint64_t turns[TURN_MAX+1];
+    /// How many games sank each ship on each turn.
+    uint64_t sinkTurn[N_SHIPS_MAX][TURN_MAX+1];
+} SUMMARY;
+
+/**********************************************************//**
+ * @struct STATISTICS
+ * @brief Statistics of one histogram of a summary.
+ **************************************************************/
+typedef struct {
+    /// The mean.
+    double mean;
+    /// The population variance.
+    double variance;
+    /// The smallest value.
+    int min;
+    /// The median.
+    int p50;
+    /// The 90th percentile.
+    int p90;
+    /// The 99th percentile.
+    int p99;
+    /// The largest value.
+    int max;
+} STATISTICS;
+
+/**************************************************************/
+extern void summary_Clear(SUMMARY *summary);
+extern void summary_Add(SUMMARY *summary, int turns, const int sinkTurn[N_SHIPS_MAX]);
+extern void summary_Merge(SUMMARY *summary, const SUMMARY *other);
+extern void summary_GetStatistics(const uint64_t histogram[TURN_MAX+1], STATISTICS *stats);
+extern double summary_GetHitRate(const SUMMARY *summary);
+extern void summary_Write(const SUMMARY *summary, FILE *file);
+extern void summary_WriteSnapshot(const SUMMARY *summary, FILE *file);
+extern bool summary_Read(SUMMARY *summary, FILE *file);
+
+/**************************************************************/
+#endif // _SUMMARY_H_
@@ -0,0 +1,430 @@
+/**********************************************************//**
+ * @file adversary.c
+ * @brief Adversarial layout search. Looks for the fleet
+ * layouts an AI needs the most turns to sink, by simulated
+ * annealing over the ships' placements, and saves the hardest
+ * ones as a ranked corpus that battleship.exe -i replays.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail Each chain starts from a random fleet and, on each
+ * step, moves one ship to a random slot where it fits among
+ * the others. A move is kept if the AI takes at least as many
+ * turns, or else with a chance that falls with the turns lost
+ * and with the temperature, which cools geometrically over the
+ * chain. Chains are independent and each draws from its own
+ * random stream, so the corpus is the same for any number of
+ * threads.
+ **************************************************************/
+
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ai.h"
+#include "corpus.h"
+#include "field.h"
+#include "placement.h"
+#include "rng.h"
+#include "strategy.h"
+
+/**************************************************************/
+/// The file to save the corpus to, or NULL.
+static const char *OutputFilename = NULL;
+
+/// The number of annealing chains.
+static int NumberOfChains = 32;
+
+/// The number of layouts each chain tries.
+static int NumberOfSteps = 10000;
+
+/// The number of threads to run the chains on.
+static int NumberOfThreads = 1;
+
+/// The number of layouts to keep.
+static int NumberOfLayouts = 100;
+
+/// The seed of the search.
+static uint64_t Seed = 1;
+
+/// The temperature the chains start at, in turns.
+static double StartTemperature = 4.0;
+
+/// The temperature the chains end at, in turns.
+static double EndTemperature = 0.1;
+
+/// The AI to play the layouts with.
+static const STRATEGY *Strategy = NULL;
+
+/**********************************************************//**
+ * @struct CHAIN
+ * @brief One annealing chain and the hardest distinct layouts
+ * it found, hardest first.
+ **************************************************************/
+typedef struct {
+    /// The layouts found, NumberOfLayouts at most.
+    LAYOUT *best;
+    /// The number of layouts found.
+    int count;
+    /// The number of layouts played.
+    int played;
+} CHAIN;
+
+/**********************************************************//**
+ * @struct SEARCH
+ * @brief The chains shared by the worker threads.
+ **************************************************************/
+typedef struct {
+    /// Each chain.
+    CHAIN *chain;
+    /// The next chain to claim (accessed atomically).
+    int next;
+    /// Set if any game failed (accessed atomically).
+    bool failed;
+} SEARCH;
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("-h:        Print the help screen.\n");
+    printf("-o <name>: Save the corpus to this file (default: only print it).\n");
+    printf("-n <int>:  Run this number of annealing chains (default: 32).\n");
+    printf("-i <int>:  Layouts each chain tries (default: 10000).\n");
+    printf("-k <int>:  Keep this number of the hardest layouts (default: 100).\n");
+    printf("-j <int>:  Run the chains on this number of threads.\n");
+    printf("-s <int>:  Seed the search (default: 1).\n");
+    printf("-T <num>:  Temperature the chains start at, in turns (default: 4.0).\n");
+    printf("-t <num>:  Temperature the chains end at, in turns (default: 0.1).\n");
+    printf("-a <name>: Search against this AI (default: %s).\n", strategy_Get(0)->name);
+    printf("-W <int>:  Search on a field of this size (default: %d).\n", FIELD_SIZE_DEFAULT);
+    printf("-F <name>: Search with this fleet (default: %s).\n", field_GetFleet(0)->name);
+}
+
+/**********************************************************//**
+ * @brief Reads information from the command-line arguments.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ * @return True if no invalid keywords were encountered.
+ **************************************************************/
+static inline bool parse(int argc, char *argv[]) {
+    Strategy = strategy_Get(0);
+    int fieldSize = FIELD_SIZE_DEFAULT;
+    const FLEET *fleet = field_GetFleet(0);
+    int i = 1;
+    while (i < argc) {
+        const char *keyword = argv[i++];
+        if (!strcmp(keyword, "-o")) {
+            OutputFilename = argv[i++];
+        } else if (!strcmp(keyword, "-n")) {
+            NumberOfChains = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-i")) {
+            NumberOfSteps = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-k")) {
+            NumberOfLayouts = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-j")) {
+            NumberOfThreads = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-s")) {
+            Seed = strtoull(argv[i++], NULL, 0);
+        } else if (!strcmp(keyword, "-T")) {
+            StartTemperature = atof(argv[i++]);
+        } else if (!strcmp(keyword, "-t")) {
+            EndTemperature = atof(argv[i++]);
+        } else if (!strcmp(keyword, "-a")) {
+            Strategy = strategy_Find(argv[i++]);
+            if (!Strategy) {
+                fprintf(stderr, "Unknown AI \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else if (!strcmp(keyword, "-W")) {
+            fieldSize = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-F")) {
+            fleet = field_FindFleet(argv[i++]);
+            if (!fleet) {
+                fprintf(stderr, "Unknown fleet \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if (!field_Configure(fieldSize, fleet)) {
+        fprintf(stderr, "The %s fleet can't play on a field of size %d.\n", fleet->name, fieldSize);
+        return false;
+    }
+    if (StartTemperature <= 0 || EndTemperature <= 0) {
+        fprintf(stderr, "The temperatures must be positive.\n");
+        return false;
+    }
+    return NumberOfChains > 0 && NumberOfSteps > 0 && NumberOfLayouts > 0 && ai_Configure(KERNEL_AUTO);
+}
+
+/**********************************************************//**
+ * @brief Play a layout with the AI.
+ * @param fleet: Where each ship lies.
+ * @param seed: The seed of the AI's state.
+ * @param state: Space for the AI's state.
+ * @return The turns taken, or -1 if the game failed.
+ **************************************************************/
+static int adversary_Play(const PLACEMENT fleet[N_SHIPS_MAX], uint64_t seed, void *state) {
+    FIELD field;
+    field_Clear(&field);
+    if (!field_CreateFleet(&field, fleet)) {
+        return -1;
+    }
+    if (Strategy->init) {
+        Strategy->init(state, &field, seed);
+    }
+    while (!field_IsWon(&field)) {
+        if (!strategy_PlayTurn(Strategy, state, &field)) {
+            return -1;
+        }
+    }
+    if (Strategy->reset) {
+        Strategy->reset(state);
+    }
+    return field.turns;
+}
+
+/**********************************************************//**
+ * @brief Keep a layout among a chain's hardest, unless the
+ * chain already has it.
+ * @param chain: The chain.
+ * @param turns: The turns the layout took.
+ * @param fleet: Where each ship lies.
+ **************************************************************/
+static void adversary_Keep(CHAIN *chain, int turns, const PLACEMENT fleet[N_SHIPS_MAX]) {
+    if (chain->count == NumberOfLayouts && turns <= chain->best[chain->count-1].turns) {
+        return;
+    }
+    size_t size = field_GetShipCount()*sizeof(PLACEMENT);
+    for (int i = 0; i < chain->count; i++) {
+        if (!memcmp(chain->best[i].fleet, fleet, size)) {
+            return;
+        }
+    }
+
+    // Insert it in order, after the layouts at least as hard
+    int i = (chain->count < NumberOfLayouts)? chain->count++: chain->count-1;
+    while (i > 0 && chain->best[i-1].turns < turns) {
+        chain->best[i] = chain->best[i-1];
+        i--;
+    }
+    chain->best[i].turns = turns;
+    memcpy(chain->best[i].fleet, fleet, size);
+}
+
+/**********************************************************//**
+ * @brief Run one annealing chain.
+ * @param chain: The chain, with room for its layouts.
+ * @param index: The index of the chain, which picks its random
+ * stream.
+ * @param state: Space for the AI's state.
+ * @return Whether every game succeeded.
+ **************************************************************/
+static bool adversary_Anneal(CHAIN *chain, int index, void *state) {
+    RNG rng;
+    rng_Seed(&rng, Seed, (uint64_t)index);
+
+    // Start from a random fleet
+    FIELD field;
+    field_Clear(&field);
+    field_CreateRandom(&field, &rng);
+    PLACEMENT fleet[N_SHIPS_MAX];
+    MASK ship[N_SHIPS_MAX];
+    for (SHIP s = 0; s < field_GetShipCount(); s++) {
+        fleet[s] = *field_GetPlacement(&field, s);
+        ship[s] = field.ship[s];
+    }
+    int turns = adversary_Play(fleet, rng_Next(&rng), state);
+    if (turns < 0) {
+        return false;
+    }
+    chain->played++;
+    adversary_Keep(chain, turns, fleet);
+
+    double cooling = pow(EndTemperature/StartTemperature, 1.0/NumberOfSteps);
+    double temperature = StartTemperature;
+    for (int step = 0; step < NumberOfSteps; step++, temperature *= cooling) {
+        // Move one ship to a random slot where it fits
+        SHIP s = rng_Range(&rng, field_GetShipCount());
+        MASK others = mask_Empty();
+        for (SHIP t = 0; t < field_GetShipCount(); t++) {
+            others = (t == s)? others: mask_Or(others, ship[t]);
+        }
+        int count;
+        const SLOT *slot = placement_GetSlots(field_GetShipLength(s), &count);
+        const SLOT *draw = &slot[rng_Range(&rng, count)];
+        if (!mask_IsEmpty(mask_And(draw->mask, others))) {
+            continue;
+        }
+        PLACEMENT moved = fleet[s];
+        MASK movedMask = ship[s];
+        fleet[s] = draw->placement;
+        ship[s] = draw->mask;
+
+        // Keep the move if it is harder, or by chance if not
+        int next = adversary_Play(fleet, rng_Next(&rng), state);
+        if (next < 0) {
+            return false;
+        }
+        chain->played++;
+        double chance = (double)(rng_Next(&rng) >> 11) / (double)(UINT64_C(1) << 53);
+        if (next >= turns || chance < exp((next - turns) / temperature)) {
+            turns = next;
+            adversary_Keep(chain, turns, fleet);
+        } else {
+            fleet[s] = moved;
+            ship[s] = movedMask;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Worker thread: run chains until none are left to
+ * claim.
+ * @param arg: The SEARCH to work on.
+ * @return NULL.
+ **************************************************************/
+static void *adversary_Worker(void *arg) {
+    SEARCH *search = arg;
+    void *state = calloc(1, Strategy->stateSize + 1);
+    if (!state) {
+        __atomic_store_n(&search->failed, true, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    while (!__atomic_load_n(&search->failed, __ATOMIC_RELAXED)) {
+        int index = __atomic_fetch_add(&search->next, 1, __ATOMIC_RELAXED);
+        if (index >= NumberOfChains) {
+            break;
+        }
+        if (!adversary_Anneal(&search->chain[index], index, state)) {
+            __atomic_store_n(&search->failed, true, __ATOMIC_RELAXED);
+        }
+    }
+    free(state);
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Adversarial search main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (!parse(argc, argv)) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+    int threads = (NumberOfThreads > 1)? NumberOfThreads: 1;
+    SEARCH search = {
+        .chain = calloc(NumberOfChains, sizeof(CHAIN)),
+        .next = 0,
+        .failed = false,
+    };
+    LAYOUT *merged = malloc((size_t)NumberOfChains*NumberOfLayouts*sizeof(LAYOUT));
+    pthread_t *worker = malloc(threads*sizeof(pthread_t));
+    bool allocated = search.chain && merged && worker;
+    for (int c = 0; allocated && c < NumberOfChains; c++) {
+        search.chain[c].best = malloc(NumberOfLayouts*sizeof(LAYOUT));
+        allocated = (search.chain[c].best != NULL);
+    }
+    if (!allocated) {
+        fprintf(stderr, "Out of memory.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Run the chains; the calling thread works too
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    while (started < threads-1 && !pthread_create(&worker[started], NULL, adversary_Worker, &search)) {
+        started++;
+    }
+    adversary_Worker(&search);
+    for (int i = 0; i < started; i++) {
+        pthread_join(worker[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (search.failed) {
+        fprintf(stderr, "The %s AI failed to play a layout.\n", Strategy->name);
+        return EXIT_FAILURE;
+    }
+
+    // Merge the chains' layouts, hardest first, in chain order
+    // among equals, and drop the ones more than one chain found.
+    CORPUS corpus = {
+        .size = field_GetSize(),
+        .count = 0,
+        .layout = merged,
+    };
+    strncpy(corpus.fleet, FieldRules.fleet->name, CORPUS_NAME_MAX-1);
+    size_t size = field_GetShipCount()*sizeof(PLACEMENT);
+    int found = 0;
+    for (int c = 0; c < NumberOfChains; c++) {
+        for (int i = 0; i < search.chain[c].count; i++) {
+            const LAYOUT *layout = &search.chain[c].best[i];
+            bool seen = false;
+            for (int j = 0; !seen && j < found; j++) {
+                seen = !memcmp(merged[j].fleet, layout->fleet, size);
+            }
+            if (!seen) {
+                int j = found++;
+                while (j > 0 && merged[j-1].turns < layout->turns) {
+                    merged[j] = merged[j-1];
+                    j--;
+                }
+                merged[j] = *layout;
+            }
+        }
+    }
+    corpus.count = (found < NumberOfLayouts)? found: NumberOfLayouts;
+
+    // Print the ranking
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    double boards = 0;
+    for (int c = 0; c < NumberOfChains; c++) {
+        boards += search.chain[c].played;
+    }
+    printf("Played %.0f layouts in %.2f s (%.0f per second) against the %s AI.\n",
+        boards, seconds, boards / seconds, Strategy->name);
+    for (int i = 0; i < corpus.count; i++) {
+        printf("%d: %d turns:", i+1, merged[i].turns);
+        for (SHIP s = 0; s < field_GetShipCount(); s++) {
+            const PLACEMENT *placement = &merged[i].fleet[s];
+            printf(" %s %d %d %s", field_GetShipName(s), placement->x, placement->y,
+                (placement->view == DOWN)? "down": "right");
+        }
+        printf("\n");
+    }
+
+    // Save the corpus
+    int status = EXIT_SUCCESS;
+    if (OutputFilename) {
+        FILE *file = fopen(OutputFilename, "wb");
+        bool written = file && corpus_Write(&corpus, file);
+        if (!file || fclose(file) || !written) {
+            fprintf(stderr, "Failed to write the corpus \"%s\"\n", OutputFilename);
+            status = EXIT_FAILURE;
+        }
+    }
+    for (int c = 0; c < NumberOfChains; c++) {
+        free(search.chain[c].best);
+    }
+    free(search.chain);
+    free(merged);
+    free(worker);
+    return status;
+}
+
+/**************************************************************/
@@ -0,0 +1,142 @@
+/**********************************************************//**
+ * @file aggregate.c
+ * @brief Reads a binary columnar results file (-f bin) by
+ * memory-mapping it, and prints the same summary report as -r.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "columns.h"
+#include "summary.h"
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("%s <file>: Print the summary of a binary -o file.\n", argv[0]);
+}
+
+/**********************************************************//**
+ * @brief Load one little endian value of a column.
+ * @param column: The column.
+ * @param i: The index of the value.
+ * @param width: The number of bytes per value.
+ * @return The value.
+ **************************************************************/
+static inline __attribute__((always_inline))
+int columns_Load(const unsigned char *column, uint64_t i, int width) {
+    return (width == 1)? column[i]: column[2*i] | (column[2*i+1] << 8);
+}
+
+/**********************************************************//**
+ * @brief Count how often each value occurs in a column. Four
+ * histograms are counted in turns, so runs of equal values
+ * don't wait on each other's increments.
+ * @param column: The column.
+ * @param count: The number of values in the column.
+ * @param width: The number of bytes per value.
+ * @param histogram: Output parameter for the counts.
+ * @return Whether every value was a valid turn.
+ **************************************************************/
+static inline __attribute__((always_inline))
+bool columns_CountSized(const unsigned char *column, uint64_t count, int width, uint64_t histogram[TURN_MAX+1]) {
+    static uint64_t partial[4][UINT16_MAX + 1];
+    memset(partial, 0, sizeof(partial));
+    uint64_t i = 0;
+    for (; i+4 <= count; i += 4) {
+        partial[0][columns_Load(column, i, width)]++;
+        partial[1][columns_Load(column, i+1, width)]++;
+        partial[2][columns_Load(column, i+2, width)]++;
+        partial[3][columns_Load(column, i+3, width)]++;
+    }
+    for (; i < count; i++) {
+        partial[0][columns_Load(column, i, width)]++;
+    }
+
+    bool valid = true;
+    for (size_t value = 0; value <= UINT16_MAX; value++) {
+        uint64_t total = partial[0][value] + partial[1][value] + partial[2][value] + partial[3][value];
+        if (value <= TURN_MAX) {
+            histogram[value] = total;
+        } else if (total > 0) {
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+/**********************************************************//**
+ * @brief Count how often each value occurs in a column, with
+ * a copy of the loop for each width.
+ * @param column: The column.
+ * @param count: The number of values in the column.
+ * @param width: The number of bytes per value.
+ * @param histogram: Output parameter for the counts.
+ * @return Whether every value was a valid turn.
+ **************************************************************/
+static bool columns_Count(const unsigned char *column, uint64_t count, int width, uint64_t histogram[TURN_MAX+1]) {
+    if (width == 1) {
+        return columns_CountSized(column, count, 1, histogram);
+    }
+    return columns_CountSized(column, count, 2, histogram);
+}
+
+/**********************************************************//**
+ * @brief Aggregate tool main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (argc != 2 || !strcmp(argv[1], "-h")) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+    COLUMNS_MAP map;
+    if (!columns_Map(&map, argv[1])) {
+        fprintf(stderr, "\"%s\" is not a valid columns file.\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    // The report names the ships, so play by the file's rules.
+    const FLEET *fleet = field_FindFleet(map.fleet);
+    bool configured = fleet && field_Configure(map.fieldSize, fleet) && (map.ships == field_GetShipCount());
+    for (SHIP ship = 0; configured && ship < map.ships; ship++) {
+        configured = (map.length[ship] == field_GetShipLength(ship));
+    }
+    if (!configured) {
+        fprintf(stderr, "\"%s\" was played with an unknown fleet.\n", argv[1]);
+        columns_Unmap(&map);
+        return EXIT_FAILURE;
+    }
+
+    SUMMARY summary;
+    summary_Clear(&summary);
+    summary.games = map.games;
+    bool valid = columns_Count(map.turns, map.games, map.width, summary.turns);
+    for (SHIP ship = 0; ship < map.ships; ship++) {
+        valid = valid && columns_Count(map.sinkTurn[ship], map.games, map.width, summary.sinkTurn[ship]);
+    }
+    if (!valid) {
+        fprintf(stderr, "\"%s\" has turns out of range.\n", argv[1]);
+        columns_Unmap(&map);
+        return EXIT_FAILURE;
+    }
+
+    printf("seed %llu\n", (unsigned long long)map.seed);
+    summary_Write(&summary, stdout);
+    columns_Unmap(&map);
+    return EXIT_SUCCESS;
+}
+
+/**************************************************************/
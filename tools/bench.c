@@ -0,0 +1,592 @@
+/**********************************************************//**
+ * @file bench.c
+ * @brief Benchmark driver. Measures games per second, the
+ * latency of each AI turn, and the cost of the field kernels,
+ * with fixed seeds and a warm-up phase. Prints the results as
+ * JSON and fails if they regressed against a saved baseline.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ai.h"
+#include "batch.h"
+#include "book.h"
+#include "field.h"
+#include "memo.h"
+#include "packed.h"
+#include "rng.h"
+#include "strategy.h"
+
+/**************************************************************/
+/// The number of games to measure.
+static int NumberOfGames = 20000;
+
+/// The seed of the boards.
+static uint64_t Seed = 1;
+
+/// The AI to measure.
+static const STRATEGY *Strategy = NULL;
+
+/// The baseline file to compare against, or NULL.
+static const char *BaselineFilename = NULL;
+
+/// The file to save the results to, or NULL.
+static const char *SaveFilename = NULL;
+
+/// The relative slowdown that counts as a regression.
+static double Tolerance = 0.10;
+
+/// The implementation of the heuristic's scoring.
+static KERNEL Kernel = KERNEL_AUTO;
+
+/// The games to play in lockstep for games per second, or 0.
+static int NumberOfLanes = 0;
+
+/// The size and eviction policy of the heuristic's memo cache.
+static MEMO Memo = {
+    .capacity = 0,
+    .eviction = MEMO_REPLACE,
+};
+
+/**********************************************************//**
+ * @struct BENCH
+ * @brief The benchmark results.
+ **************************************************************/
+typedef struct {
+    /// Whole games played per second.
+    double gamesPerSecond;
+    /// Median AI turn latency in nanoseconds.
+    double turnP50;
+    /// 99th percentile AI turn latency in nanoseconds.
+    double turnP99;
+    /// Worst AI turn latency in nanoseconds.
+    double turnMax;
+    /// Nanoseconds per field_CreateRandom.
+    double createNs;
+    /// Nanoseconds per field_Attack.
+    double attackNs;
+    /// Nanoseconds per packed_Attack.
+    double packedAttackNs;
+    /// Bytes per game of a FIELD.
+    size_t fieldBytes;
+    /// Bytes per game of a packed field.
+    size_t packedBytes;
+} BENCH;
+
+/**********************************************************//**
+ * @brief Get the current time.
+ * @return The monotonic time in nanoseconds.
+ **************************************************************/
+static inline uint64_t bench_Now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec*1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**********************************************************//**
+ * @brief Set up the board of a game, like the simulator does.
+ * @param game: The index of the game.
+ * @param field: Output parameter for the board.
+ * @return The seed for the AI's state in this game.
+ **************************************************************/
+static uint64_t bench_Setup(int game, FIELD *field) {
+    RNG rng;
+    rng_Seed(&rng, Seed, (uint64_t)game);
+    field_Clear(field);
+    field_CreateRandom(field, &rng);
+    return rng_Next(&rng);
+}
+
+/**********************************************************//**
+ * @brief Play games with the AI.
+ * @param first: The index of the first game.
+ * @param games: The number of games.
+ * @param state: Space for the AI state.
+ * @param latency: If not NULL, output parameter for the time
+ * of each turn. Must have room for games*TURN_MAX turns.
+ * @param turns: Output parameter for the number of turns.
+ * @return Whether all the games succeeded.
+ **************************************************************/
+static bool bench_Play(int first, int games, void *state, uint32_t *latency, size_t *turns) {
+    *turns = 0;
+    for (int game = first; game < first+games; game++) {
+        FIELD field;
+        uint64_t seed = bench_Setup(game, &field);
+        if (Strategy->init) {
+            Strategy->init(state, &field, seed);
+        }
+        while (!field_IsWon(&field)) {
+            uint64_t start = latency? bench_Now(): 0;
+            if (!strategy_PlayTurn(Strategy, state, &field)) {
+                return false;
+            }
+            if (latency) {
+                latency[*turns] = (uint32_t)(bench_Now() - start);
+            }
+            (*turns)++;
+        }
+        if (Strategy->reset) {
+            Strategy->reset(state);
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Play games with the heuristic in lockstep, refilling
+ * each lane as soon as its game is won.
+ * @param first: The index of the first game.
+ * @param games: The number of games.
+ * @return Whether all the games succeeded.
+ **************************************************************/
+static bool bench_PlayBatch(int first, int games) {
+    static BATCH batch;
+    if (!batch_Create(&batch, NumberOfLanes)) {
+        return false;
+    }
+    int move[BATCH_LANES_MAX];
+    int next = first;
+    bool success = true;
+    for (;;) {
+        int playing = 0;
+        for (int lane = 0; lane < batch.lanes; lane++) {
+            if (batch.active[lane] && batch.remaining[lane] == 0) {
+                batch.active[lane] = false;
+            }
+            if (!batch.active[lane] && next < first+games) {
+                FIELD field;
+                bench_Setup(next++, &field);
+                batch_Load(&batch, lane, &field);
+            }
+            playing += batch.active[lane];
+        }
+        if (!playing) {
+            break;
+        }
+        if (!batch_Step(&batch, move)) {
+            success = false;
+            break;
+        }
+    }
+    batch_Free(&batch);
+    return success;
+}
+
+/**********************************************************//**
+ * @brief Compare two latencies for qsort.
+ * @param a: The first latency.
+ * @param b: The second latency.
+ * @return The sort order.
+ **************************************************************/
+static int bench_CompareLatency(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**********************************************************//**
+ * @brief Run all the measurements.
+ * @param bench: Output parameter for the results.
+ * @return Whether the measurements succeeded.
+ **************************************************************/
+static bool bench_Run(BENCH *bench) {
+    int warmup = NumberOfGames/10 + 1;
+    void *state = calloc(1, Strategy->stateSize + 1);
+    uint32_t *latency = malloc((size_t)NumberOfGames*TURN_MAX*sizeof(uint32_t));
+    FIELD *fields = malloc((size_t)NumberOfGames*sizeof(FIELD));
+    unsigned char *packed = malloc((size_t)NumberOfGames*packed_GetSize());
+    if (!state || !latency || !fields || !packed) {
+        fprintf(stderr, "Out of memory.\n");
+        free(state);
+        free(latency);
+        free(fields);
+        free(packed);
+        return false;
+    }
+
+    // Warm up the caches and the placement tables, on games that
+    // aren't measured.
+    size_t turns;
+    bool success = bench_Play(NumberOfGames, warmup, state, NULL, &turns);
+
+    // Whole games per second
+    uint64_t start = bench_Now();
+    if (NumberOfLanes > 0) {
+        success = success && bench_PlayBatch(0, NumberOfGames);
+    } else {
+        success = success && bench_Play(0, NumberOfGames, state, NULL, &turns);
+    }
+    bench->gamesPerSecond = NumberOfGames / ((bench_Now() - start) * 1e-9);
+
+    // Turn latency distribution, on the same games
+    success = success && bench_Play(0, NumberOfGames, state, latency, &turns);
+    if (success) {
+        qsort(latency, turns, sizeof(uint32_t), bench_CompareLatency);
+        bench->turnP50 = latency[turns/2];
+        bench->turnP99 = latency[turns*99/100];
+        bench->turnMax = latency[turns-1];
+    }
+
+    // Random fleet generation
+    start = bench_Now();
+    for (int game = 0; game < NumberOfGames; game++) {
+        bench_Setup(game, &fields[game]);
+    }
+    bench->createNs = (double)(bench_Now() - start) / NumberOfGames;
+
+    // Pack the same boards before they are attacked
+    bench->fieldBytes = sizeof(FIELD);
+    bench->packedBytes = packed_GetSize();
+    for (int game = 0; game < NumberOfGames; game++) {
+        packed_Store((PACKED *)(packed + game*bench->packedBytes), &fields[game]);
+    }
+
+    // Attacks: every tile of every board, in a random order
+    int tiles = field_GetTileCount();
+    int order[TURN_MAX];
+    for (int i = 0; i < tiles; i++) {
+        order[i] = i;
+    }
+    RNG rng;
+    rng_Seed(&rng, Seed, UINT64_MAX);
+    for (int i = tiles-1; i > 0; i--) {
+        int j = rng_Range(&rng, i+1);
+        int swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+    start = bench_Now();
+    for (int game = 0; game < NumberOfGames; game++) {
+        for (int i = 0; i < tiles; i++) {
+            field_Attack(&fields[game], order[i]/field_GetSize(), order[i]%field_GetSize());
+        }
+    }
+    bench->attackNs = (double)(bench_Now() - start) / ((double)NumberOfGames*tiles);
+
+    // The same attacks on the packed boards
+    start = bench_Now();
+    for (int game = 0; game < NumberOfGames; game++) {
+        PACKED *board = (PACKED *)(packed + game*bench->packedBytes);
+        for (int i = 0; i < tiles; i++) {
+            packed_Attack(board, order[i]/field_GetSize(), order[i]%field_GetSize());
+        }
+    }
+    bench->packedAttackNs = (double)(bench_Now() - start) / ((double)NumberOfGames*tiles);
+
+    // Both must have played the same games
+    for (int game = 0; success && game < NumberOfGames; game++) {
+        const PACKED *board = (const PACKED *)(packed + game*bench->packedBytes);
+        success = packed_IsWon(board) && packed_GetTurns(board) == fields[game].turns;
+        for (SHIP ship = 0; success && ship < field_GetShipCount(); ship++) {
+            success = packed_GetSinkTurn(board, ship) == fields[game].sinkTurn[ship];
+        }
+        if (!success) {
+            fprintf(stderr, "The packed field played game %d differently.\n", game+1);
+        }
+    }
+
+    free(state);
+    free(latency);
+    free(fields);
+    free(packed);
+    return success;
+}
+
+/**************************************************************/
+/// The number of settings that make up the configuration.
+#define BENCH_SETTINGS 8
+
+/// The JSON keys of the settings.
+static const char *const SettingKeys[BENCH_SETTINGS] = {
+    "strategy", "games", "seed", "field", "fleet", "kernel", "lanes", "cache",
+};
+
+/**********************************************************//**
+ * @brief Get the configuration the results were measured with,
+ * each setting as it is written in the JSON.
+ * @param value: Output parameter for each setting.
+ **************************************************************/
+static void bench_GetSettings(char value[BENCH_SETTINGS][64]) {
+    snprintf(value[0], 64, "\"%s\"", Strategy->name);
+    snprintf(value[1], 64, "%d", NumberOfGames);
+    snprintf(value[2], 64, "%llu", (unsigned long long)Seed);
+    snprintf(value[3], 64, "%d", field_GetSize());
+    snprintf(value[4], 64, "\"%s\"", FieldRules.fleet->name);
+    snprintf(value[5], 64, "\"%s\"", (ai_GetKernel() == KERNEL_AVX2)? "avx2": "scalar");
+    snprintf(value[6], 64, "%d", NumberOfLanes);
+    snprintf(value[7], 64, "%d", Memo.capacity);
+}
+
+/**********************************************************//**
+ * @brief Write the results as JSON.
+ * @param bench: The results.
+ * @param file: The file to write to.
+ **************************************************************/
+static void bench_Print(const BENCH *bench, FILE *file) {
+    char setting[BENCH_SETTINGS][64];
+    bench_GetSettings(setting);
+    fprintf(file, "{\n");
+    for (int i = 0; i < BENCH_SETTINGS; i++) {
+        fprintf(file, "  \"%s\": %s,\n", SettingKeys[i], setting[i]);
+    }
+    fprintf(file, "  \"games_per_sec\": %.1f,\n", bench->gamesPerSecond);
+    fprintf(file, "  \"turn_p50_ns\": %.0f,\n", bench->turnP50);
+    fprintf(file, "  \"turn_p99_ns\": %.0f,\n", bench->turnP99);
+    fprintf(file, "  \"turn_max_ns\": %.0f,\n", bench->turnMax);
+    fprintf(file, "  \"create_random_ns\": %.1f,\n", bench->createNs);
+    fprintf(file, "  \"attack_ns\": %.2f,\n", bench->attackNs);
+    fprintf(file, "  \"packed_attack_ns\": %.2f,\n", bench->packedAttackNs);
+    fprintf(file, "  \"field_bytes\": %zu,\n", bench->fieldBytes);
+    fprintf(file, "  \"packed_bytes\": %zu,\n", bench->packedBytes);
+    fprintf(file, "  \"field_games_per_gb\": %.0f,\n", (double)(1u << 30) / bench->fieldBytes);
+    fprintf(file, "  \"packed_games_per_gb\": %.0f\n", (double)(1u << 30) / bench->packedBytes);
+    fprintf(file, "}\n");
+}
+
+/**********************************************************//**
+ * @brief Read one number out of a results file.
+ * @param text: The contents of the file.
+ * @param key: The JSON key of the number.
+ * @param value: Output parameter for the number.
+ * @return Whether the key was found.
+ **************************************************************/
+static bool bench_ReadValue(const char *text, const char *key, double *value) {
+    char quoted[64];
+    snprintf(quoted, sizeof(quoted), "\"%s\":", key);
+    const char *found = strstr(text, quoted);
+    return found && sscanf(found + strlen(quoted), "%lf", value) == 1;
+}
+
+/**********************************************************//**
+ * @brief Read one setting out of a results file, as written.
+ * @param text: The contents of the file.
+ * @param key: The JSON key of the setting.
+ * @param value: Output parameter for the setting.
+ * @param size: The room in value.
+ * @return Whether the key was found.
+ **************************************************************/
+static bool bench_ReadSetting(const char *text, const char *key, char *value, size_t size) {
+    char quoted[64];
+    snprintf(quoted, sizeof(quoted), "\"%s\":", key);
+    const char *found = strstr(text, quoted);
+    if (!found) {
+        return false;
+    }
+    found += strlen(quoted) + strspn(found + strlen(quoted), " ");
+    size_t length = strcspn(found, ",\n}");
+    if (length >= size) {
+        return false;
+    }
+    memcpy(value, found, length);
+    value[length] = '\0';
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Compare the results against a saved baseline. Games
+ * per second must not drop, and the median and 99th percentile
+ * turn latency and the kernel costs must not rise, by more than
+ * the tolerance. The maximum latency is too noisy to compare.
+ * The baseline must have been measured with the same settings,
+ * or there is nothing to compare.
+ * @param bench: The results.
+ * @param filename: The baseline file.
+ * @return Whether there was no regression.
+ **************************************************************/
+static bool bench_CheckBaseline(const BENCH *bench, const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Failed to open \"%s\"\n", filename);
+        return false;
+    }
+    char text[4096];
+    size_t length = fread(text, 1, sizeof(text)-1, file);
+    text[length] = '\0';
+    fclose(file);
+
+    char setting[BENCH_SETTINGS][64];
+    bench_GetSettings(setting);
+    bool same = true;
+    for (int i = 0; i < BENCH_SETTINGS; i++) {
+        char baseline[64];
+        if (!bench_ReadSetting(text, SettingKeys[i], baseline, sizeof(baseline))) {
+            fprintf(stderr, "Baseline has no \"%s\".\n", SettingKeys[i]);
+            same = false;
+        } else if (strcmp(baseline, setting[i])) {
+            fprintf(stderr, "Baseline has %s %s, but this run has %s.\n", SettingKeys[i], baseline, setting[i]);
+            same = false;
+        }
+    }
+    if (!same) {
+        fprintf(stderr, "The baseline \"%s\" was measured with other settings.\n", filename);
+        return false;
+    }
+
+    struct {
+        const char *key;
+        double value;
+        bool higherIsBetter;
+    } checks[] = {
+        {"games_per_sec", bench->gamesPerSecond, true},
+        {"turn_p50_ns", bench->turnP50, false},
+        {"turn_p99_ns", bench->turnP99, false},
+        {"create_random_ns", bench->createNs, false},
+        {"attack_ns", bench->attackNs, false},
+    };
+    bool success = true;
+    for (size_t i = 0; i < sizeof(checks)/sizeof(checks[0]); i++) {
+        double baseline;
+        if (!bench_ReadValue(text, checks[i].key, &baseline)) {
+            fprintf(stderr, "Baseline has no \"%s\".\n", checks[i].key);
+            success = false;
+            continue;
+        }
+        double ratio = checks[i].value / baseline;
+        bool regressed = checks[i].higherIsBetter? (ratio < 1.0 - Tolerance): (ratio > 1.0 + Tolerance);
+        if (regressed) {
+            fprintf(stderr, "REGRESSION: %s is %g (baseline %g, %+.1f%%)\n",
+                checks[i].key, checks[i].value, baseline, (ratio - 1.0)*100.0);
+            success = false;
+        }
+    }
+    return success;
+}
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("-h:        Print the help screen.\n");
+    printf("-n <int>:  Measure this number of games.\n");
+    printf("-s <int>:  Seed the random boards (default: 1).\n");
+    printf("-a <name>: Measure this AI (default: %s).\n", strategy_Get(0)->name);
+    printf("-b <name>: Compare against this baseline file.\n");
+    printf("-w <name>: Save the results to this file.\n");
+    printf("-r <num>:  Relative change that fails (default: 0.10).\n");
+    printf("-W <int>:  Play on a field of this size (default: %d).\n", FIELD_SIZE_DEFAULT);
+    printf("-F <name>: Play with this fleet (default: %s).\n", field_GetFleet(0)->name);
+    printf("-x <name>: Score the heuristic with auto, avx2 or scalar code (default: auto).\n");
+    printf("-K <int>:  Play this many heuristic games in lockstep for games per second.\n");
+    printf("-c <int>:  Cache this many of the heuristic's positions (default: 0, off).\n");
+}
+
+/**********************************************************//**
+ * @brief Reads information from the command-line arguments.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ * @return True if no invalid keywords were encountered.
+ **************************************************************/
+static inline bool parse(int argc, char *argv[]) {
+    Strategy = strategy_Get(0);
+    int fieldSize = FIELD_SIZE_DEFAULT;
+    const FLEET *fleet = field_GetFleet(0);
+    int i = 1;
+    while (i < argc) {
+        const char *keyword = argv[i++];
+        if (!strcmp(keyword, "-n")) {
+            NumberOfGames = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-s")) {
+            Seed = strtoull(argv[i++], NULL, 0);
+        } else if (!strcmp(keyword, "-a")) {
+            Strategy = strategy_Find(argv[i++]);
+            if (!Strategy) {
+                fprintf(stderr, "Unknown AI \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else if (!strcmp(keyword, "-b")) {
+            BaselineFilename = argv[i++];
+        } else if (!strcmp(keyword, "-w")) {
+            SaveFilename = argv[i++];
+        } else if (!strcmp(keyword, "-r")) {
+            Tolerance = atof(argv[i++]);
+        } else if (!strcmp(keyword, "-W")) {
+            fieldSize = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-x")) {
+            const char *name = argv[i++];
+            if (!strcmp(name, "avx2")) {
+                Kernel = KERNEL_AVX2;
+            } else if (!strcmp(name, "scalar")) {
+                Kernel = KERNEL_SCALAR;
+            } else if (strcmp(name, "auto")) {
+                fprintf(stderr, "Unknown kernel \"%s\"\n", name);
+                return false;
+            }
+        } else if (!strcmp(keyword, "-K")) {
+            NumberOfLanes = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-c")) {
+            Memo.capacity = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-F")) {
+            fleet = field_FindFleet(argv[i++]);
+            if (!fleet) {
+                fprintf(stderr, "Unknown fleet \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if (NumberOfLanes > 0 && strcmp(Strategy->name, "heuristic")) {
+        fprintf(stderr, "Only the heuristic AI plays games in lockstep.\n");
+        return false;
+    }
+    return NumberOfGames > 0 && field_Configure(fieldSize, fleet) && ai_Configure(Kernel);
+}
+
+/**********************************************************//**
+ * @brief Benchmark main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code; failure on a regression.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (!parse(argc, argv)) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+
+    // The book AI plays from the book for these rules
+    static BOOK book;
+    book_Create(&book);
+    book_Configure(&book);
+    if (!memo_Configure(&Memo)) {
+        fprintf(stderr, "Failed to allocate the cache.\n");
+        return EXIT_FAILURE;
+    }
+
+    BENCH bench;
+    if (!bench_Run(&bench)) {
+        fprintf(stderr, "Benchmark failed.\n");
+        return EXIT_FAILURE;
+    }
+    bench_Print(&bench, stdout);
+    if (Memo.capacity > 0) {
+        memo_WriteCounters(stderr);
+    }
+    if (SaveFilename) {
+        FILE *file = fopen(SaveFilename, "w");
+        if (!file) {
+            fprintf(stderr, "Failed to open \"%s\"\n", SaveFilename);
+            return EXIT_FAILURE;
+        }
+        bench_Print(&bench, file);
+        fclose(file);
+    }
+    if (BaselineFilename && !bench_CheckBaseline(&bench, BaselineFilename)) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**************************************************************/
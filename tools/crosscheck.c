@@ -0,0 +1,442 @@
+/**********************************************************//**
+ * @file crosscheck.c
+ * @brief Differential test of the heuristic's kernels. Checks
+ * the random number streams against known answers, then plays
+ * seeded games on every field size and fleet, and checks that
+ * the afloat ships are ordered hit ones first for the density
+ * and Monte Carlo AIs' enumerations, that
+ * the AVX2 kernel picks the same tile as the scalar code on
+ * every turn, ties included, and that the batch engine plays
+ * every game like the heuristic does on a FIELD, move for move
+ * and tile for tile.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ai.h"
+#include "batch.h"
+#include "field.h"
+#include "placement.h"
+#include "rng.h"
+
+/**************************************************************/
+/// Games to play on each field size and fleet.
+static uint64_t Games = 1000;
+
+/// The seed of the games.
+static uint64_t Seed = 1;
+
+/// Games to play in lockstep in the batch.
+static int Lanes = 16;
+
+/// The field size to check, or 0 to check every size and fleet.
+static int FieldSize = 0;
+
+/// The fleet to check.
+static const FLEET *Fleet = NULL;
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("-h:        Print the help screen.\n");
+    printf("-n <int>:  Play this number of games on each size and fleet (default: 1000).\n");
+    printf("-s <int>:  Seed the games (default: 1).\n");
+    printf("-K <int>:  Play this number of games in lockstep in the batch (default: 16).\n");
+    printf("-W <int>:  Only check a field of this size.\n");
+    printf("-F <name>: Only check this fleet (default: %s).\n", field_GetFleet(0)->name);
+}
+
+/**********************************************************//**
+ * @brief Reads information from the command-line arguments.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ * @return True if no invalid keywords were encountered.
+ **************************************************************/
+static inline bool parse(int argc, char *argv[]) {
+    int i = 1;
+    while (i < argc) {
+        const char *keyword = argv[i++];
+        if (i >= argc) {
+            return false;
+        }
+        if (!strcmp(keyword, "-n")) {
+            Games = strtoull(argv[i++], NULL, 10);
+        } else if (!strcmp(keyword, "-s")) {
+            Seed = strtoull(argv[i++], NULL, 10);
+        } else if (!strcmp(keyword, "-K")) {
+            Lanes = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-W")) {
+            FieldSize = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-F")) {
+            Fleet = field_FindFleet(argv[i++]);
+            if (!Fleet) {
+                fprintf(stderr, "Unknown fleet \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if (Fleet && !FieldSize) {
+        FieldSize = FIELD_SIZE_DEFAULT;
+    }
+    if (FieldSize && !Fleet) {
+        Fleet = field_GetFleet(0);
+    }
+    if (FieldSize && !field_Configure(FieldSize, Fleet)) {
+        fprintf(stderr, "The %s fleet can't play on a field of size %d.\n", Fleet->name, FieldSize);
+        return false;
+    }
+    return Games > 0 && Lanes >= 1 && Lanes <= BATCH_LANES_MAX;
+}
+
+/**********************************************************//**
+ * @brief Check the first outputs of a few streams against
+ * values worked out by hand from the splitmix64 and xoshiro256**
+ * definitions, so a seed gives the same boards everywhere.
+ * @return Whether every output matched.
+ **************************************************************/
+static bool crosscheck_Rng(void) {
+    static const struct {
+        uint64_t seed;
+        uint64_t stream;
+        uint64_t output[4];
+    } answers[] = {
+        {1, 0, {
+            UINT64_C(0x711288810CEA6C97), UINT64_C(0xBDC9D0B90ADB0C09),
+            UINT64_C(0xC16DE1065FE14107), UINT64_C(0x66804BDB8C3E29EA),
+        }},
+        {12345, 678, {
+            UINT64_C(0x1C855E44C3B57393), UINT64_C(0xCD513B6FA5A738C4),
+            UINT64_C(0x6DBB75A45CD16CB0), UINT64_C(0x534EEE3BFF2B48B1),
+        }},
+    };
+    bool passed = true;
+    for (size_t answer = 0; answer < sizeof(answers)/sizeof(answers[0]); answer++) {
+        RNG rng;
+        rng_Seed(&rng, answers[answer].seed, answers[answer].stream);
+        for (int index = 0; index < 4; index++) {
+            uint64_t output = rng_Next(&rng);
+            if (output != answers[answer].output[index]) {
+                fprintf(stderr, "Seed %llu, stream %llu, output %d: got %016llX instead of %016llX.\n",
+                    (unsigned long long)answers[answer].seed, (unsigned long long)answers[answer].stream,
+                    index+1, (unsigned long long)output, (unsigned long long)answers[answer].output[index]);
+                passed = false;
+            }
+        }
+    }
+    printf("rng: %s\n", passed? "ok": "FAILED");
+    return passed;
+}
+
+/**********************************************************//**
+ * @brief Set up the board of a game.
+ * @param game: The index of the game.
+ * @param field: Output parameter for the board.
+ **************************************************************/
+static void crosscheck_Setup(uint64_t game, FIELD *field) {
+    RNG rng;
+    rng_Seed(&rng, Seed, game);
+    field_Clear(field);
+    field_CreateRandom(field, &rng);
+}
+
+/**********************************************************//**
+ * @brief Choose a tile with the given kernel.
+ * @param kernel: KERNEL_SCALAR or KERNEL_AVX2.
+ * @param field: The field to take a turn on.
+ * @param x: Output parameter for the x-coordinate.
+ * @param y: Output parameter for the y-coordinate.
+ * @return Whether there was any tile left to attack.
+ **************************************************************/
+static bool crosscheck_Choose(KERNEL kernel, const FIELD *field, int *x, int *y) {
+    ai_Configure(kernel);
+    *x = -1;
+    *y = -1;
+    return ai_ChooseTile(field, x, y);
+}
+
+/**********************************************************//**
+ * @brief Play the games on the configured field size and
+ * fleet, and check on every turn that placement_SortShips puts
+ * the hit ships first, then the others, each group by fewest
+ * consistent slots. First, a hit ship that has more slots than
+ * every other ship has to come first.
+ * @param turns: Output parameter, added to with the number of
+ * turns checked.
+ * @return Whether every turn's order was right.
+ **************************************************************/
+static bool crosscheck_Order(uint64_t *turns) {
+    FIELD field;
+    crosscheck_Setup(0, &field);
+    // The last ship that a single hit doesn't sink, so the ships
+    // before it are sorted first
+    SHIP last = field_GetShipCount()-1;
+    while (field_GetShipLength(last) == 1) {
+        last--;
+    }
+    const PLACEMENT *placement = field_GetPlacement(&field, last);
+    field_Attack(&field, placement->x, placement->y);
+    int most[N_SHIPS_MAX];
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        most[ship] = (ship == last)? SLOTS_MAX: 1;
+    }
+    SHIP first[N_SHIPS_MAX];
+    placement_SortShips(&field, most, first);
+    if (first[0] != last) {
+        fprintf(stderr, "The hit %s with %d slots doesn't come first.\n", field_GetShipName(last), SLOTS_MAX);
+        return false;
+    }
+
+    for (uint64_t game = 0; game < Games; game++) {
+        crosscheck_Setup(game, &field);
+        while (!field_IsWon(&field)) {
+            const SLOT *slot[SLOTS_MAX];
+            int count[N_SHIPS_MAX];
+            bool hit[N_SHIPS_MAX];
+            int afloat = 0;
+            for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+                int health = field_GetShipHealth(&field, ship);
+                if (health <= 0) {
+                    continue;
+                }
+                count[ship] = placement_GetConsistent(&field, ship, slot);
+                hit[ship] = (health < field_GetShipLength(ship));
+                afloat++;
+            }
+
+            SHIP order[N_SHIPS_MAX];
+            int ships = placement_SortShips(&field, count, order);
+            bool sorted = (ships == afloat);
+            for (int i = 1; sorted && i < ships; i++) {
+                SHIP a = order[i-1];
+                SHIP b = order[i];
+                sorted = (hit[a] > hit[b]) || (hit[a] == hit[b]
+                    && (count[a] < count[b] || (count[a] == count[b] && a < b)));
+            }
+            if (!sorted) {
+                fprintf(stderr, "Game %llu, turn %d: the ships are out of order:",
+                    (unsigned long long)game+1, field_GetTurnCount(&field)+1);
+                for (int i = 0; i < ships; i++) {
+                    fprintf(stderr, " %s (%s, %d slots)", field_GetShipName(order[i]),
+                        hit[order[i]]? "hit": "not hit", count[order[i]]);
+                }
+                fprintf(stderr, "\n");
+                return false;
+            }
+
+            int x, y;
+            if (!crosscheck_Choose(KERNEL_SCALAR, &field, &x, &y)) {
+                fprintf(stderr, "Game %llu, turn %d: no tile left to attack.\n",
+                    (unsigned long long)game+1, field_GetTurnCount(&field)+1);
+                return false;
+            }
+            field_Attack(&field, x, y);
+            (*turns)++;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Play the games on the configured field size and
+ * fleet with both kernels side by side.
+ * @param turns: Output parameter, added to with the number of
+ * turns checked.
+ * @return Whether the kernels agreed on every turn.
+ **************************************************************/
+static bool crosscheck_Kernels(uint64_t *turns) {
+    FIELD field;
+    for (uint64_t game = 0; game < Games; game++) {
+        crosscheck_Setup(game, &field);
+        while (!field_IsWon(&field)) {
+            int scalarX, scalarY;
+            int avx2X, avx2Y;
+            bool scalar = crosscheck_Choose(KERNEL_SCALAR, &field, &scalarX, &scalarY);
+            bool avx2 = crosscheck_Choose(KERNEL_AVX2, &field, &avx2X, &avx2Y);
+            if (scalar != avx2 || (scalar && (scalarX != avx2X || scalarY != avx2Y))) {
+                fprintf(stderr, "Game %llu, turn %d: the scalar code picks (%d, %d) but AVX2 picks (%d, %d).\n",
+                    (unsigned long long)game+1, field_GetTurnCount(&field)+1, scalarX, scalarY, avx2X, avx2Y);
+                field_Print(&field, stderr);
+                return false;
+            }
+            if (!scalar) {
+                fprintf(stderr, "Game %llu, turn %d: no tile left to attack.\n",
+                    (unsigned long long)game+1, field_GetTurnCount(&field)+1);
+                return false;
+            }
+            field_Attack(&field, scalarX, scalarY);
+            (*turns)++;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Check one lane of the batch against its game played
+ * on a FIELD, after a step.
+ * @param batch: The batch.
+ * @param lane: The lane.
+ * @param check: The game played on a FIELD.
+ * @param game: The index of the game.
+ * @return Whether the boards match.
+ **************************************************************/
+static bool crosscheck_Lane(const BATCH *batch, int lane, const FIELD *check, uint64_t game) {
+    bool same = (batch->turns[lane] == field_GetTurnCount(check));
+    for (int tile = 0; same && tile < field_GetTileCount(); tile++) {
+        same = (batch_GetStatus(batch, lane, tile)
+            == field_GetStatus(check, tile / field_GetSize(), tile % field_GetSize()));
+    }
+    for (SHIP ship = 0; same && ship < field_GetShipCount(); ship++) {
+        same = (batch->health[lane][ship] == field_GetShipHealth(check, ship)
+            && batch->sinkTurn[lane][ship] == field_GetSinkTurn(check, ship));
+    }
+    same = same && ((batch->remaining[lane] == 0) == field_IsWon(check));
+    if (!same) {
+        fprintf(stderr, "Game %llu, turn %d: the batch's board differs from the field:\n",
+            (unsigned long long)game+1, field_GetTurnCount(check));
+        field_Print(check, stderr);
+    }
+    return same;
+}
+
+/**********************************************************//**
+ * @brief Play the games on the configured field size and
+ * fleet in lockstep on a batch scored with the given kernel,
+ * and play each one on a FIELD with the scalar code too.
+ * @param kernel: KERNEL_SCALAR or KERNEL_AVX2.
+ * @param turns: Output parameter, added to with the number of
+ * turns checked.
+ * @return Whether the batch played every turn the same.
+ **************************************************************/
+static bool crosscheck_Batch(KERNEL kernel, uint64_t *turns) {
+    BATCH *batch = malloc(sizeof(BATCH));
+    if (!batch || !batch_Create(batch, Lanes)) {
+        fprintf(stderr, "Failed to allocate the batch.\n");
+        free(batch);
+        return false;
+    }
+    FIELD *check = calloc(batch->lanes, sizeof(FIELD));
+    uint64_t game[BATCH_LANES_MAX];
+    int move[BATCH_LANES_MAX];
+    uint64_t next = 0;
+    bool agreed = (check != NULL);
+    while (agreed) {
+        // Let the won games go, and refill their lanes
+        int playing = 0;
+        for (int lane = 0; lane < batch->lanes; lane++) {
+            if (batch->active[lane] && batch->remaining[lane] == 0) {
+                batch->active[lane] = false;
+            }
+            if (!batch->active[lane] && next < Games) {
+                crosscheck_Setup(next, &check[lane]);
+                batch_Load(batch, lane, &check[lane]);
+                game[lane] = next++;
+            }
+            playing += batch->active[lane];
+        }
+        if (!playing) {
+            break;
+        }
+        ai_Configure(kernel);
+        if (!batch_Step(batch, move)) {
+            fprintf(stderr, "The batch had no tile left to attack.\n");
+            agreed = false;
+            break;
+        }
+
+        // Play the same turn on each lane's field
+        for (int lane = 0; agreed && lane < batch->lanes; lane++) {
+            if (!batch->active[lane]) {
+                continue;
+            }
+            int x, y;
+            if (!crosscheck_Choose(KERNEL_SCALAR, &check[lane], &x, &y) || field_GetIndex(x, y) != move[lane]) {
+                fprintf(stderr, "Game %llu, turn %d: the heuristic picks (%d, %d) but the batch picks (%d, %d).\n",
+                    (unsigned long long)game[lane]+1, field_GetTurnCount(&check[lane])+1,
+                    x, y, move[lane] / field_GetSize(), move[lane] % field_GetSize());
+                field_Print(&check[lane], stderr);
+                agreed = false;
+                break;
+            }
+            field_Attack(&check[lane], x, y);
+            agreed = crosscheck_Lane(batch, lane, &check[lane], game[lane]);
+            (*turns)++;
+        }
+    }
+    free(check);
+    batch_Free(batch);
+    free(batch);
+    return agreed;
+}
+
+/**********************************************************//**
+ * @brief Run every check on the configured field size and
+ * fleet: the order of the ships, the kernels against each
+ * other, then the batch with each kernel against the scalar
+ * code.
+ * @param avx2: Whether the processor has AVX2.
+ * @return Whether every check passed.
+ **************************************************************/
+static bool crosscheck_Configuration(bool avx2) {
+    bool passed = true;
+    for (int check = 0; check < 4; check++) {
+        static const char *names[4] = {"order", "kernels", "batch scalar", "batch avx2"};
+        if ((check == 1 || check == 3) && !avx2) {
+            continue;
+        }
+        uint64_t turns = 0;
+        bool agreed = (check == 0)? crosscheck_Order(&turns):
+            (check == 1)? crosscheck_Kernels(&turns):
+            crosscheck_Batch((check == 2)? KERNEL_SCALAR: KERNEL_AVX2, &turns);
+        printf("%s %dx%d %s: %llu turns, %s\n", Fleet->name, FieldSize, FieldSize, names[check],
+            (unsigned long long)turns, agreed? "ok": "FAILED");
+        passed &= agreed;
+    }
+    return passed;
+}
+
+/**********************************************************//**
+ * @brief Differential test main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (!parse(argc, argv)) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+    bool avx2 = ai_Configure(KERNEL_AVX2);
+    if (!avx2) {
+        printf("This processor doesn't have AVX2; only the scalar batch is checked.\n");
+    }
+    if (FieldSize) {
+        return crosscheck_Configuration(avx2)? EXIT_SUCCESS: EXIT_FAILURE;
+    }
+
+    // Every field size with every fleet that fits on it
+    bool passed = crosscheck_Rng();
+    for (int fleetIndex = 0; field_GetFleet(fleetIndex); fleetIndex++) {
+        Fleet = field_GetFleet(fleetIndex);
+        for (FieldSize = FIELD_SIZE_MIN; FieldSize <= FIELD_SIZE_MAX; FieldSize++) {
+            if (field_Configure(FieldSize, Fleet)) {
+                passed &= crosscheck_Configuration(avx2);
+            }
+        }
+    }
+    return passed? EXIT_SUCCESS: EXIT_FAILURE;
+}
+
+/**************************************************************/
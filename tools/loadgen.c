@@ -0,0 +1,369 @@
+/**********************************************************//**
+ * @file loadgen.c
+ * @brief Load generator for the move server. Plays many games
+ * at once against a server on a Unix domain socket: it hides a
+ * random fleet for each game in a packed field, asks the
+ * server for every shot, and reports each result back, saying
+ * where each ship lay when it sinks. All the games' requests
+ * of a round go in one write, and their answers are read back
+ * in order.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "field.h"
+#include "packed.h"
+#include "rng.h"
+
+/**************************************************************/
+/// The longest request or answer line.
+#define LOADGEN_LINE 128
+
+/// The most games played at once.
+#define LOADGEN_GAMES_MAX 4096
+
+/// The path of the server's socket.
+static const char *SocketPath = NULL;
+
+/// The number of games to play.
+static int NumberOfGames = 1000;
+
+/// The number of games to play at once.
+static int NumberOfLive = 64;
+
+/// The seed of the hidden fleets.
+static uint64_t Seed = 1;
+
+/// Whether to stop the server at the end.
+static bool Shutdown = false;
+
+/**********************************************************//**
+ * @struct GAME
+ * @brief One game being played against the server.
+ **************************************************************/
+typedef struct {
+    /// The hidden fleet and the shots so far, packed.
+    PACKED *board;
+    /// The server's id of the game, or 0 if it isn't open.
+    unsigned long long id;
+    /// Whether the game asked to be opened in this round.
+    bool opening;
+    /// Whether the game has a shot to report.
+    bool reporting;
+    /// The tile of the shot to report.
+    int x, y;
+    /// The result of the shot to report.
+    STATUS result;
+    /// The ship that sank, for SUNK.
+    SHIP ship;
+} GAME;
+
+/**********************************************************//**
+ * @struct CONNECTION
+ * @brief The socket and the answers read but not yet used.
+ **************************************************************/
+typedef struct {
+    /// The socket.
+    int socket;
+    /// The bytes read but not yet used.
+    size_t length;
+    /// The bytes read.
+    char buffer[65536];
+} CONNECTION;
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("-h:        Print the help screen.\n");
+    printf("-u <name>: Connect to the server on this Unix domain socket.\n");
+    printf("-n <int>:  Play this number of games (default: 1000).\n");
+    printf("-g <int>:  Play this number of games at once, up to %d (default: 64).\n", LOADGEN_GAMES_MAX);
+    printf("-s <int>:  Seed the hidden fleets (default: 1).\n");
+    printf("-q:        Stop the server at the end.\n");
+    printf("-W <int>:  Play on a field of this size (default: %d).\n", FIELD_SIZE_DEFAULT);
+    printf("-F <name>: Play with this fleet (default: %s).\n", field_GetFleet(0)->name);
+}
+
+/**********************************************************//**
+ * @brief Reads information from the command-line arguments.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ * @return True if no invalid keywords were encountered.
+ **************************************************************/
+static inline bool parse(int argc, char *argv[]) {
+    int fieldSize = FIELD_SIZE_DEFAULT;
+    const FLEET *fleet = field_GetFleet(0);
+    int i = 1;
+    while (i < argc) {
+        const char *keyword = argv[i++];
+        if (!strcmp(keyword, "-u")) {
+            SocketPath = argv[i++];
+        } else if (!strcmp(keyword, "-n")) {
+            NumberOfGames = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-g")) {
+            NumberOfLive = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-s")) {
+            Seed = strtoull(argv[i++], NULL, 0);
+        } else if (!strcmp(keyword, "-q")) {
+            Shutdown = true;
+        } else if (!strcmp(keyword, "-W")) {
+            fieldSize = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-F")) {
+            fleet = field_FindFleet(argv[i++]);
+            if (!fleet) {
+                fprintf(stderr, "Unknown fleet \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if (!field_Configure(fieldSize, fleet)) {
+        fprintf(stderr, "The %s fleet can't play on a field of size %d.\n", fleet->name, fieldSize);
+        return false;
+    }
+    return SocketPath && NumberOfGames > 0 && NumberOfLive > 0 && NumberOfLive <= LOADGEN_GAMES_MAX;
+}
+
+/**********************************************************//**
+ * @brief Read the clock.
+ * @return The time in nanoseconds.
+ **************************************************************/
+static inline uint64_t loadgen_Now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec*1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**********************************************************//**
+ * @brief Write all of a buffer to the socket.
+ * @param connection: The connection.
+ * @param buffer: The bytes to write.
+ * @param length: The number of bytes.
+ * @return Whether they were all written.
+ **************************************************************/
+static bool loadgen_Send(CONNECTION *connection, const char *buffer, size_t length) {
+    while (length > 0) {
+        ssize_t n = send(connection->socket, buffer, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buffer += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Read the next answer line from the server.
+ * @param connection: The connection.
+ * @param line: Output parameter for the line, without its
+ * newline, with room for LOADGEN_LINE bytes.
+ * @return Whether a line was read.
+ **************************************************************/
+static bool loadgen_Receive(CONNECTION *connection, char *line) {
+    char *newline;
+    while (!(newline = memchr(connection->buffer, '\n', connection->length))) {
+        if (connection->length == sizeof(connection->buffer)) {
+            return false;
+        }
+        ssize_t n = read(connection->socket, connection->buffer + connection->length,
+            sizeof(connection->buffer) - connection->length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        connection->length += (size_t)n;
+    }
+    size_t size = (size_t)(newline - connection->buffer);
+    size_t copied = (size < LOADGEN_LINE)? size: LOADGEN_LINE-1;
+    memcpy(line, connection->buffer, copied);
+    line[copied] = '\0';
+    connection->length -= size+1;
+    memmove(connection->buffer, newline+1, connection->length);
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Compare two latencies for qsort.
+ * @param a: The first latency.
+ * @param b: The second latency.
+ * @return The sort order.
+ **************************************************************/
+static int loadgen_CompareLatency(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**********************************************************//**
+ * @brief Load generator main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (!parse(argc, argv)) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    strncpy(address.sun_path, SocketPath, sizeof(address.sun_path)-1);
+    static CONNECTION connection;
+    connection.socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection.socket < 0 || connect(connection.socket, (struct sockaddr *)&address, sizeof(address))) {
+        fprintf(stderr, "Failed to connect to \"%s\"\n", SocketPath);
+        return EXIT_FAILURE;
+    }
+
+    // Each round sends one batch: every live game reports its
+    // last shot and asks for the next, or opens or closes.
+    GAME *game = calloc(NumberOfLive, sizeof(GAME));
+    unsigned char *boards = malloc((size_t)NumberOfLive*packed_GetSize());
+    char *request = malloc((size_t)NumberOfLive*3*LOADGEN_LINE);
+    size_t capacity = 1024;
+    size_t rounds = 0;
+    uint64_t *latency = malloc(capacity*sizeof(uint64_t));
+    if (!game || !boards || !request || !latency) {
+        fprintf(stderr, "Out of memory.\n");
+        return EXIT_FAILURE;
+    }
+    for (int g = 0; g < NumberOfLive; g++) {
+        game[g].board = (PACKED *)(boards + g*packed_GetSize());
+    }
+    int opened = 0;
+    int started = 0;
+    int finished = 0;
+    uint64_t turns = 0;
+    uint64_t requests = 0;
+    uint64_t start = loadgen_Now();
+    bool success = true;
+    while (success && finished < NumberOfGames) {
+        size_t length = 0;
+        for (int g = 0; g < NumberOfLive; g++) {
+            GAME *live = &game[g];
+            if (live->id == 0) {
+                live->opening = (opened < NumberOfGames);
+                if (live->opening) {
+                    length += sprintf(request + length, "open\n");
+                    opened++;
+                }
+                continue;
+            }
+            if (live->reporting) {
+                length += sprintf(request + length, "report %llu %d %d %s", live->id, live->x, live->y,
+                    (live->result == MISS)? "miss": (live->result == HIT)? "hit": "sunk");
+                if (live->result == SUNK) {
+                    PLACEMENT placement;
+                    packed_GetPlacement(live->board, live->ship, &placement);
+                    length += sprintf(request + length, " %d %d %d %s", live->ship, placement.x, placement.y,
+                        (placement.view == DOWN)? "down": "right");
+                }
+                length += sprintf(request + length, "\n");
+            }
+            length += sprintf(request + length, packed_IsWon(live->board)? "close %llu\n": "move %llu\n", live->id);
+        }
+        uint64_t sent = loadgen_Now();
+        success = loadgen_Send(&connection, request, length);
+
+        // Read the answers back in the same order
+        char line[LOADGEN_LINE];
+        for (int g = 0; success && g < NumberOfLive; g++) {
+            GAME *live = &game[g];
+            if (live->id == 0) {
+                if (live->opening) {
+                    success = loadgen_Receive(&connection, line) && sscanf(line, "ok %llu", &live->id) == 1;
+                    RNG rng;
+                    FIELD field;
+                    rng_Seed(&rng, Seed, (uint64_t)started++);
+                    field_Clear(&field);
+                    field_CreateRandom(&field, &rng);
+                    packed_Store(live->board, &field);
+                    live->reporting = false;
+                    requests++;
+                }
+                continue;
+            }
+            if (live->reporting) {
+                success = loadgen_Receive(&connection, line) && !strcmp(line, "ok");
+                live->reporting = false;
+                requests++;
+            }
+            if (!success) {
+                break;
+            }
+            success = loadgen_Receive(&connection, line);
+            requests++;
+            if (success && packed_IsWon(live->board)) {
+                turns += packed_GetTurns(live->board);
+                finished++;
+                live->id = 0;
+            } else if (success) {
+                success = sscanf(line, "move %d %d", &live->x, &live->y) == 2;
+                live->result = success? packed_Attack(live->board, live->x, live->y): ERROR;
+                live->ship = (live->result == SUNK)? packed_GetShip(live->board, live->x, live->y): EMPTY;
+                live->reporting = true;
+                success = (live->result != ERROR);
+            }
+        }
+        if (!success) {
+            fprintf(stderr, "The server answered \"%s\"\n", line);
+            break;
+        }
+        if (rounds == capacity) {
+            capacity *= 2;
+            uint64_t *grown = realloc(latency, capacity*sizeof(uint64_t));
+            if (!grown) {
+                success = false;
+                break;
+            }
+            latency = grown;
+        }
+        latency[rounds++] = loadgen_Now() - sent;
+    }
+    double seconds = (loadgen_Now() - start) * 1e-9;
+
+    // Report the round trips, and the server's own latency
+    if (success) {
+        qsort(latency, rounds, sizeof(uint64_t), loadgen_CompareLatency);
+        printf("games %d live %d turns_mean %.2f\n", finished, NumberOfLive, (double)turns / finished);
+        printf("requests %llu seconds %.3f requests_per_sec %.0f games_per_sec %.1f\n",
+            (unsigned long long)requests, seconds, requests / seconds, finished / seconds);
+        printf("round_trip_us p50 %.1f p99 %.1f max %.1f\n", latency[rounds/2] * 1e-3,
+            latency[rounds*99/100] * 1e-3, latency[rounds-1] * 1e-3);
+        char line[LOADGEN_LINE];
+        const char *stats = Shutdown? "stats\nshutdown\n": "stats\n";
+        if (loadgen_Send(&connection, stats, strlen(stats)) && loadgen_Receive(&connection, line)) {
+            printf("server %s\n", line + strlen("stats "));
+        }
+    }
+    close(connection.socket);
+    free(game);
+    free(boards);
+    free(request);
+    free(latency);
+    return success? EXIT_SUCCESS: EXIT_FAILURE;
+}
+
+/**************************************************************/
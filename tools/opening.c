@@ -0,0 +1,123 @@
+/**********************************************************//**
+ * @file opening.c
+ * @brief Opening book tool. Works out the heuristic's moves
+ * before its first hit for a field size and fleet, and saves
+ * them as a book for the book AI, or prints a saved book.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "book.h"
+#include "field.h"
+
+/**************************************************************/
+/// The file to save the book to, or NULL.
+static const char *OutputFilename = NULL;
+
+/// The book to print instead of working one out, or NULL.
+static const char *InputFilename = NULL;
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("-h:        Print the help screen.\n");
+    printf("-o <name>: Save the book to this file (default: print it).\n");
+    printf("-b <name>: Print this saved book instead.\n");
+    printf("-W <int>:  Book for a field of this size (default: %d).\n", FIELD_SIZE_DEFAULT);
+    printf("-F <name>: Book for this fleet (default: %s).\n", field_GetFleet(0)->name);
+}
+
+/**********************************************************//**
+ * @brief Reads information from the command-line arguments.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ * @return True if no invalid keywords were encountered.
+ **************************************************************/
+static inline bool parse(int argc, char *argv[]) {
+    int fieldSize = FIELD_SIZE_DEFAULT;
+    const FLEET *fleet = field_GetFleet(0);
+    int i = 1;
+    while (i < argc) {
+        const char *keyword = argv[i++];
+        if (!strcmp(keyword, "-o")) {
+            OutputFilename = argv[i++];
+        } else if (!strcmp(keyword, "-b")) {
+            InputFilename = argv[i++];
+        } else if (!strcmp(keyword, "-W")) {
+            fieldSize = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-F")) {
+            fleet = field_FindFleet(argv[i++]);
+            if (!fleet) {
+                fprintf(stderr, "Unknown fleet \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if (!field_Configure(fieldSize, fleet)) {
+        fprintf(stderr, "The %s fleet can't play on a field of size %d.\n", fleet->name, fieldSize);
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Opening book tool main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (!parse(argc, argv)) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+
+    BOOK book;
+    if (InputFilename) {
+        FILE *file = fopen(InputFilename, "rb");
+        bool read = file && book_Read(&book, file);
+        if (file) {
+            fclose(file);
+        }
+        if (!read) {
+            fprintf(stderr, "Failed to read the book \"%s\"\n", InputFilename);
+            return EXIT_FAILURE;
+        }
+    } else {
+        book_Create(&book);
+    }
+
+    if (OutputFilename) {
+        FILE *file = fopen(OutputFilename, "wb");
+        bool written = file && book_Write(&book, file);
+        if (!file || fclose(file) || !written) {
+            fprintf(stderr, "Failed to write the book \"%s\"\n", OutputFilename);
+            return EXIT_FAILURE;
+        }
+        printf("Wrote %d moves for the %s fleet on a %dx%d field.\n",
+            book.moves, book.fleet, book.size, book.size);
+        return EXIT_SUCCESS;
+    }
+
+    printf("Field: %d\n", book.size);
+    printf("Fleet: %s\n", book.fleet);
+    printf("Moves: %d\n", book.moves);
+    for (int i = 0; i < book.moves; i++) {
+        printf("%d: %d %d\n", i+1, book.move[i] / book.size, book.move[i] % book.size);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**************************************************************/
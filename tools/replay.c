@@ -0,0 +1,157 @@
+/**********************************************************//**
+ * @file replay.c
+ * @brief Replay tool for binary game logs. Rebuilds the board
+ * of any game at any turn by replaying its moves, and prints
+ * it like the markdown game log.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "field.h"
+#include "gamelog.h"
+
+/**************************************************************/
+/// The binary game log to read.
+static const char *LogFilename = NULL;
+
+/// The game to show, starting at 1, or 0 to describe the log.
+static uint64_t Game = 0;
+
+/// The turn to show, or 0 for the last turn.
+static int Turn = 0;
+
+/// Whether to show every turn up to Turn.
+static bool AllTurns = false;
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("-h:        Print the help screen.\n");
+    printf("-l <name>: Read this binary game log.\n");
+    printf("-k <int>:  Show this game (default: describe the log).\n");
+    printf("-t <int>:  Show the board after this turn (default: the last).\n");
+    printf("-a:        Show every turn up to then.\n");
+}
+
+/**********************************************************//**
+ * @brief Reads information from the command-line arguments.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ * @return True if no invalid keywords were encountered.
+ **************************************************************/
+static inline bool parse(int argc, char *argv[]) {
+    int i = 1;
+    while (i < argc) {
+        const char *keyword = argv[i++];
+        if (!strcmp(keyword, "-l")) {
+            LogFilename = argv[i++];
+        } else if (!strcmp(keyword, "-k")) {
+            Game = strtoull(argv[i++], NULL, 10);
+        } else if (!strcmp(keyword, "-t")) {
+            Turn = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-a")) {
+            AllTurns = true;
+        } else {
+            return false;
+        }
+    }
+    return LogFilename != NULL;
+}
+
+/**********************************************************//**
+ * @brief Replay one game from the log and print it.
+ * @param log: The open game log.
+ * @return Whether the game could be replayed.
+ **************************************************************/
+static bool replay_Game(GAMELOG *log) {
+    PLACEMENT fleet[N_SHIPS_MAX];
+    unsigned char move[TURN_MAX];
+    int turns = gamelog_Read(log, Game-1, fleet, move);
+    if (turns < 0) {
+        fprintf(stderr, "Failed to read game %llu.\n", (unsigned long long)Game);
+        return false;
+    }
+    FIELD field;
+    field_Clear(&field);
+    if (!field_CreateFleet(&field, fleet)) {
+        fprintf(stderr, "Game %llu has an invalid fleet.\n", (unsigned long long)Game);
+        return false;
+    }
+    int last = (Turn > 0 && Turn < turns)? Turn: turns;
+
+    printf("# Game %llu\n", (unsigned long long)Game);
+    if (AllTurns || last == 0) {
+        printf("## Turn 0\n");
+        field_Print(&field, stdout);
+        printf("\n");
+    }
+    for (int turn = 0; turn < last; turn++) {
+        if (field_Attack(&field, move[turn]/field_GetSize(), move[turn]%field_GetSize()) == ERROR) {
+            fprintf(stderr, "Game %llu has an invalid move on turn %d.\n", (unsigned long long)Game, turn+1);
+            return false;
+        }
+        if (AllTurns || turn == last-1) {
+            printf("## Turn %d\n", field.turns);
+            field_Print(&field, stdout);
+            printf("\n");
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Replay tool main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (!parse(argc, argv)) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+    FILE *file = fopen(LogFilename, "rb");
+    if (!file) {
+        fprintf(stderr, "Failed to open \"%s\"\n", LogFilename);
+        return EXIT_FAILURE;
+    }
+    GAMELOG log;
+    if (!gamelog_Open(&log, file)) {
+        fprintf(stderr, "\"%s\" is not a complete game log.\n", LogFilename);
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    // Play by the rules the log was written with
+    const FLEET *fleet = field_FindFleet(log.fleet);
+    if (!fleet || !field_Configure(log.size, fleet)) {
+        fprintf(stderr, "\"%s\" was played with an unknown fleet.\n", LogFilename);
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    bool success = true;
+    if (Game == 0) {
+        printf("Games: %llu\n", (unsigned long long)log.games);
+        printf("Seed: %llu\n", (unsigned long long)log.seed);
+        printf("Field: %d\n", log.size);
+        printf("Fleet: %s\n", log.fleet);
+    } else {
+        success = replay_Game(&log);
+    }
+    fclose(file);
+    return success? EXIT_SUCCESS: EXIT_FAILURE;
+}
+
+/**************************************************************/
@@ -0,0 +1,417 @@
+/**********************************************************//**
+ * @file rescore.c
+ * @brief Rescoring tool for binary game logs. Replays every
+ * recorded game, asks two AIs for their move at each board
+ * state on the way, and reports how often they disagree, by
+ * turn and by phase of the game.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ * @detail The log is mapped into memory and the games are
+ * shared out to threads in chunks. Each board is rebuilt from
+ * the logged fleet and moves with field_Attack, so only the
+ * AIs' choices are computed, never whole games. A state is in
+ * the target phase while some hit ship is afloat, in the
+ * endgame once the afloat ships' consistent slots multiply out
+ * to few enough layouts, and in the hunt phase otherwise.
+ **************************************************************/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ai.h"
+#include "book.h"
+#include "endgame.h"
+#include "field.h"
+#include "gamelog.h"
+#include "placement.h"
+#include "rng.h"
+#include "strategy.h"
+
+/**************************************************************/
+/// The number of games a worker claims at a time.
+#define RESCORE_CHUNK 64
+
+/**********************************************************//**
+ * @enum PHASE
+ * @brief The phases of a game.
+ **************************************************************/
+typedef enum {
+    /// Searching for a ship with nothing hit.
+    PHASE_HUNT,
+    /// Finishing off a ship that was hit.
+    PHASE_TARGET,
+    /// Searching with few layouts of the fleet left.
+    PHASE_ENDGAME,
+} PHASE;
+
+/// The number of PHASE values.
+#define N_PHASES (PHASE_ENDGAME+1)
+
+/// The name of each phase.
+static const char *PhaseName[N_PHASES] = {"hunt", "target", "endgame"};
+
+/// The binary game log to read.
+static const char *LogFilename = NULL;
+
+/// The AI to compare against, which should be the one logged.
+static const STRATEGY *Baseline = NULL;
+
+/// The AI to compare.
+static const STRATEGY *Candidate = NULL;
+
+/// The number of threads, or 0 for one per core.
+static int NumberOfThreads = 0;
+
+/// The most games to rescore, or 0 for all of them.
+static uint64_t NumberOfGames = 0;
+
+/// The most layouts left in the endgame phase.
+static int EndgameLayouts = ENDGAME_LAYOUTS_MAX;
+
+/**********************************************************//**
+ * @struct TALLY
+ * @brief The states seen and the disagreements among them.
+ **************************************************************/
+typedef struct {
+    /// The states before each turn.
+    uint64_t states[TURN_MAX+1];
+    /// The states before each turn where the AIs disagree.
+    uint64_t differ[TURN_MAX+1];
+    /// The states in each phase.
+    uint64_t phaseStates[N_PHASES];
+    /// The states in each phase where the AIs disagree.
+    uint64_t phaseDiffer[N_PHASES];
+    /// The states where the baseline repeats the logged move.
+    uint64_t logged;
+} TALLY;
+
+/**********************************************************//**
+ * @struct RESCORE
+ * @brief The games shared by the worker threads.
+ **************************************************************/
+typedef struct {
+    /// The mapped log.
+    const GAMELOG_MAP *map;
+    /// The number of games to rescore.
+    uint64_t games;
+    /// The next game to claim (accessed atomically).
+    uint64_t next;
+    /// Set if any game failed (accessed atomically).
+    bool failed;
+} RESCORE;
+
+/**********************************************************//**
+ * @struct WORKER
+ * @brief One worker thread and what it counted.
+ **************************************************************/
+typedef struct {
+    /// The games to work on.
+    RESCORE *rescore;
+    /// The states the worker saw.
+    TALLY tally;
+} WORKER;
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("-h:        Print the help screen.\n");
+    printf("-l <name>: Read this binary game log.\n");
+    printf("-a <name>: Compare against this AI, which played the log (default: %s).\n", strategy_Get(0)->name);
+    printf("-b <name>: Compare this AI.\n");
+    printf("-j <int>:  Rescore on this number of threads (default: one per core).\n");
+    printf("-n <int>:  Rescore this number of games at most (default: all).\n");
+    printf("-e <int>:  Endgame phase: layouts left at most (default: %d).\n", ENDGAME_LAYOUTS_MAX);
+}
+
+/**********************************************************//**
+ * @brief Reads information from the command-line arguments.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ * @return True if no invalid keywords were encountered.
+ **************************************************************/
+static inline bool parse(int argc, char *argv[]) {
+    Baseline = strategy_Get(0);
+    int i = 1;
+    while (i < argc) {
+        const char *keyword = argv[i++];
+        if (!strcmp(keyword, "-l")) {
+            LogFilename = argv[i++];
+        } else if (!strcmp(keyword, "-a")) {
+            Baseline = strategy_Find(argv[i++]);
+            if (!Baseline) {
+                fprintf(stderr, "Unknown AI \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else if (!strcmp(keyword, "-b")) {
+            Candidate = strategy_Find(argv[i++]);
+            if (!Candidate) {
+                fprintf(stderr, "Unknown AI \"%s\"\n", argv[i-1]);
+                return false;
+            }
+        } else if (!strcmp(keyword, "-j")) {
+            NumberOfThreads = atoi(argv[i++]);
+        } else if (!strcmp(keyword, "-n")) {
+            NumberOfGames = strtoull(argv[i++], NULL, 10);
+        } else if (!strcmp(keyword, "-e")) {
+            EndgameLayouts = atoi(argv[i++]);
+        } else {
+            return false;
+        }
+    }
+    return LogFilename && Candidate && NumberOfThreads >= 0;
+}
+
+/**********************************************************//**
+ * @brief Get the phase of the game on a field.
+ * @param field: The field.
+ * @return The phase.
+ **************************************************************/
+static PHASE rescore_GetPhase(const FIELD *field) {
+    if (!mask_IsEmpty(field_GetMask(field, HIT))) {
+        return PHASE_TARGET;
+    }
+    const SLOT *slot[SLOTS_MAX];
+    uint64_t layouts = 1;
+    for (SHIP ship = 0; ship < field_GetShipCount(); ship++) {
+        if (field->health[ship] > 0) {
+            layouts *= (uint64_t)placement_GetConsistent(field, ship, slot);
+            if (layouts > (uint64_t)EndgameLayouts) {
+                return PHASE_HUNT;
+            }
+        }
+    }
+    return PHASE_ENDGAME;
+}
+
+/**********************************************************//**
+ * @brief Get the seed the run gave the AIs in a game: the
+ * draw after the game's fleet, as the simulator makes it.
+ * @param seed: The seed of the run.
+ * @param game: The index of the game.
+ * @return The seed of the AIs' state.
+ **************************************************************/
+static uint64_t rescore_GetSeed(uint64_t seed, uint64_t game) {
+    RNG rng;
+    FIELD field;
+    rng_Seed(&rng, seed, game);
+    field_Clear(&field);
+    field_CreateRandom(&field, &rng);
+    return rng_Next(&rng);
+}
+
+/**********************************************************//**
+ * @brief Rescore one game.
+ * @param map: The mapped log.
+ * @param game: The index of the game.
+ * @param state: Space for each AI's state.
+ * @param tally: The states seen, to add the game's to.
+ * @return Whether the game could be rebuilt and both AIs moved.
+ **************************************************************/
+static bool rescore_Game(const GAMELOG_MAP *map, uint64_t game, void *state[2], TALLY *tally) {
+    PLACEMENT fleet[N_SHIPS_MAX];
+    const unsigned char *move;
+    int turns = gamelog_GetGame(map, game, fleet, &move);
+    FIELD field;
+    field_Clear(&field);
+    if (turns < 0 || !field_CreateFleet(&field, fleet)) {
+        return false;
+    }
+    const STRATEGY *strategy[2] = {Baseline, Candidate};
+    uint64_t seed = rescore_GetSeed(map->seed, game);
+    for (int i = 0; i < 2; i++) {
+        if (strategy[i]->init) {
+            strategy[i]->init(state[i], &field, seed);
+        }
+    }
+
+    // Ask both AIs at each state, then play the logged move
+    bool success = true;
+    for (int turn = 0; success && turn < turns; turn++) {
+        PHASE phase = rescore_GetPhase(&field);
+        int x[2], y[2];
+        success = strategy[0]->choose(state[0], &field, &x[0], &y[0])
+            && strategy[1]->choose(state[1], &field, &x[1], &y[1]);
+        bool differ = (x[0] != x[1] || y[0] != y[1]);
+        tally->states[turn+1]++;
+        tally->differ[turn+1] += differ;
+        tally->phaseStates[phase]++;
+        tally->phaseDiffer[phase] += differ;
+        tally->logged += (field_GetIndex(x[0], y[0]) == move[turn]);
+        success = success && field_Attack(&field, move[turn]/field_GetSize(), move[turn]%field_GetSize()) != ERROR;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (strategy[i]->reset) {
+            strategy[i]->reset(state[i]);
+        }
+    }
+    return success && field_IsWon(&field);
+}
+
+/**********************************************************//**
+ * @brief Worker thread: rescore games until none are left to
+ * claim.
+ * @param arg: The WORKER.
+ * @return NULL.
+ **************************************************************/
+static void *rescore_Worker(void *arg) {
+    WORKER *worker = arg;
+    RESCORE *rescore = worker->rescore;
+    void *state[2] = {
+        calloc(1, Baseline->stateSize + 1),
+        calloc(1, Candidate->stateSize + 1),
+    };
+    if (!state[0] || !state[1]) {
+        __atomic_store_n(&rescore->failed, true, __ATOMIC_RELAXED);
+    }
+    while (!__atomic_load_n(&rescore->failed, __ATOMIC_RELAXED)) {
+        uint64_t start = __atomic_fetch_add(&rescore->next, RESCORE_CHUNK, __ATOMIC_RELAXED);
+        uint64_t end = (start+RESCORE_CHUNK < rescore->games)? start+RESCORE_CHUNK: rescore->games;
+        if (start >= rescore->games) {
+            break;
+        }
+        for (uint64_t game = start; game < end; game++) {
+            if (!rescore_Game(rescore->map, game, state, &worker->tally)) {
+                fprintf(stderr, "Failed to rescore game %llu.\n", (unsigned long long)game+1);
+                __atomic_store_n(&rescore->failed, true, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+    }
+    free(state[0]);
+    free(state[1]);
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Print one row of the disagreement table.
+ * @param label: The label of the row.
+ * @param states: The states in the row.
+ * @param differ: The states where the AIs disagree.
+ **************************************************************/
+static void rescore_PrintRow(const char *label, uint64_t states, uint64_t differ) {
+    printf("%-8s %10llu %10llu %7.2f%%\n", label, (unsigned long long)states,
+        (unsigned long long)differ, states? 100.0*differ/states: 0.0);
+}
+
+/**********************************************************//**
+ * @brief Rescoring main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (!parse(argc, argv)) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+    GAMELOG_MAP map;
+    if (!gamelog_Map(&map, LogFilename)) {
+        fprintf(stderr, "\"%s\" is not a complete game log.\n", LogFilename);
+        return EXIT_FAILURE;
+    }
+
+    // Play by the rules the log was written with
+    const FLEET *fleet = field_FindFleet(map.fleet);
+    if (!fleet || !field_Configure(map.fieldSize, fleet) || !ai_Configure(KERNEL_AUTO)) {
+        fprintf(stderr, "\"%s\" was played with an unknown fleet.\n", LogFilename);
+        gamelog_Unmap(&map);
+        return EXIT_FAILURE;
+    }
+    static BOOK book;
+    book_Create(&book);
+    book_Configure(&book);
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = (NumberOfThreads > 0)? NumberOfThreads: (cores > 0)? (int)cores: 1;
+    RESCORE rescore = {
+        .map = &map,
+        .games = (NumberOfGames > 0 && NumberOfGames < map.games)? NumberOfGames: map.games,
+        .next = 0,
+        .failed = false,
+    };
+    WORKER *worker = calloc(threads, sizeof(WORKER));
+    pthread_t *thread = malloc(threads*sizeof(pthread_t));
+    if (!worker || !thread) {
+        fprintf(stderr, "Out of memory.\n");
+        gamelog_Unmap(&map);
+        return EXIT_FAILURE;
+    }
+
+    // The calling thread works too
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    for (int i = 0; i < threads; i++) {
+        worker[i].rescore = &rescore;
+    }
+    while (started < threads-1 && !pthread_create(&thread[started], NULL, rescore_Worker, &worker[started+1])) {
+        started++;
+    }
+    rescore_Worker(&worker[0]);
+    for (int i = 0; i < started; i++) {
+        pthread_join(thread[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    gamelog_Unmap(&map);
+    if (rescore.failed) {
+        free(worker);
+        free(thread);
+        return EXIT_FAILURE;
+    }
+
+    // Add up the workers' tallies
+    TALLY total = {0};
+    for (int i = 0; i < threads; i++) {
+        for (int turn = 0; turn <= TURN_MAX; turn++) {
+            total.states[turn] += worker[i].tally.states[turn];
+            total.differ[turn] += worker[i].tally.differ[turn];
+        }
+        for (PHASE phase = 0; phase < N_PHASES; phase++) {
+            total.phaseStates[phase] += worker[i].tally.phaseStates[phase];
+            total.phaseDiffer[phase] += worker[i].tally.phaseDiffer[phase];
+        }
+        total.logged += worker[i].tally.logged;
+    }
+    uint64_t states = 0;
+    uint64_t differ = 0;
+    for (PHASE phase = 0; phase < N_PHASES; phase++) {
+        states += total.phaseStates[phase];
+        differ += total.phaseDiffer[phase];
+    }
+
+    // Report the disagreement overall, by phase and by turn
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("Rescored %llu games, %llu states, %s against %s, on %d threads in %.2f s (%.0f states per second).\n",
+        (unsigned long long)rescore.games, (unsigned long long)states, Candidate->name, Baseline->name, threads, seconds, states / seconds);
+    printf("The %s AI repeats the logged move in %.2f%% of states.\n", Baseline->name,
+        states? 100.0*total.logged/states: 0.0);
+    printf("\n%-8s %10s %10s %8s\n", "Phase", "States", "Differ", "Rate");
+    for (PHASE phase = 0; phase < N_PHASES; phase++) {
+        rescore_PrintRow(PhaseName[phase], total.phaseStates[phase], total.phaseDiffer[phase]);
+    }
+    rescore_PrintRow("all", states, differ);
+    printf("\n%-8s %10s %10s %8s\n", "Turn", "States", "Differ", "Rate");
+    for (int turn = 1; turn <= TURN_MAX; turn++) {
+        if (total.states[turn]) {
+            char label[16];
+            snprintf(label, sizeof(label), "%d", turn);
+            rescore_PrintRow(label, total.states[turn], total.differ[turn]);
+        }
+    }
+    free(worker);
+    free(thread);
+    return EXIT_SUCCESS;
+}
+
+/**************************************************************/
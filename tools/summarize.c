@@ -0,0 +1,100 @@
+/**********************************************************//**
+ * @file summarize.c
+ * @brief Merges the summary reports of several runs into one.
+ * @author Rena Shinomiya
+ * @date October 16, 2026
+ **************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "field.h"
+#include "summary.h"
+
+/**********************************************************//**
+ * @brief Print the help information to the terminal.
+ * @param argc: Number of command-line arguments in argv.
+ * @param argv: Command-line arguments from the terminal.
+ **************************************************************/
+static inline void help(int argc, char **argv) {
+    (void)argc;
+    printf("%s usage:\n", argv[0]);
+    printf("%s <report>...: Print the merged summary of the reports.\n", argv[0]);
+}
+
+/**********************************************************//**
+ * @brief Play by the rules a report was written with, so its
+ * ships can be found by name. Every other report must have
+ * been written with the same rules.
+ * @param filename: The report.
+ * @return Whether the rules were found and are supported.
+ **************************************************************/
+static bool summarize_Configure(const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Failed to open \"%s\"\n", filename);
+        return false;
+    }
+    char line[64];
+    char name[32];
+    int size = FIELD_SIZE_DEFAULT;
+    const FLEET *fleet = field_GetFleet(0);
+    while (fgets(line, sizeof(line), file) && strncmp(line, "games ", 6)) {
+        if (sscanf(line, "fleet %31s", name) == 1) {
+            fleet = field_FindFleet(name);
+        } else {
+            sscanf(line, "field %d", &size);
+        }
+    }
+    fclose(file);
+    if (!fleet) {
+        fprintf(stderr, "\"%s\" was played with the unknown fleet %s.\n", filename, name);
+        return false;
+    }
+    if (!field_Configure(size, fleet)) {
+        fprintf(stderr, "\"%s\" was played with the %s fleet on a %dx%d field, which isn't supported.\n",
+            filename, fleet->name, size, size);
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Summary merge tool main driver function.
+ * @param argc: The number of command-line arguments.
+ * @param argv: Pointers to the arguments.
+ * @return Exit code.
+ **************************************************************/
+int main(int argc, char *argv[]) {
+    if (argc < 2 || !strcmp(argv[1], "-h")) {
+        help(argc, argv);
+        return EXIT_FAILURE;
+    }
+
+    if (!summarize_Configure(argv[1])) {
+        return EXIT_FAILURE;
+    }
+    SUMMARY total;
+    summary_Clear(&total);
+    for (int i = 1; i < argc; i++) {
+        FILE *file = fopen(argv[i], "r");
+        if (!file) {
+            fprintf(stderr, "Failed to open \"%s\"\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+        SUMMARY summary;
+        bool success = summary_Read(&summary, file);
+        fclose(file);
+        if (!success) {
+            fprintf(stderr, "\"%s\" is not a valid summary report for the rules of \"%s\".\n", argv[i], argv[1]);
+            return EXIT_FAILURE;
+        }
+        summary_Merge(&total, &summary);
+    }
+    summary_Write(&total, stdout);
+    return EXIT_SUCCESS;
+}
+
+/**************************************************************/